@@ -121,6 +121,8 @@ typedef enum {
   QEXEC_S_HAS_LOAD = 0x01,
   /* Received EOF from iterator */
   QEXEC_S_ITERDONE = 0x02,
+  /* Replied with an error or with partial results */
+  QEXEC_S_PARTIAL = 0x04,
 } QEStateFlags;
 
 typedef struct AREQ {
@@ -24,6 +24,7 @@
 #include "aggregate_debug.h"
 #include "info/info_redis/block_client.h"
 #include "info/info_redis/threads/current_thread.h"
+#include "query_cache.h"
 
 typedef enum { COMMAND_AGGREGATE, COMMAND_SEARCH, COMMAND_EXPLAIN } CommandType;
 
@@ -414,7 +415,7 @@ static bool hasTimeoutError(QueryError *err) {
   return QueryError_GetCode(err) == QUERY_ETIMEDOUT;
 }
 
-void finishSendChunk(AREQ *req, SearchResult **results, SearchResult *r, bool cursor_done) {
+void finishSendChunk(AREQ *req, SearchResult **results, SearchResult *r, int rc, bool cursor_done) {
   if (results) {
     destroyResults(results);
   } else {
@@ -429,6 +430,10 @@ void finishSendChunk(AREQ *req, SearchResult **results, SearchResult *r, bool cu
     TotalGlobalStats_CountQuery(req->reqflags, clock() - req->initClock);
   }
 
+  if ((rc != RS_RESULT_OK && rc != RS_RESULT_EOF) || QueryError_HasError(req->qiter.err)) {
+    req->stateflags |= QEXEC_S_PARTIAL;
+  }
+
   // Reset the total results length:
   req->qiter.totalResults = 0;
 
@@ -545,7 +550,7 @@ done_2:
     }
 
 done_2_err:
-    finishSendChunk(req, results, &r, cursor_done);
+    finishSendChunk(req, results, &r, rc, cursor_done);
 
     if (resultsLen != REDISMODULE_POSTPONED_ARRAY_LEN && rc == RS_RESULT_OK && resultsLen != nelem) {
       RS_LOG_ASSERT_FMT(false, "Failed to predict the number of replied results. Prediction=%ld, actual_number=%ld.", resultsLen, nelem);
@@ -681,7 +686,7 @@ done_3:
     }
 
 done_3_err:
-    finishSendChunk(req, results, &r, cursor_done);
+    finishSendChunk(req, results, &r, rc, cursor_done);
 }
 
 /**
@@ -714,9 +719,120 @@ void sendChunk(AREQ *req, RedisModule_Reply *reply, size_t limit) {
   }
 }
 
+// Whether the reply depends only on indexed data. Writes to fields outside of the schema do not
+// change the index revision, so replies loading such fields must not be cached
+static bool replyFromSchemaOnly(AREQ *req) {
+  if (req->reqflags & QEXEC_AGG_LOAD_ALL) {
+    return false;
+  }
+  if (IsSearch(req) && !(req->reqflags & QEXEC_F_SEND_NOFIELDS) && !req->outFields.explicitReturn) {
+    // FT.SEARCH returns all the document fields by default
+    return false;
+  }
+  DLLIST_FOREACH(nn, &req->ap.steps) {
+    PLN_BaseStep *stp = DLLIST_ITEM(nn, PLN_BaseStep, llnodePln);
+    RLookup *lk = stp->getLookup ? stp->getLookup(stp) : NULL;
+    if (!lk) {
+      continue;
+    }
+    for (const RLookupKey *kk = lk->head; kk; kk = kk->next) {
+      if ((kk->flags & RLOOKUP_F_DOCSRC) && !(kk->flags & RLOOKUP_F_SCHEMASRC)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static inline void appendCacheKey(arrayof(char) *key, const void *data, size_t len) {
+  size_t pos = array_len(*key);
+  *key = array_grow(*key, len);
+  memcpy(*key + pos, data, len);
+}
+
+// Returns the query cache key of the request, or NULL if its reply may not be cached.
+// The key holds everything the reply depends on, other than the index content. It is known before
+// the execution plan is built, so a cached reply is found without building it
+static arrayof(char) queryCacheKey(AREQ *req) {
+  const IndexSpec *spec = req->sctx->spec;
+  if (!RSGlobalConfig.queryCacheMaxMemory || !spec || !spec->queryCache || spec->docs.ttl ||
+      (req->reqflags & (QEXEC_F_IS_CURSOR | QEXEC_F_PROFILE | QEXEC_F_DEBUG))) {
+    return NULL;
+  }
+
+  // The background flag only depends on the server configuration
+  uint32_t reqflags = req->reqflags & ~QEXEC_F_RUN_IN_BACKGROUND;
+  arrayof(char) key = array_new(char, 128);
+  appendCacheKey(&key, &RSGlobalConfig.generation, sizeof(RSGlobalConfig.generation));
+  appendCacheKey(&key, &req->protocol, sizeof(req->protocol));
+  appendCacheKey(&key, &reqflags, sizeof(reqflags));
+  appendCacheKey(&key, &req->reqConfig.dialectVersion, sizeof(req->reqConfig.dialectVersion));
+  appendCacheKey(&key, &req->maxSearchResults, sizeof(req->maxSearchResults));
+  appendCacheKey(&key, &req->maxAggregateResults, sizeof(req->maxAggregateResults));
+  for (size_t ii = 0; ii < req->nargs; ++ii) {
+    size_t len = sdslen(req->args[ii]);
+    appendCacheKey(&key, &len, sizeof(len));
+    appendCacheKey(&key, req->args[ii], len);
+  }
+  return key;
+}
+
+// Reply to the request from the query cache, and free it. Called with the spec locked, before the
+// execution plan is built. Returns false if there is no cached reply for the request
+static bool AREQ_ReplyFromCache(AREQ *req, RedisModuleCtx *ctx) {
+  if (req->reqflags & QEXEC_F_IS_CURSOR) {
+    return false;
+  }
+  arrayof(char) cacheKey = queryCacheKey(req);
+  if (!cacheKey) {
+    return false;
+  }
+  IndexSpec *spec = req->sctx->spec;
+  size_t len;
+  char *cached = QueryCache_Get(spec->queryCache, cacheKey, array_len(cacheKey), spec->revision, &len);
+  array_free(cacheKey);
+  if (!cached) {
+    return false;
+  }
+  RedisModule_Reply _reply = RedisModule_NewReply(ctx), *reply = &_reply;
+  RedisModule_Reply_Replay(ctx, cached, len);
+  rm_free(cached);
+  RedisModule_EndReply(reply);
+  TotalGlobalStats_CountQuery(req->reqflags, clock() - req->initClock);
+  TotalGlobalStats_CountQueryCacheHit(req->reqflags);
+  AREQ_Free(req);
+  return true;
+}
+
 void AREQ_Execute(AREQ *req, RedisModuleCtx *ctx) {
   RedisModule_Reply _reply = RedisModule_NewReply(ctx), *reply = &_reply;
+
+  // The spec is still locked here, so the revision matches the data the query will read. Only
+  // replies that don't load fields from outside of the schema are cached, which is known once the
+  // pipeline is built
+  IndexSpec *spec = req->sctx->spec;
+  arrayof(char) cacheKey = queryCacheKey(req);
+  if (cacheKey && !replyFromSchemaOnly(req)) {
+    array_free(cacheKey);
+    cacheKey = NULL;
+  }
+  uint64_t revision = cacheKey ? spec->revision : 0;
+  if (cacheKey) {
+    RedisModule_Reply_StartCapture(reply);
+  }
+
   sendChunk(req, reply, UINT64_MAX);
+
+  if (cacheKey) {
+    arrayof(char) capture = RedisModule_Reply_TakeCapture(reply);
+    if (req->stateflags & QEXEC_S_PARTIAL) {
+      array_free(capture);
+    } else {
+      QueryCache_Put(spec->queryCache, cacheKey, array_len(cacheKey), revision, capture,
+                     RSGlobalConfig.queryCacheMaxMemory);
+    }
+    array_free(cacheKey);
+  }
   RedisModule_EndReply(reply);
   AREQ_Free(req);
 }
@@ -772,6 +888,10 @@ void AREQ_Execute_Callback(blockedClientReqCtx *BCRctx) {
 
   // lock spec
   RedisSearchCtx_LockSpecRead(req->sctx);
+  if (AREQ_ReplyFromCache(req, outctx)) {
+    blockedClientReqCtx_setRequest(BCRctx, NULL);
+    goto cleanup;
+  }
   if (prepareExecutionPlan(req, &status) != REDISMODULE_OK) {
     goto error;
   }
@@ -982,6 +1102,10 @@ static int buildPipelineAndExecute(AREQ *r, RedisModuleCtx *ctx, QueryError *sta
     // This is released in AREQ_Free or while executing the query.
     RedisSearchCtx_LockSpecRead(r->sctx);
 
+    if (AREQ_ReplyFromCache(r, ctx)) {
+      CurrentThread_ClearIndexSpec();
+      return REDISMODULE_OK;
+    }
     if (prepareExecutionPlan(r, status) != REDISMODULE_OK) {
       CurrentThread_ClearIndexSpec();
       return REDISMODULE_ERR;
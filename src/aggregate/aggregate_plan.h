@@ -123,6 +123,7 @@ typedef struct {
     const char *name;  // Name of function
     char *alias;       // Output key
     bool isHidden;     // If the output key is hidden. Used by the coordinator
+    bool isInternal;   // Added by the coordinator, so it may be an internal reducer
     ArgsCursor args;
   } * reducers;
   int idx;
@@ -11,19 +11,24 @@
 typedef struct {
   const char *name;
   ReducerFactory fn;
+  bool internal;
 } FuncEntry;
 
 static FuncEntry *globalRegistry = NULL;
 
-void RDCR_RegisterFactory(const char *name, ReducerFactory factory) {
-  FuncEntry ent = {.name = name, .fn = factory};
+static void registerFactory(const char *name, ReducerFactory factory, bool internal) {
+  FuncEntry ent = {.name = name, .fn = factory, .internal = internal};
   FuncEntry *tail = array_ensure_tail(&globalRegistry, FuncEntry);
   *tail = ent;
 }
 
+void RDCR_RegisterFactory(const char *name, ReducerFactory factory) {
+  registerFactory(name, factory, false);
+}
+
 static int isBuiltinsRegistered = 0;
 
-ReducerFactory RDCR_GetFactory(const char *name) {
+ReducerFactory RDCR_GetFactory(const char *name, bool allowInternal) {
   if (!isBuiltinsRegistered) {
     isBuiltinsRegistered = 1;
     RDCR_RegisterBuiltins();
@@ -31,7 +36,7 @@ ReducerFactory RDCR_GetFactory(const char *name) {
   size_t n = array_len(globalRegistry);
   for (size_t ii = 0; ii < n; ++ii) {
     if (!strcasecmp(globalRegistry[ii].name, name)) {
-      return globalRegistry[ii].fn;
+      return globalRegistry[ii].internal && !allowInternal ? NULL : globalRegistry[ii].fn;
     }
   }
   return NULL;
@@ -53,10 +58,22 @@ ReducerFactory RDCR_GetFactory(const char *name) {
   X(RDCRHLL_New, "HLL")                            \
   X(RDCRHLLSum_New, "HLL_SUM")
 
+// Partial states the shards send and the coordinator merges. Not available to user REDUCE
+#define RDCR_XINTERNAL(X)                                   \
+  X(RDCRStdDevPartial_New, "STDDEV_PARTIAL")                \
+  X(RDCRStdDevMerge_New, "STDDEV_MERGE")                    \
+  X(RDCRCountDistinctPartial_New, "COUNT_DISTINCT_PARTIAL") \
+  X(RDCRCountDistinctMerge_New, "COUNT_DISTINCT_MERGE")     \
+  X(RDCRQuantilePartial_New, "QUANTILE_PARTIAL")            \
+  X(RDCRQuantileMerge_New, "QUANTILE_MERGE")
+
 void RDCR_RegisterBuiltins(void) {
-#define X(fn, n) RDCR_RegisterFactory(n, fn);
+#define X(fn, n) registerFactory(n, fn, false);
   RDCR_XBUILTIN(X);
 #undef X
+#define X(fn, n) registerFactory(n, fn, true);
+  RDCR_XINTERNAL(X);
+#undef X
 }
 
 int ReducerOpts_GetKey(const ReducerOptions *options, const RLookupKey **out) {
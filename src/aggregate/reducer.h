@@ -31,6 +31,12 @@ typedef enum {
   REDUCER_T_HLL,
   REDUCER_T_HLLSUM,
   REDUCER_T_SAMPLE,
+  REDUCER_T_STDDEV_PARTIAL,
+  REDUCER_T_STDDEV_MERGE,
+  REDUCER_T_DISTINCT_PARTIAL,
+  REDUCER_T_DISTINCTMERGE,
+  REDUCER_T_QUANTILE_PARTIAL,
+  REDUCER_T_QUANTILE_MERGE,
 
   /** Not a reducer, but a marker of the end of the list */
   REDUCER_T__END
@@ -166,9 +172,20 @@ Reducer *RDCRFirstValue_New(const ReducerOptions *);
 Reducer *RDCRRandomSample_New(const ReducerOptions *);
 Reducer *RDCRHLL_New(const ReducerOptions *);
 Reducer *RDCRHLLSum_New(const ReducerOptions *);
+Reducer *RDCRStdDevPartial_New(const ReducerOptions *);
+Reducer *RDCRStdDevMerge_New(const ReducerOptions *);
+Reducer *RDCRCountDistinctPartial_New(const ReducerOptions *);
+Reducer *RDCRCountDistinctMerge_New(const ReducerOptions *);
+Reducer *RDCRQuantilePartial_New(const ReducerOptions *);
+Reducer *RDCRQuantileMerge_New(const ReducerOptions *);
 
 typedef Reducer *(*ReducerFactory)(const ReducerOptions *);
-ReducerFactory RDCR_GetFactory(const char *name);
+/**
+ * Internal reducers are only used by the coordinator to distribute a public one. They are found
+ * only if `allowInternal` is set, that is for the plans the coordinator builds and for the
+ * commands it sends to the shards
+ */
+ReducerFactory RDCR_GetFactory(const char *name, bool allowInternal);
 void RDCR_RegisterFactory(const char *name, ReducerFactory factory);
 void RDCR_RegisterBuiltins(void);
 
@@ -14,6 +14,8 @@
 
 #define HLL_PRECISION_BITS 8
 #define INSTANCE_BLOCK_NUM 1024
+// Distinct values a shard sends to the coordinator for COUNT_DISTINCT, before falling back to an HLL
+#define DISTINCT_PARTIAL_MAX_HASHES 10000
 
 static const int khid = 35;
 KHASH_SET_INIT_INT64(khid);
@@ -77,6 +79,173 @@ Reducer *RDCRCountDistinct_New(const ReducerOptions *options) {
   return r;
 }
 
+/* Fold a 64 bit value hash into the 32 bits an HLL register takes */
+static inline uint32_t distinctHash32(uint64_t hval) {
+  return (uint32_t)hval ^ (uint32_t)(hval >> 32);
+}
+
+/** Serialized COUNT_DISTINCT_PARTIAL state. Followed by the 64 bit value hashes, or by the HLL
+ * registers once the shard saw more than DISTINCT_PARTIAL_MAX_HASHES distinct values */
+typedef struct __attribute__((packed)) {
+  uint8_t isHll;
+  uint8_t bits;  // HLL only
+} DistinctSerializedHeader;
+
+/* Add all the hashes of the dedup set to an HLL, so the count falls back to an estimate */
+static void distinctHashesToHll(khash_t(khid) * dedup, struct HLL *hll) {
+  hll_init(hll, HLL_PRECISION_BITS);
+  for (khiter_t k = kh_begin(dedup); k != kh_end(dedup); ++k) {
+    if (kh_exist(dedup, k)) {
+      hll_add_hash(hll, distinctHash32(kh_key(dedup, k)));
+    }
+  }
+}
+
+typedef struct {
+  khash_t(khid) * dedup;
+  // Initialized once the dedup set is given up for an estimate
+  struct HLL hll;
+} distinctPartialCounter;
+
+static void *distinctPartialNewInstance(Reducer *r) {
+  distinctPartialCounter *ctr =
+      BlkAlloc_Alloc(&r->alloc, sizeof(*ctr), INSTANCE_BLOCK_NUM * sizeof(*ctr));
+  ctr->dedup = kh_init(khid);
+  ctr->hll = (struct HLL){0};
+  return ctr;
+}
+
+static void distinctPartialFreeInstance(Reducer *r, void *p) {
+  distinctPartialCounter *ctr = p;
+  kh_destroy(khid, ctr->dedup);
+  hll_destroy(&ctr->hll);
+}
+
+/* Values are hashed exactly as COUNT_DISTINCT does, so the merged count matches a local one */
+static int distinctPartialAdd(Reducer *r, void *ctx, const RLookupRow *srcrow) {
+  distinctPartialCounter *ctr = ctx;
+  const RSValue *val = RLookup_GetItem(r->srckey, srcrow);
+  if (!val || val == RS_NullVal()) {
+    return 1;
+  }
+
+  uint64_t hval = RSValue_Hash(val, 0);
+  if (!ctr->dedup) {
+    hll_add_hash(&ctr->hll, distinctHash32(hval));
+    return 1;
+  }
+  int ret;
+  kh_put(khid, ctr->dedup, hval, &ret);
+  if (kh_size(ctr->dedup) > DISTINCT_PARTIAL_MAX_HASHES) {
+    distinctHashesToHll(ctr->dedup, &ctr->hll);
+    kh_destroy(khid, ctr->dedup);
+    ctr->dedup = NULL;
+  }
+  return 1;
+}
+
+static RSValue *distinctPartialFinalize(Reducer *r, void *ctx) {
+  distinctPartialCounter *ctr = ctx;
+  DistinctSerializedHeader hdr = {.isHll = !ctr->dedup, .bits = ctr->hll.bits};
+  size_t len = sizeof(hdr) + (ctr->dedup ? kh_size(ctr->dedup) * sizeof(uint64_t) : ctr->hll.size);
+  char *str = rm_malloc(len);
+  memcpy(str, &hdr, sizeof(hdr));
+  if (ctr->dedup) {
+    char *hashes = str + sizeof(hdr);
+    for (khiter_t k = kh_begin(ctr->dedup); k != kh_end(ctr->dedup); ++k) {
+      if (kh_exist(ctr->dedup, k)) {
+        memcpy(hashes, &kh_key(ctr->dedup, k), sizeof(uint64_t));
+        hashes += sizeof(uint64_t);
+      }
+    }
+  } else {
+    memcpy(str + sizeof(hdr), ctr->hll.registers, ctr->hll.size);
+  }
+  return RS_StringVal(str, len);
+}
+
+Reducer *RDCRCountDistinctPartial_New(const ReducerOptions *options) {
+  Reducer *r = rm_calloc(1, sizeof(*r));
+  if (!ReducerOpts_GetKey(options, &r->srckey)) {
+    rm_free(r);
+    return NULL;
+  }
+  r->Add = distinctPartialAdd;
+  r->Finalize = distinctPartialFinalize;
+  r->Free = Reducer_GenericFree;
+  r->FreeInstance = distinctPartialFreeInstance;
+  r->NewInstance = distinctPartialNewInstance;
+  r->reducerId = REDUCER_T_DISTINCT_PARTIAL;
+  return r;
+}
+
+/* Merges the COUNT_DISTINCT_PARTIAL states of the shards. The count is exact unless a shard, or
+ * the union of the shards, outgrew the dedup set, in which case it is estimated as with
+ * COUNT_DISTINCTISH */
+static int distinctMergeAdd(Reducer *r, void *ctx, const RLookupRow *srcrow) {
+  distinctPartialCounter *ctr = ctx;
+  const RSValue *val = RLookup_GetItem(r->srckey, srcrow);
+  if (!val || val == RS_NullVal()) {
+    return 1;
+  }
+  if (!RSValue_IsString(val)) {
+    return 0;
+  }
+
+  size_t len;
+  const char *buf = RSValue_StringPtrLen(val, &len);
+  if (len < sizeof(DistinctSerializedHeader)) {
+    return 0;
+  }
+  const DistinctSerializedHeader *hdr = (const void *)buf;
+  const char *payload = buf + sizeof(*hdr);
+  len -= sizeof(*hdr);
+
+  if (hdr->isHll) {
+    if (hdr->bits != HLL_PRECISION_BITS || len != 1 << hdr->bits) {
+      return 0;
+    }
+    if (ctr->dedup) {
+      distinctHashesToHll(ctr->dedup, &ctr->hll);
+      kh_destroy(khid, ctr->dedup);
+      ctr->dedup = NULL;
+    }
+    struct HLL tmphll = {
+        .bits = hdr->bits, .size = 1 << hdr->bits, .registers = (uint8_t *)payload};
+    return hll_merge(&ctr->hll, &tmphll) == 0;
+  }
+
+  if (len % sizeof(uint64_t)) {
+    return 0;
+  }
+  for (size_t i = 0; i < len / sizeof(uint64_t); i++) {
+    uint64_t hval;
+    memcpy(&hval, payload + i * sizeof(hval), sizeof(hval));
+    if (ctr->dedup) {
+      int ret;
+      kh_put(khid, ctr->dedup, hval, &ret);
+    } else {
+      hll_add_hash(&ctr->hll, distinctHash32(hval));
+    }
+  }
+  return 1;
+}
+
+static RSValue *distinctMergeFinalize(Reducer *r, void *ctx) {
+  distinctPartialCounter *ctr = ctx;
+  return RS_NumVal(ctr->dedup ? kh_size(ctr->dedup) : (uint64_t)hll_count(&ctr->hll));
+}
+
+Reducer *RDCRCountDistinctMerge_New(const ReducerOptions *options) {
+  Reducer *r = RDCRCountDistinctPartial_New(options);
+  if (r) {
+    r->Add = distinctMergeAdd;
+    r->Finalize = distinctMergeFinalize;
+    r->reducerId = REDUCER_T_DISTINCTMERGE;
+  }
+  return r;
+}
+
 typedef struct {
   struct HLL hll;
   const RLookupKey *key;
@@ -79,3 +79,82 @@ Reducer *RDCRStdDev_New(const ReducerOptions *options) {
   r->reducerId = REDUCER_T_STDDEV;
   return r;
 }
+
+/** Serialized partial state, exchanged between shards and the coordinator */
+typedef struct __attribute__((packed)) {
+  uint64_t n;
+  double M;
+  double S;
+} devSerialized;
+
+static RSValue *stddevPartialFinalize(Reducer *parent, void *instance) {
+  devCtx *dctx = instance;
+  devSerialized ser = {.n = dctx->n, .M = dctx->M, .S = dctx->S};
+  char *str = rm_malloc(sizeof(ser));
+  memcpy(str, &ser, sizeof(ser));
+  return RS_StringVal(str, sizeof(ser));
+}
+
+static int stddevMergeAdd(Reducer *r, void *ctx, const RLookupRow *srcrow) {
+  devCtx *dctx = ctx;
+  const RSValue *val = RLookup_GetItem(r->srckey, srcrow);
+  if (val == NULL || !RSValue_IsString(val)) {
+    return 0;
+  }
+
+  size_t len;
+  const char *buf = RSValue_StringPtrLen(val, &len);
+  if (len != sizeof(devSerialized)) {
+    return 0;
+  }
+  devSerialized other;
+  memcpy(&other, buf, sizeof(other));
+  if (other.n == 0) {
+    return 1;
+  }
+  if (dctx->n == 0) {
+    dctx->n = other.n;
+    dctx->M = other.M;
+    dctx->S = other.S;
+    return 1;
+  }
+
+  // Combine the two partial states (Chan et al.), which is exact up to floating point rounding
+  double na = dctx->n, nb = other.n, n = na + nb;
+  double delta = other.M - dctx->M;
+  dctx->M += delta * nb / n;
+  dctx->S += other.S + delta * delta * na * nb / n;
+  dctx->n += other.n;
+  return 1;
+}
+
+static Reducer *newStdDevCommon(const ReducerOptions *options) {
+  Reducer *r = rm_calloc(1, sizeof(*r));
+  if (!ReducerOptions_GetKey(options, &r->srckey)) {
+    rm_free(r);
+    return NULL;
+  }
+  r->Free = Reducer_GenericFree;
+  r->NewInstance = stddevNewInstance;
+  return r;
+}
+
+Reducer *RDCRStdDevPartial_New(const ReducerOptions *options) {
+  Reducer *r = newStdDevCommon(options);
+  if (r) {
+    r->Add = stddevAdd;
+    r->Finalize = stddevPartialFinalize;
+    r->reducerId = REDUCER_T_STDDEV_PARTIAL;
+  }
+  return r;
+}
+
+Reducer *RDCRStdDevMerge_New(const ReducerOptions *options) {
+  Reducer *r = newStdDevCommon(options);
+  if (r) {
+    r->Add = stddevMergeAdd;
+    r->Finalize = stddevFinalize;
+    r->reducerId = REDUCER_T_STDDEV_MERGE;
+  }
+  return r;
+}
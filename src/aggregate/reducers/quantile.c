@@ -8,6 +8,10 @@
 */
 #include <aggregate/reducer.h>
 #include "util/quantile.h"
+#include "util/tdigest.h"
+
+// The number of centroids a distributed quantile digest holds, and sends, at most
+#define QUANTILE_DIGEST_CAPACITY 500
 
 typedef struct {
   Reducer base;
@@ -20,27 +24,39 @@ static void *quantileNewInstance(Reducer *parent) {
   return NewQuantileStream(NULL, 0, qt->resolution);
 }
 
-static int quantileAdd(Reducer *rbase, void *ctx, const RLookupRow *row) {
+static void quantileInsert(void *ctx, double d) {
+  QS_Insert(ctx, d);
+}
+
+static void digestInsert(void *ctx, double d) {
+  TD_Add(ctx, d, 1);
+}
+
+// Insert the numeric values of the row's source key, or of its items if it is an array
+static void quantileAddRow(Reducer *rbase, const RLookupRow *row, void (*insert)(void *, double),
+                           void *ctx) {
   double d;
-  QTLReducer *qt = (QTLReducer *)rbase;
-  QuantStream *qs = ctx;
   RSValue *v = RLookup_GetItem(rbase->srckey, row);
   if (!v) {
-    return 1;
+    return;
   }
 
   if (v->t != RSValue_Array) {
     if (RSValue_ToNumber(v, &d)) {
-      QS_Insert(qs, d);
+      insert(ctx, d);
     }
   } else {
     uint32_t sz = RSValue_ArrayLen(v);
     for (uint32_t i = 0; i < sz; i++) {
       if (RSValue_ToNumber(RSValue_ArrayItem(v, i), &d)) {
-        QS_Insert(qs, d);
+        insert(ctx, d);
       }
     }
   }
+}
+
+static int quantileAdd(Reducer *rbase, void *ctx, const RLookupRow *row) {
+  quantileAddRow(rbase, row, quantileInsert, ctx);
   return 1;
 }
 
@@ -55,22 +71,31 @@ static void quantileFreeInstance(Reducer *unused, void *p) {
   QS_Free(p);
 }
 
-Reducer *RDCRQuantile_New(const ReducerOptions *options) {
-  QTLReducer *r = rm_calloc(1, sizeof(*r));
-  r->resolution = 500;  // Fixed, i guess?
-
+// Parse the source key and the percentage, which QUANTILE and QUANTILE_MERGE share
+static bool quantileParseArgs(QTLReducer *r, const ReducerOptions *options) {
   if (!ReducerOptions_GetKey(options, &r->base.srckey)) {
-    goto error;
+    return false;
   }
   int rv;
   if ((rv = AC_GetDouble(options->args, &r->pct, 0)) != AC_OK) {
     QERR_MKBADARGS_AC(options->status, options->name, rv);
-    goto error;
+    return false;
   }
   if (!(r->pct >= 0 && r->pct <= 1.0)) {
     QueryError_SetError(options->status, QUERY_EPARSEARGS, "Percentage must be between 0.0 and 1.0");
+    return false;
+  }
+  return true;
+}
+
+Reducer *RDCRQuantile_New(const ReducerOptions *options) {
+  QTLReducer *r = rm_calloc(1, sizeof(*r));
+  r->resolution = 500;  // Fixed, i guess?
+
+  if (!quantileParseArgs(r, options)) {
     goto error;
   }
+  int rv;
 
   if (!AC_IsAtEnd(options->args)) {
     // TODO: why do we need this hidden option? why isn't it available in cluster mode?
@@ -99,3 +124,71 @@ error:
   rm_free(r);
   return NULL;
 }
+
+/* The shards send the values of each group as a serialized t-digest (QUANTILE_PARTIAL), which the
+ * coordinator merges and queries (QUANTILE_MERGE). Groups of up to QUANTILE_DIGEST_CAPACITY values
+ * give the same result as a local QUANTILE */
+
+static void *digestNewInstance(Reducer *r) {
+  return NewTDigest(QUANTILE_DIGEST_CAPACITY);
+}
+
+static void digestFreeInstance(Reducer *r, void *p) {
+  TD_Free(p);
+}
+
+static int quantilePartialAdd(Reducer *rbase, void *ctx, const RLookupRow *row) {
+  quantileAddRow(rbase, row, digestInsert, ctx);
+  return 1;
+}
+
+static RSValue *quantilePartialFinalize(Reducer *r, void *ctx) {
+  size_t len;
+  char *buf = TD_Serialize(ctx, &len);
+  return RS_StringVal(buf, len);
+}
+
+static int quantileMergeAdd(Reducer *rbase, void *ctx, const RLookupRow *row) {
+  const RSValue *val = RLookup_GetItem(rbase->srckey, row);
+  if (val == NULL || !RSValue_IsString(val)) {
+    return 0;
+  }
+  size_t len;
+  const char *buf = RSValue_StringPtrLen(val, &len);
+  return TD_MergeSerialized(ctx, buf, len);
+}
+
+static RSValue *quantileMergeFinalize(Reducer *r, void *ctx) {
+  QTLReducer *qt = (QTLReducer *)r;
+  return RS_NumVal(TD_Query(ctx, qt->pct));
+}
+
+Reducer *RDCRQuantilePartial_New(const ReducerOptions *options) {
+  Reducer *r = rm_calloc(1, sizeof(*r));
+  if (!ReducerOptions_GetKey(options, &r->srckey) || !ReducerOpts_EnsureArgsConsumed(options)) {
+    rm_free(r);
+    return NULL;
+  }
+  r->NewInstance = digestNewInstance;
+  r->Add = quantilePartialAdd;
+  r->Free = Reducer_GenericFree;
+  r->FreeInstance = digestFreeInstance;
+  r->Finalize = quantilePartialFinalize;
+  r->reducerId = REDUCER_T_QUANTILE_PARTIAL;
+  return r;
+}
+
+Reducer *RDCRQuantileMerge_New(const ReducerOptions *options) {
+  QTLReducer *r = rm_calloc(1, sizeof(*r));
+  if (!quantileParseArgs(r, options) || !ReducerOpts_EnsureArgsConsumed(options)) {
+    rm_free(r);
+    return NULL;
+  }
+  r->base.NewInstance = digestNewInstance;
+  r->base.Add = quantileMergeAdd;
+  r->base.Free = Reducer_GenericFree;
+  r->base.FreeInstance = digestFreeInstance;
+  r->base.Finalize = quantileMergeFinalize;
+  r->base.reducerId = REDUCER_T_QUANTILE_MERGE;
+  return &r->base;
+}
@@ -88,6 +88,7 @@ configPair_t __configPairs[] = {
   {"BM25STD_TANH_FACTOR",             "search-bm25std-tanh-factor"},
   {"_BG_INDEX_OOM_PAUSE_TIME",         "search-_bg-index-oom-pause-time"},
   {"INDEXER_YIELD_EVERY_OPS",         "search-indexer-yield-every-ops"},
+  {"QUERY_CACHE_MAX_MEMORY",          "search-query-cache-max-memory"},
 };
 
 static const char* FTConfigNameToConfigName(const char *name) {
@@ -846,6 +847,8 @@ CONFIG_SETTER(setGcPolicy) {
   CHECK_RETURN_PARSE_ERROR(acrc);
   if (!strcasecmp(policy, "DEFAULT") || !strcasecmp(policy, "FORK")) {
     config->gcConfigParams.gcPolicy = GCPolicy_Fork;
+  } else if (!strcasecmp(policy, "THREAD")) {
+    config->gcConfigParams.gcPolicy = GCPolicy_Thread;
   } else if (!strcasecmp(policy, "LEGACY")) {
     QueryError_SetError(status, QUERY_EPARSEARGS, "Legacy GC policy is no longer supported (since 2.6.0)");
     return REDISMODULE_ERR;
@@ -991,6 +994,17 @@ CONFIG_GETTER(getIndexerYieldEveryOps) {
   return sdscatprintf(ss, "%u", config->indexerYieldEveryOpsWhileLoading);
 }
 
+// QUERY_CACHE_MAX_MEMORY
+CONFIG_SETTER(setQueryCacheMaxMemory) {
+  int acrc = AC_GetSize(ac, &config->queryCacheMaxMemory, AC_F_GE0);
+  RETURN_STATUS(acrc);
+}
+
+CONFIG_GETTER(getQueryCacheMaxMemory) {
+  sds ss = sdsempty();
+  return sdscatprintf(ss, "%zu", config->queryCacheMaxMemory);
+}
+
 RSConfig RSGlobalConfig = RS_DEFAULT_CONFIG;
 
 static RSConfigVar *findConfigVar(const RSConfigOptions *config, const char *name) {
@@ -1184,7 +1198,7 @@ RSConfigOptions RSGlobalConfigOptions = {
          .setValue = setMinPhoneticTermLen,
          .getValue = getMinPhoneticTermLen},
         {.name = "GC_POLICY",
-         .helpText = "gc policy to use (DEFAULT/LEGACY)",
+         .helpText = "gc policy to use (DEFAULT/FORK/THREAD)",
          .setValue = setGcPolicy,
          .getValue = getGcPolicy,
          .flags = RSCONFIGVAR_F_IMMUTABLE},
@@ -1318,6 +1332,11 @@ RSConfigOptions RSGlobalConfigOptions = {
          .helpText = "The number of operations to perform before yielding to Redis during indexing while loading",
          .setValue = setIndexerYieldEveryOps,
          .getValue = getIndexerYieldEveryOps},
+        {.name = "QUERY_CACHE_MAX_MEMORY",
+         .helpText = "The memory (in bytes) each index may use to cache query replies. "
+                     "Default is 0 (disabled)",
+         .setValue = setQueryCacheMaxMemory,
+         .getValue = getQueryCacheMaxMemory},
         {.name = NULL}}};
 
 void RSConfigOptions_AddConfigs(RSConfigOptions *src, RSConfigOptions *dst) {
@@ -1512,6 +1531,9 @@ int RSConfig_SetOption(RSConfig *config, RSConfigOptions *options, const char *n
   ArgsCursor_InitRString(&ac, argv + *offset, argc - *offset);
   int rc = var->setValue(config, &ac, var->triggerId, status);
   *offset += ac.offset;
+  if (rc == REDISMODULE_OK) {
+    config->generation++;
+  }
   return rc;
 }
 
@@ -1810,6 +1832,15 @@ int RegisterModuleConfig(RedisModuleCtx *ctx) {
     )
   )
 
+  RM_TRY(
+    RedisModule_RegisterNumericConfig(
+      ctx, "search-query-cache-max-memory", DEFAULT_QUERY_CACHE_MAX_MEMORY,
+      REDISMODULE_CONFIG_UNPREFIXED, 0,
+      LLONG_MAX, get_size_t_numeric_config, set_size_t_numeric_config, NULL,
+      (void *)&(RSGlobalConfig.queryCacheMaxMemory)
+    )
+  )
+
   // String parameters
   RM_TRY(
     RedisModule_RegisterStringConfig(
@@ -29,7 +29,7 @@ static const char *on_timeout_vals[2] = {
   "fail"
 };
 
-typedef enum { GCPolicy_Fork = 0 } GCPolicy;
+typedef enum { GCPolicy_Fork = 0, GCPolicy_Thread = 1 } GCPolicy;
 
 const char *TimeoutPolicy_ToString(RSTimeoutPolicy);
 
@@ -42,6 +42,8 @@ static inline const char *GCPolicy_ToString(GCPolicy policy) {
   switch (policy) {
     case GCPolicy_Fork:
       return "fork";
+    case GCPolicy_Thread:
+      return "thread";
     default:          // LCOV_EXCL_LINE cannot be reached
       return "huh?";  // LCOV_EXCL_LINE cannot be reached
   }
@@ -166,6 +168,13 @@ typedef struct {
   // Set how much time after OOM is detected we should wait to enable the resource manager to
   // allocate more memory.
   uint32_t bgIndexingOomPauseTimeBeforeRetry;
+  // The memory each index may use to cache query replies. 0 disables the cache. A cached reply is
+  // served until the index revision changes, so documents whose keys expired but were not deleted
+  // yet (lazy expiration) remain in it until a write to the index
+  size_t queryCacheMaxMemory;
+  // Incremented on every configuration change. Part of the query cache keys, so replies computed
+  // with a previous configuration are not served
+  uint64_t generation;
 } RSConfig;
 
 typedef enum {
@@ -287,6 +296,7 @@ char *getRedisConfigValue(RedisModuleCtx *ctx, const char* confName);
 #define BM25STD_TANH_FACTOR_MIN 1
 #define DEFAULT_BG_OOM_PAUSE_TIME_BEFOR_RETRY 5
 #define DEFAULT_INDEXER_YIELD_EVERY_OPS 1000
+#define DEFAULT_QUERY_CACHE_MAX_MEMORY 0
 
 // default configuration
 #define RS_DEFAULT_CONFIG {                                                    \
@@ -335,6 +345,7 @@ char *getRedisConfigValue(RedisModuleCtx *ctx, const char* confName);
     .requestConfigParams.BM25STD_TanhFactor = DEFAULT_BM25STD_TANH_FACTOR,     \
     .bgIndexingOomPauseTimeBeforeRetry = DEFAULT_BG_OOM_PAUSE_TIME_BEFOR_RETRY,    \
     .indexerYieldEveryOpsWhileLoading = DEFAULT_INDEXER_YIELD_EVERY_OPS,       \
+    .queryCacheMaxMemory = DEFAULT_QUERY_CACHE_MAX_MEMORY,                     \
   }
 
 #define REDIS_ARRAY_LIMIT 7
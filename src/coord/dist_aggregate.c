@@ -234,6 +234,12 @@ typedef struct {
   MRCommand cmd;
   AREQ *areq;
 
+  // Whether the rows of each reply are sorted by the keys of the sorter that reads from us
+  bool sortedReplies;
+
+  // The key each field of the last row was written to, by the field's position in the row
+  arrayof(const RLookupKey *) fieldKeys;
+
   // profile vars
   arrayof(MRReply *) shardsProfile;
 } RPNet;
@@ -322,7 +328,21 @@ void processResultFormat(uint32_t *flags, MRReply *map) {
   *flags &= ~QEXEC_FORMAT_DEFAULT;
 }
 
-static int rpnetNext(ResultProcessor *self, SearchResult *r) {
+// Writes a field of a row. The rows of a reply usually have the same fields in the same order, so we
+// try the key that the field at the same position was written to last time, before looking up the
+// field by name
+static void RPNet_writeField(RPNet *nc, size_t pos, const char *field, size_t len, RLookupRow *row,
+                             RSValue *v) {
+  const RLookupKey **cached = array_ensure_at(&nc->fieldKeys, pos, const RLookupKey *);
+  const RLookupKey *k = *cached;
+  if (k && k->name_len == len && !memcmp(k->name, field, len)) {
+    RLookup_WriteOwnKey(k, row, v);
+  } else {
+    *cached = RLookup_WriteOwnKeyByName(nc->lookup, field, len, row, v);
+  }
+}
+
+static int rpnetNextRow(ResultProcessor *self, SearchResult *r) {
   RPNet *nc = (RPNet *)self;
   MRReply *root = nc->current.root, *rows = nc->current.rows;
 
@@ -450,7 +470,7 @@ static int rpnetNext(ResultProcessor *self, SearchResult *r) {
       const char *field = MRReply_String(MRReply_ArrayElement(fields, i), &len);
       MRReply *val = MRReply_ArrayElement(fields, i + 1);
       RSValue *v = MRReply_ToValue(val);
-      RLookup_WriteOwnKeyByName(nc->lookup, field, len, &r->rowdata, v);
+      RPNet_writeField(nc, i / 2, field, len, &r->rowdata, v);
     }
   }
   else // RESP2
@@ -464,12 +484,52 @@ static int rpnetNext(ResultProcessor *self, SearchResult *r) {
         MRReply *val = MRReply_ArrayElement(rep, i + 1);
         v = MRReply_ToValue(val);
       }
-      RLookup_WriteOwnKeyByName(nc->lookup, field, len, &r->rowdata, v);
+      RPNet_writeField(nc, i / 2, field, len, &r->rowdata, v);
     }
   }
   return RS_RESULT_OK;
 }
 
+// Returns true if the row is sure to be rejected by the sorter reading from us, and so is the
+// rest of the reply it came from
+static bool rpnetBelowSortThreshold(const RPNet *nc, const SearchResult *r) {
+  const QueryProcessingCtx *qctx = nc->base.parent;
+  if (!nc->sortedReplies || !qctx->sortThreshold.active) {
+    return false;
+  }
+  // Only numbers are compared the same way here and on the shards
+  const RSValue *v = RLookup_GetItem(qctx->sortThreshold.key, &r->rowdata);
+  if (!v || v->t != RSValue_Number) {
+    return false;
+  }
+  return qctx->sortThreshold.ascending ? v->numval > qctx->sortThreshold.value
+                                       : v->numval < qctx->sortThreshold.value;
+}
+
+// Skip the remaining rows of the current reply. The reply itself is released by the next read
+static void RPNet_skipCurrentRows(RPNet *nc) {
+  MRReply *rows = nc->current.rows;
+  if (!rows) {
+    return;
+  }
+  if (MRReply_Type(rows) == MR_REPLY_MAP) {
+    nc->curIdx = MRReply_Length(MRReply_MapElement(rows, "results"));
+  } else {
+    nc->curIdx = MRReply_Length(rows);
+  }
+}
+
+static int rpnetNext(ResultProcessor *self, SearchResult *r) {
+  RPNet *nc = (RPNet *)self;
+  int rc;
+  while ((rc = rpnetNextRow(self, r)) == RS_RESULT_OK && rpnetBelowSortThreshold(nc, r)) {
+    // The shard sorted the reply, so none of the following rows can make it to the sorter's heap
+    RPNet_skipCurrentRows(nc);
+    SearchResult_Clear(r);
+  }
+  return rc;
+}
+
 static int rpnetNext_Start(ResultProcessor *rp, SearchResult *r) {
   RPNet *nc = (RPNet *)rp;
   MRIterator *it = MR_Iterate(&nc->cmd, netCursorCallback);
@@ -501,6 +561,7 @@ static void rpnetFree(ResultProcessor *rp) {
 
   MRReply_Free(nc->current.root);
   MRCommand_Free(&nc->cmd);
+  array_free(nc->fieldKeys);
 
   rm_free(rp);
 }
@@ -617,12 +678,26 @@ static void buildMRCommand(RedisModuleString **argv, int argc, int profileArgs,
   array_free(tmparr);
 }
 
+// Returns true if the shards sort their replies by the keys of the first local step. This is the
+// case when the remote plan ends with the remote half of a split SORTBY, so the first local step
+// is its local half
+static bool shardRepliesSorted(const AREQ *r) {
+  const PLN_DistributeStep *dstp =
+      (const PLN_DistributeStep *)AGPLN_FindStep(&r->ap, NULL, NULL, PLN_T_DISTRIBUTE);
+  if (!dstp) {
+    return false;
+  }
+  const PLN_BaseStep *last = PLN_PREV_STEP(PLN_END_STEP(dstp->plan));
+  return last->type == PLN_T_ARRANGE && ((const PLN_ArrangeStep *)last)->sortKeys;
+}
+
 static void buildDistRPChain(AREQ *r, MRCommand *xcmd, AREQDIST_UpstreamInfo *us) {
   // Establish our root processor, which is the distributed processor
   RPNet *rpRoot = RPNet_New(xcmd); // This will take ownership of the command
   rpRoot->base.parent = &r->qiter;
   rpRoot->lookup = us->lookup;
   rpRoot->areq = r;
+  rpRoot->sortedReplies = shardRepliesSorted(r);
 
   ResultProcessor *rpProfile = NULL;
   if (IsProfile(r)) {
@@ -60,6 +60,7 @@ struct ReducerDistCtx {
     if (PLNGroupStep_AddReducer(gstp, name, cargs, status) != REDISMODULE_OK) {
       return false;
     }
+    array_tail(gstp->reducers).isInternal = true;
     if (alias) {
       *alias = getLastAlias(gstp);
     }
@@ -241,40 +242,81 @@ static int distributeSingleArgSelf(ReducerDistCtx *rdctx, QueryError *status) {
   return REDISMODULE_OK;
 }
 
-#define RANDOM_SAMPLE_SIZE 500
-
-#define STRINGIFY_(a) STRINGIFY__(a)
-#define STRINGIFY__(a) #a
-#define RANDOM_SAMPLE_SIZE_STR STRINGIFY_(RANDOM_SAMPLE_SIZE)
-
-/* Distribute QUANTILE into remote RANDOM_SAMPLE and local QUANTILE */
+/* Distribute QUANTILE into remote QUANTILE_PARTIAL and local QUANTILE_MERGE. The shards send a
+ * t-digest of their values, which the coordinator merges before querying the percentage */
 static int distributeQuantile(ReducerDistCtx *rdctx, QueryError *status) {
   PLN_Reducer *src = rdctx->srcReducer;
   CHECK_ARG_COUNT(2);
   const char *alias = NULL;
 
-  if (!rdctx->addRemote("RANDOM_SAMPLE", &alias, status, "2", rdctx->srcarg(0),
-                        RANDOM_SAMPLE_SIZE_STR)) {
+  if (!rdctx->addRemote("QUANTILE_PARTIAL", &alias, status, "1", rdctx->srcarg(0))) {
     return REDISMODULE_ERR;
   }
 
-  if (!rdctx->addLocal("QUANTILE", status, "2", alias, rdctx->srcarg(1), "AS", src->alias)) {
+  if (!rdctx->addLocal("QUANTILE_MERGE", status, "2", alias, rdctx->srcarg(1), "AS", src->alias)) {
     return REDISMODULE_ERR;
   }
 
   return REDISMODULE_OK;
 }
 
-/* Distribute STDDEV into remote RANDOM_SAMPLE and local STDDEV */
+/* Distribute STDDEV into remote STDDEV_PARTIAL and local STDDEV_MERGE. The shards send their
+ * (count, mean, sum of squared deviations) state, so the merged result is exact */
 static int distributeStdDev(ReducerDistCtx *rdctx, QueryError *status) {
   PLN_Reducer *src = rdctx->srcReducer;
   const char *alias = NULL;
   CHECK_ARG_COUNT(1);
-  if (!rdctx->addRemote("RANDOM_SAMPLE", &alias, status, "2", rdctx->srcarg(0),
-                        RANDOM_SAMPLE_SIZE_STR)) {
+  if (!rdctx->addRemote("STDDEV_PARTIAL", &alias, status, "1", rdctx->srcarg(0))) {
+    return REDISMODULE_ERR;
+  }
+  if (!rdctx->addLocal("STDDEV_MERGE", status, "1", alias, "AS", src->alias)) {
+    return REDISMODULE_ERR;
+  }
+  return REDISMODULE_OK;
+}
+
+/* Distribute COUNT_DISTINCT into remote COUNT_DISTINCT_PARTIAL and local COUNT_DISTINCT_MERGE. The
+ * shards send the hashes of their distinct values, or an HLL as COUNT_DISTINCTISH does once they
+ * have too many of them */
+static int distributeCountDistinct(ReducerDistCtx *rdctx, QueryError *status) {
+  PLN_Reducer *src = rdctx->srcReducer;
+  CHECK_ARG_COUNT(1);
+  const char *alias;
+  if (!rdctx->addRemote("COUNT_DISTINCT_PARTIAL", &alias, status, "1", rdctx->srcarg(0))) {
+    return REDISMODULE_ERR;
+  }
+  if (!rdctx->addLocal("COUNT_DISTINCT_MERGE", status, "1", alias, "AS", src->alias)) {
+    return REDISMODULE_ERR;
+  }
+  return REDISMODULE_OK;
+}
+
+/* Distribute FIRST_VALUE. When sorted, each shard also returns the sort value of the row it
+ * picked, so the coordinator can pick between the shards' candidates */
+static int distributeFirstValue(ReducerDistCtx *rdctx, QueryError *status) {
+  PLN_Reducer *src = rdctx->srcReducer;
+  size_t argc = src->args.argc;
+  if (argc == 1) {
+    return distributeSingleArgSelf(rdctx, status);
+  }
+  if ((argc != 3 && argc != 4) || strcasecmp(rdctx->srcarg(1), "BY")) {
+    QueryError_SetWithoutUserDataFmt(status, QUERY_EPARSEARGS, "Invalid arguments for reducer %s",
+                                     src->name);
+    return REDISMODULE_ERR;
+  }
+  const char *order = argc == 4 ? rdctx->srcarg(3) : "ASC";
+
+  const char *valueAlias, *sortAlias;
+  if (!rdctx->addRemote("FIRST_VALUE", &valueAlias, status, "4", rdctx->srcarg(0), "BY",
+                        rdctx->srcarg(2), order)) {
+    return REDISMODULE_ERR;
+  }
+  if (!rdctx->addRemote("FIRST_VALUE", &sortAlias, status, "4", rdctx->srcarg(2), "BY",
+                        rdctx->srcarg(2), order)) {
     return REDISMODULE_ERR;
   }
-  if (!rdctx->addLocal("STDDEV", status, "1", alias, "AS", src->alias)) {
+  if (!rdctx->addLocal("FIRST_VALUE", status, "4", valueAlias, "BY", sortAlias, order, "AS",
+                       src->alias)) {
     return REDISMODULE_ERR;
   }
   return REDISMODULE_OK;
@@ -349,6 +391,8 @@ static struct {
     {"TOLIST", distributeSingleArgSelf},
     {"STDDEV", distributeStdDev},
     {"COUNT_DISTINCTISH", distributeCountDistinctish},
+    {"COUNT_DISTINCT", distributeCountDistinct},
+    {"FIRST_VALUE", distributeFirstValue},
     {"QUANTILE", distributeQuantile},
 
     {NULL, NULL}  // sentinel value
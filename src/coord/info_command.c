@@ -67,6 +67,14 @@ static InfoFieldSpec cursorSpecs[] = {
     {.name = "index_total", .type = InfoField_WholeSum},
 };
 
+static InfoFieldSpec queryCacheSpecs[] = {
+    {.name = "hits", .type = InfoField_WholeSum},
+    {.name = "misses", .type = InfoField_WholeSum},
+    {.name = "entries", .type = InfoField_WholeSum},
+    {.name = "memory", .type = InfoField_WholeSum},
+    {.name = "evictions", .type = InfoField_WholeSum},
+};
+
 static InfoFieldSpec dialectSpecs[] = {
     {.name = "dialect_1", .type = InfoField_Max},
     {.name = "dialect_2", .type = InfoField_Max},
@@ -78,6 +86,7 @@ static InfoFieldSpec dialectSpecs[] = {
 #define NUM_FIELDS_SPEC (ARRAY_SIZE(toplevelSpecs_g))
 #define NUM_GC_FIELDS_SPEC (ARRAY_SIZE(gcSpecs))
 #define NUM_CURSOR_FIELDS_SPEC (ARRAY_SIZE(cursorSpecs))
+#define NUM_QUERY_CACHE_FIELDS_SPEC (ARRAY_SIZE(queryCacheSpecs))
 #define NUM_DIALECT_FIELDS_SPEC (ARRAY_SIZE(dialectSpecs))
 
 // Variant value type
@@ -110,6 +119,8 @@ typedef struct {
   IndexError indexError;
   InfoValue gcValues[NUM_GC_FIELDS_SPEC];
   InfoValue cursorValues[NUM_CURSOR_FIELDS_SPEC];
+  bool hasQueryCacheStats;  // Only reported by shards with the query cache enabled
+  InfoValue queryCacheValues[NUM_QUERY_CACHE_FIELDS_SPEC];
   MRReply *stopWordList;
   InfoValue dialectValues[NUM_DIALECT_FIELDS_SPEC];
 } InfoFields;
@@ -264,6 +275,9 @@ static void handleSpecialField(InfoFields *fields, const char *name, MRReply *va
     recomputeAverageCycleTimeMs(fields->gcValues, gcSpecs, NUM_GC_FIELDS_SPEC);
   } else if (!strcmp(name, "cursor_stats")) {
     processKvArray(fields, value, fields->cursorValues, cursorSpecs, NUM_CURSOR_FIELDS_SPEC, 1, error);
+  } else if (!strcmp(name, "query_cache_stats")) {
+    fields->hasQueryCacheStats = true;
+    processKvArray(fields, value, fields->queryCacheValues, queryCacheSpecs, NUM_QUERY_CACHE_FIELDS_SPEC, 1, error);
   } else if (!strcmp(name, "dialect_stats")) {
     processKvArray(fields, value, fields->dialectValues, dialectSpecs, NUM_DIALECT_FIELDS_SPEC, 1, error);
   } else if (!strcmp(name, "field statistics")) {
@@ -367,6 +381,12 @@ static void generateFieldsReply(InfoFields *fields, RedisModule_Reply *reply, bo
   replyKvArray(reply, fields, fields->cursorValues, cursorSpecs, NUM_CURSOR_FIELDS_SPEC);
   RedisModule_Reply_MapEnd(reply);
 
+  if (fields->hasQueryCacheStats) {
+    RedisModule_ReplyKV_Map(reply, "query_cache_stats");
+    replyKvArray(reply, fields, fields->queryCacheValues, queryCacheSpecs, NUM_QUERY_CACHE_FIELDS_SPEC);
+    RedisModule_Reply_MapEnd(reply);
+  }
+
   if (fields->stopWordList) {
     RedisModule_ReplyKV_MRReply(reply, "stopwords_list", fields->stopWordList);
   }
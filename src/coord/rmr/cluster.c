@@ -76,7 +76,7 @@ MRClusterShard *_MRCluster_FindShard(MRCluster *cl, unsigned slot) {
 }
 
 /* Select a node from the shard according to the coordination strategy */
-MRClusterNode *_MRClusterShard_SelectNode(MRClusterShard *sh, bool mastersOnly) {
+MRClusterNode *_MRClusterShard_SelectNode(MRClusterShard *sh, MRConnManager *mgr, bool mastersOnly) {
   // if we only want masters - find the master of this shard
   if (mastersOnly) {
     for (int i = 0; i < sh->numNodes; i++) {
@@ -86,8 +86,19 @@ MRClusterNode *_MRClusterShard_SelectNode(MRClusterShard *sh, bool mastersOnly)
     }
     return NULL;
   }
-  // if we don't care - select a random node
-  return &sh->nodes[rand() % sh->numNodes];
+  if (sh->numNodes < 2) {
+    return sh->numNodes ? &sh->nodes[0] : NULL;
+  }
+  // if we don't care - pick two random nodes and select the one with the lower expected cost, so a
+  // slow or backed up replica is avoided without herding all the requests onto a single node
+  int a = rand() % sh->numNodes;
+  int b = rand() % (sh->numNodes - 1);
+  if (b >= a) b++;
+  double costA = MRConnManager_NodeCost(mgr, sh->nodes[a].id);
+  double costB = MRConnManager_NodeCost(mgr, sh->nodes[b].id);
+  if (costA < 0) return &sh->nodes[b];
+  if (costB < 0) return &sh->nodes[a];
+  return &sh->nodes[costB < costA ? b : a];
 }
 
 typedef struct {
@@ -160,7 +171,7 @@ MRConn* MRCluster_GetConn(MRCluster *cl, bool mastersOnly, MRCommand *cmd) {
   MRClusterShard *sh = _MRCluster_FindShard(cl, slot);
   if (!sh) return NULL;
 
-  MRClusterNode *node = _MRClusterShard_SelectNode(sh, mastersOnly);
+  MRClusterNode *node = _MRClusterShard_SelectNode(sh, &cl->mgr, mastersOnly);
   if (!node) return NULL;
 
   return MRConn_Get(&cl->mgr, node->id);
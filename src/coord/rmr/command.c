@@ -11,6 +11,7 @@
 #include "command.h"
 #include "rmalloc.h"
 #include "resp3.h"
+#include "hiredis/hiredis.h"
 
 #include "version.h"
 
@@ -29,6 +30,21 @@ void MRCommand_Free(MRCommand *cmd) {
   rm_free(cmd->lens);
 }
 
+/* Drop the serialized form of the command, after its arguments were modified */
+static void clearFormatted(MRCommand *cmd) {
+  if (cmd->cmd) {
+    sdsfree(cmd->cmd);
+    cmd->cmd = NULL;
+  }
+}
+
+int MRCommand_Format(MRCommand *cmd) {
+  if (cmd->cmd) {
+    return REDIS_OK;
+  }
+  return redisFormatSdsCommandArgv(&cmd->cmd, cmd->num, (const char **)cmd->strs, cmd->lens);
+}
+
 static void assignStr(MRCommand *cmd, size_t idx, const char *s, size_t n) {
   char *news = rm_malloc(n + 1);
   cmd->strs[idx] = news;
@@ -89,6 +105,9 @@ MRCommand MRCommand_Copy(const MRCommand *cmd) {
   for (int i = 0; i < cmd->num; i++) {
     copyStr(&ret, i, cmd, i);
   }
+  if (cmd->cmd) {
+    ret.cmd = sdsdup(cmd->cmd);
+  }
   return ret;
 }
 
@@ -115,6 +134,7 @@ MRCommand MR_NewCommandFromRedisStrings(int argc, RedisModuleString **argv) {
 }
 
 static void extendCommandList(MRCommand *cmd, size_t toAdd) {
+  clearFormatted(cmd);
   cmd->num += toAdd;
   cmd->strs = rm_realloc(cmd->strs, sizeof(*cmd->strs) * cmd->num);
   cmd->lens = rm_realloc(cmd->lens, sizeof(*cmd->lens) * cmd->num);
@@ -163,6 +183,7 @@ void MRCommand_ReplaceArgNoDup(MRCommand *cmd, int index, const char *newArg, si
   if (index < 0 || index >= cmd->num) {
     return;
   }
+  clearFormatted(cmd);
   char *tmp = cmd->strs[index];
   cmd->strs[index] = (char *)newArg;
   cmd->lens[index] = len;
@@ -58,6 +58,10 @@ MRCommand MR_NewCommand(int argc, ...);
 /* Create a command from a list of redis strings */
 MRCommand MR_NewCommandFromRedisStrings(int argc, RedisModuleString **argv);
 
+/* Serialize the command to the wire protocol, unless it is already serialized. The serialized
+ * form is kept until the command's arguments are modified. Returns REDIS_OK or REDIS_ERR */
+int MRCommand_Format(MRCommand *cmd);
+
 static inline const char *MRCommand_ArgStringPtrLen(const MRCommand *cmd, size_t idx, size_t *len) {
   // assert(idx < cmd->num);
   if (len) {
@@ -33,6 +33,7 @@ static int MRConn_SendAuth(MRConn *conn);
 
 #define RSCONN_RECONNECT_TIMEOUT 250
 #define RSCONN_REAUTH_TIMEOUT 1000
+#define RSCONN_LATENCY_EWMA_ALPHA 0.2
 #define INTERNALAUTH_USERNAME "internal connection"
 #define UNUSED(x) (void)(x)
 
@@ -58,12 +59,6 @@ static redisAsyncContext *detachFromConn(MRConn *conn, int shouldFree) {
   }
 }
 
-typedef struct {
-  size_t num;
-  size_t rr;  // round robin counter
-  MRConn **conns;
-} MRConnPool;
-
 static MRConnPool *_MR_NewConnPool(MREndpoint *ep, size_t num) {
   MRConnPool *pool = rm_malloc(sizeof(*pool));
   *pool = (MRConnPool){
@@ -91,19 +86,19 @@ static void MRConnPool_Free(void *privdata, void *p) {
   rm_free(pool);
 }
 
-/* Get a connection from the connection pool. We select the next available connected connection with
- * a round robin selector */
+/* Get a connection from the connection pool. We select the connected connection with the fewest
+ * in-flight commands, breaking ties with a round robin selector */
 static MRConn *MRConnPool_Get(MRConnPool *pool) {
+  MRConn *best = NULL;
   for (size_t i = 0; i < pool->num; i++) {
-
-    MRConn *conn = pool->conns[pool->rr];
-    // increase the round-robin counter
-    pool->rr = (pool->rr + 1) % pool->num;
-    if (conn->state == MRConn_Connected) {
-      return conn;
+    MRConn *conn = pool->conns[(pool->rr + i) % pool->num];
+    if (conn->state == MRConn_Connected && (!best || conn->pending < best->pending)) {
+      best = conn;
     }
   }
-  return NULL;
+  // increase the round-robin counter
+  pool->rr = (pool->rr + 1) % pool->num;
+  return best;
 }
 
 static dictType nodeIdToConnPoolType = {
@@ -156,6 +151,55 @@ MRConn *MRConn_Get(MRConnManager *mgr, const char *id) {
   return NULL;
 }
 
+double MRConnManager_NodeCost(MRConnManager *mgr, const char *id) {
+  dictEntry *ptr = dictFind(mgr->map, id);
+  if (!ptr) {
+    return -1;
+  }
+  MRConnPool *pool = dictGetVal(ptr);
+  size_t connected = 0, pending = 0;
+  double latency = 0;
+  for (size_t i = 0; i < pool->num; i++) {
+    MRConn *conn = pool->conns[i];
+    if (conn->state == MRConn_Connected) {
+      connected++;
+      pending += conn->pending;
+      latency += conn->latency;
+    }
+  }
+  if (!connected) {
+    return -1;
+  }
+  // A node we have no latency samples for yet is ranked by its queue depth alone
+  latency /= connected;
+  return (pending + 1) * (latency > 1 ? latency : 1);
+}
+
+/* Wraps the caller's callback, to account for the command's completion */
+typedef struct {
+  redisCallbackFn *fn;
+  void *privdata;
+  uint64_t sentAt;
+} MRConnRequest;
+
+static void MRConn_RequestCallback(redisAsyncContext *c, void *r, void *privdata) {
+  MRConnRequest *req = privdata;
+  // A detached context has no connection, and its commands were already discounted
+  MRConn *conn = c->data;
+  if (conn && conn->pending) {
+    conn->pending--;
+    if (r) {
+      double us = (uv_hrtime() - req->sentAt) / 1000.0;
+      conn->latency =
+          conn->latency ? conn->latency + RSCONN_LATENCY_EWMA_ALPHA * (us - conn->latency) : us;
+    }
+  }
+  redisCallbackFn *fn = req->fn;
+  privdata = req->privdata;
+  rm_free(req);
+  fn(c, r, privdata);
+}
+
 /* Send a command to the connection */
 int MRConn_SendCommand(MRConn *c, MRCommand *cmd, redisCallbackFn *fn, void *privdata) {
 
@@ -164,16 +208,26 @@ int MRConn_SendCommand(MRConn *c, MRCommand *cmd, redisCallbackFn *fn, void *pri
     return REDIS_ERR;
   }
 
-  if (!cmd->cmd) {
-    if (redisFormatSdsCommandArgv(&cmd->cmd, cmd->num, (const char **)cmd->strs, cmd->lens) == REDIS_ERR) {
-      return REDIS_ERR;
-    }
+  if (MRCommand_Format(cmd) == REDIS_ERR) {
+    return REDIS_ERR;
   }
   if (cmd->protocol != 0 && (!c->protocol || c->protocol != cmd->protocol)) {
     int rc = redisAsyncCommand(c->conn, NULL, NULL, "HELLO %d", cmd->protocol);
     c->protocol = cmd->protocol;
   }
-  return redisAsyncFormattedCommand(c->conn, fn, privdata, cmd->cmd, sdslen(cmd->cmd));
+  if (!fn) {
+    return redisAsyncFormattedCommand(c->conn, NULL, privdata, cmd->cmd, sdslen(cmd->cmd));
+  }
+
+  MRConnRequest *req = rm_malloc(sizeof(*req));
+  *req = (MRConnRequest){.fn = fn, .privdata = privdata, .sentAt = uv_hrtime()};
+  if (redisAsyncFormattedCommand(c->conn, MRConn_RequestCallback, req, cmd->cmd,
+                                 sdslen(cmd->cmd)) == REDIS_ERR) {
+    rm_free(req);
+    return REDIS_ERR;
+  }
+  c->pending++;
+  return REDIS_OK;
 }
 
 /* Add a node to the connection manager. Return 1 if it's been added or 0 if it hasn't */
@@ -651,7 +705,7 @@ static void MRConn_DisconnectCallback(const redisAsyncContext *c, int status) {
 
 static MRConn *MR_NewConn(MREndpoint *ep) {
   MRConn *conn = rm_malloc(sizeof(MRConn));
-  *conn = (MRConn){.state = MRConn_Disconnected, .conn = NULL, .protocol = 0};
+  *conn = (MRConn){.state = MRConn_Disconnected, .conn = NULL, .protocol = 0, .pending = 0, .latency = 0};
   MREndpoint_Copy(&conn->ep, ep);
   return conn;
 }
@@ -674,6 +728,7 @@ static int MRConn_Connect(MRConn *conn) {
   conn->conn = c;
   conn->conn->data = conn;
   conn->state = MRConn_Connecting;
+  conn->pending = 0;
 
   redisLibuvAttach(conn->conn, uv_default_loop());
   redisAsyncSetConnectCallback(conn->conn, MRConn_ConnectCallback);
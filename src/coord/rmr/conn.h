@@ -59,8 +59,17 @@ typedef struct {
   MRConnState state;
   void *timer;
   int protocol; // 0 (undetermined), 2, or 3
+  size_t pending; // commands sent on the current context and not yet answered
+  double latency; // moving average of the reply latency, in microseconds
 } MRConn;
 
+/* The connections to a single node */
+typedef struct {
+  size_t num;
+  size_t rr;  // round robin counter
+  MRConn **conns;
+} MRConnPool;
+
 /* A pool indexes connections by the node id */
 typedef struct {
   dict *map;
@@ -76,6 +85,10 @@ MRConn *MRConn_Get(MRConnManager *mgr, const char *id);
 
 int MRConn_SendCommand(MRConn *c, MRCommand *cmd, redisCallbackFn *fn, void *privdata);
 
+/* Get the expected cost of sending a command to a node, based on its in-flight commands and its
+ * reply latency. Returns a negative value if the node has no connected connection */
+double MRConnManager_NodeCost(MRConnManager *mgr, const char *id);
+
 /* Add a node to the connection manager */
 int MRConnManager_Add(MRConnManager *m, const char *id, MREndpoint *ep, int connect);
 
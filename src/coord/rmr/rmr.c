@@ -248,6 +248,7 @@ int MR_Fanout(struct MRCtx *mrctx, MRReduceFunc reducer, MRCommand cmd, bool blo
   }
   mrctx->reducer = reducer;
   mrctx->cmd = cmd;
+  MRCommand_Format(&mrctx->cmd); // serialize on the calling thread, off the I/O thread
   RQ_Push(rq_g, uvFanoutRequest, mrctx);
   return REDIS_OK;
 }
@@ -255,6 +256,7 @@ int MR_Fanout(struct MRCtx *mrctx, MRReduceFunc reducer, MRCommand cmd, bool blo
 int MR_MapSingle(struct MRCtx *ctx, MRReduceFunc reducer, MRCommand cmd) {
   ctx->reducer = reducer;
   ctx->cmd = cmd;
+  MRCommand_Format(&ctx->cmd); // serialize on the calling thread, off the I/O thread
   RS_ASSERT(!ctx->bc);
   ctx->bc = RedisModule_BlockClient(ctx->redisCtx, unblockHandler, timeoutHandler, freePrivDataCB, 0); // timeout_g);
   RedisModule_BlockedClientMeasureTimeStart(ctx->bc);
@@ -641,6 +643,9 @@ MRIterator *MR_Iterate(const MRCommand *cmd, MRIteratorCallback cb) {
     .cmd = MRCommand_Copy(cmd),
     .it = ret,
   };
+  // Serialize the command here rather than on the I/O thread. The per-shard copies made when the
+  // iterator starts share this serialization, so the I/O thread only has to write it out
+  MRCommand_Format(&ret->cbxs->cmd);
 
   RQ_Push(rq_g, iterStartCb, ret);
   return ret;
@@ -685,8 +690,7 @@ void MRIterator_Release(MRIterator *it) {
         RS_DEBUG_LOG_FMT("changing command from %s to DEL for shard: %d", cmd->strs[1], cmd->targetSlot);
         RS_LOG_ASSERT_FMT(cmd->rootCommand != C_DEL, "DEL command should be sent only once to a shard. pending = %d", it->ctx.pending);
         cmd->rootCommand = C_DEL;
-        strcpy(cmd->strs[1], "DEL");
-        cmd->lens[1] = 3;
+        MRCommand_ReplaceArg(cmd, 1, "DEL", 3);
       }
     }
     // Take a reference to the iterator for the next batch of commands.
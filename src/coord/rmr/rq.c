@@ -187,7 +187,9 @@ void RQ_Push(MRWorkQueue *q, MRQueueCallback cb, void *privdata) {
   uv_async_send(&q->async);
 }
 
-static struct queueItem *rqPop(MRWorkQueue *q) {
+/* Pop as many requests as the queue's pending limit allows, with a single lock acquisition.
+ * Returns the popped requests as a linked list */
+static struct queueItem *rqPopBatch(MRWorkQueue *q) {
   uv_mutex_lock(&q->lock);
 
   if (q->head == NULL) {
@@ -216,14 +218,20 @@ static struct queueItem *rqPop(MRWorkQueue *q) {
     q->pendingInfo.warnSize = 0;
   }
 
-  struct queueItem *r = q->head;
-  q->head = r->next;
-  if (!q->head) q->tail = NULL;
+  struct queueItem *first = q->head, *last = first;
   q->sz--;
   q->pending++;
+  while (last->next && q->pending < q->maxPending) {
+    last = last->next;
+    q->sz--;
+    q->pending++;
+  }
+  q->head = last->next;
+  if (!q->head) q->tail = NULL;
+  last->next = NULL;
 
   uv_mutex_unlock(&q->lock);
-  return r;
+  return first;
 }
 
 void RQ_Done(MRWorkQueue *q) {
@@ -232,16 +240,27 @@ void RQ_Done(MRWorkQueue *q) {
   uv_mutex_unlock(&q->lock);
 }
 
+/* Pop a batch of requests and run them. Returns the number of requests run */
+static size_t rqRunBatch(MRWorkQueue *q) {
+  size_t n = 0;
+  struct queueItem *batch = rqPopBatch(q);
+  while (batch) {
+    struct queueItem *req = batch;
+    batch = req->next;
+    req->cb(req->privdata);
+    rm_free(req);
+    n++;
+  }
+  return n;
+}
+
 static void rqAsyncCb(uv_async_t *async) {
   if (!loop_th_ready) {
     array_ensure_append_1(pendingQueues, async); // try again later
     return;
   }
   MRWorkQueue *q = async->data;
-  struct queueItem *req;
-  while (NULL != (req = rqPop(q))) {
-    req->cb(req->privdata);
-    rm_free(req);
+  while (rqRunBatch(q)) {
   }
 }
 
@@ -267,6 +286,10 @@ void RQ_UpdateMaxPending(MRWorkQueue *q, int maxPending) {
   uv_mutex_unlock(&q->lock);
 }
 
+size_t RQ_Debug_RunBatch(MRWorkQueue *q) {
+  return rqRunBatch(q);
+}
+
 void RQ_Debug_ClearPendingTopo() {
   struct queueItem *topo = exchangePendingTopo(NULL);
   if (topo) {
@@ -26,4 +26,8 @@ struct MRClusterTopology;
 void RQ_Push_Topology(MRQueueCallback cb, struct MRClusterTopology *topo);
 
 void RQ_Debug_ClearPendingTopo();
+
+/* Run a batch of queued requests on the calling thread, as the event loop does. Returns the number
+ * of requests run. For testing only */
+size_t RQ_Debug_RunBatch(MRWorkQueue *q);
 #endif // RQ_C__
@@ -37,6 +37,7 @@ DocTable NewDocTable(size_t cap, size_t max_size) {
       .maxDocId = 0,
       .memsize = 0,
       .sortablesSize = 0,
+      .maxScore = 0,
       .maxSize = max_size,
       .dim = NewDocIdMap(),
   };
@@ -53,29 +54,107 @@ static inline int DocTable_ValidateDocId(const DocTable *t, t_docId docId) {
   return docId != 0 && docId <= t->maxDocId;
 }
 
-static RSDocumentMetadata *DocTable_GetOwn(const DocTable *t, t_docId docId) {
-  if (!DocTable_ValidateDocId(t, docId)) {
-    return NULL;
+// The capacity of the entries array of a chain that grows past a single document
+#define DMDCHAIN_MIN_CAP 4
+
+static inline t_docId DMDChain_Id(const DMDChain *chain, uint32_t i) {
+  return chain->size == 1 ? chain->dmd->id : chain->entries[i].id;
+}
+
+/* The position of `docId` in the sorted entries of a chain, or of the first entry with a greater
+ * id if it is not there */
+static uint32_t DMDChain_Search(const DMDChain *chain, t_docId docId) {
+  if (chain->size == 1) {
+    return chain->dmd->id < docId;
+  }
+  uint32_t lo = 0, hi = chain->size;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (chain->entries[mid].id < docId) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
   }
+  return lo;
+}
+
+static RSDocumentMetadata *DocTable_Find(const DocTable *t, t_docId docId) {
   uint32_t bucketIndex = DocTable_GetBucket(t, docId);
   if (bucketIndex >= t->cap) {
     return NULL;
   }
-  // While we iterate over the chain, we have locked the index spec (R/W), so we either a writer alone or
-  // multiple readers. In any case, we can safely iterate over the chain without a lock and
-  // increment the ref count of the document metadata when we find it.
-  DMDChain *dmdChain = &t->buckets[bucketIndex];
-  DLLIST2_FOREACH(it, &dmdChain->lroot) {
-    RSDocumentMetadata *dmd = DLLIST2_ITEM(it, RSDocumentMetadata, llnode);
+  const DMDChain *chain = &t->buckets[bucketIndex];
+  uint32_t pos = DMDChain_Search(chain, docId);
+  if (pos == chain->size || DMDChain_Id(chain, pos) != docId) {
+    return NULL;
+  }
+  return DMDChain_Get(chain, pos);
+}
 
-    if (dmd->id == docId) {
-      if (dmd->flags & Document_Deleted) {
-        return NULL;
-      }
-      return dmd;
-    }
+/* Add a document to its chain. A chain that grows past a single document moves it to an entries
+ * array, whose capacity is doubled whenever it is full */
+static void DMDChain_Insert(DocTable *t, DMDChain *chain, RSDocumentMetadata *dmd) {
+  if (!chain->size) {
+    chain->dmd = dmd;
+    chain->size = 1;
+    return;
+  }
+  // New documents take the highest id, so this is an append unless the table is being loaded
+  uint32_t pos = DMDChain_Id(chain, chain->size - 1) > dmd->id ? DMDChain_Search(chain, dmd->id)
+                                                                : chain->size;
+  if (chain->size == 1) {
+    RSDocumentMetadata *first = chain->dmd;
+    chain->cap = DMDCHAIN_MIN_CAP;
+    chain->entries = rm_malloc(chain->cap * sizeof(DMDEntry));
+    chain->entries[0] = (DMDEntry){.id = first->id, .dmd = first};
+    t->memsize += chain->cap * sizeof(DMDEntry);
+  } else if (chain->size == chain->cap) {
+    chain->entries = rm_realloc(chain->entries, 2 * chain->cap * sizeof(DMDEntry));
+    t->memsize += chain->cap * sizeof(DMDEntry);
+    chain->cap *= 2;
+  }
+  memmove(chain->entries + pos + 1, chain->entries + pos, (chain->size - pos) * sizeof(DMDEntry));
+  chain->entries[pos] = (DMDEntry){.id = dmd->id, .dmd = dmd};
+  chain->size++;
+}
+
+/* Remove the document at `pos` from its chain. The capacity is halved once the chain is down to a
+ * quarter of it, and a chain left with a single document keeps it inline again, so a bucket doesn't
+ * keep memory for the documents it used to hold */
+static void DMDChain_Remove(DocTable *t, DMDChain *chain, uint32_t pos) {
+  if (chain->size == 1) {
+    chain->dmd = NULL;
+    chain->size = 0;
+    return;
+  }
+  memmove(chain->entries + pos, chain->entries + pos + 1,
+          (chain->size - pos - 1) * sizeof(DMDEntry));
+  if (--chain->size == 1) {
+    RSDocumentMetadata *last = chain->entries[0].dmd;
+    rm_free(chain->entries);
+    t->memsize -= chain->cap * sizeof(DMDEntry);
+    chain->dmd = last;
+    chain->cap = 0;
+  } else if (chain->cap > DMDCHAIN_MIN_CAP && chain->size <= chain->cap / 4) {
+    chain->cap /= 2;
+    chain->entries = rm_realloc(chain->entries, chain->cap * sizeof(DMDEntry));
+    t->memsize -= chain->cap * sizeof(DMDEntry);
   }
-  return NULL;
+}
+
+static RSDocumentMetadata *DocTable_GetOwn(const DocTable *t, t_docId docId) {
+  if (!DocTable_ValidateDocId(t, docId)) {
+    return NULL;
+  }
+  // While we search the chain, we have locked the index spec (R/W), so we either a writer alone or
+  // multiple readers. In any case, we can safely search the chain without a lock and
+  // increment the ref count of the document metadata when we find it.
+  RSDocumentMetadata *dmd = DocTable_Find(t, docId);
+  if (!dmd || (dmd->flags & Document_Deleted)) {
+    return NULL;
+  }
+  return dmd;
 }
 
 const RSDocumentMetadata *DocTable_Borrow(const DocTable *t, t_docId docId) {
@@ -90,21 +169,8 @@ bool DocTable_Exists(const DocTable *t, t_docId docId) {
   if (!docId || docId > t->maxDocId) {
     return 0;
   }
-  uint32_t ix = DocTable_GetBucket(t, docId);
-  if (ix >= t->cap) {
-    return 0;
-  }
-  const DMDChain *chain = t->buckets + ix;
-  if (chain == NULL) {
-    return 0;
-  }
-  DLLIST2_FOREACH(it, &chain->lroot) {
-    const RSDocumentMetadata *md = DLLIST2_ITEM(it, RSDocumentMetadata, llnode);
-    if (md->id == docId) {
-      return !(md->flags & Document_Deleted);
-    }
-  }
-  return 0;
+  const RSDocumentMetadata *md = DocTable_Find(t, docId);
+  return md && !(md->flags & Document_Deleted);
 }
 
 const RSDocumentMetadata *DocTable_BorrowByKeyR(const DocTable *t, RedisModuleString *s) {
@@ -130,16 +196,13 @@ static inline void DocTable_Set(DocTable *t, t_docId docId, RSDocumentMetadata *
     t->buckets = rm_realloc(t->buckets, t->cap * sizeof(DMDChain));
     t->memsize += (t->cap - oldcap) * sizeof(DMDChain);
 
-    // We clear new extra allocation to Null all list pointers
+    // We clear new extra allocation to have empty chains
     size_t memsetSize = (t->cap - oldcap) * sizeof(DMDChain);
     memset(&t->buckets[oldcap], 0, memsetSize);
   }
 
-  DMDChain *chain = &t->buckets[bucket];
   dmd->ref_count = 1; // Index reference
-
-  // Adding the dmd to the chain
-  dllist2_append(&chain->lroot, &dmd->llnode);
+  DMDChain_Insert(t, &t->buckets[bucket], dmd);
 }
 
 /** Get the docId of a key if it exists in the table, or 0 if it doesn't */
@@ -269,6 +332,7 @@ RSDocumentMetadata *DocTable_Put(DocTable *t, const char *s, size_t n, double sc
   sds keyPtr = sdsnewlen(s, n);
   dmd->keyPtr = keyPtr;
   dmd->score = score;
+  t->maxScore = MAX(t->maxScore, score);
   dmd->flags = flags;
   dmd->maxFreq = 1;
   dmd->id = docId;
@@ -340,14 +404,11 @@ void DMD_Free(const RSDocumentMetadata *cmd) {
 void DocTable_Free(DocTable *t) {
   for (int i = 0; i < t->cap; ++i) {
     DMDChain *chain = &t->buckets[i];
-    if (DLLIST2_IS_EMPTY(&chain->lroot)) {
-      continue;
+    for (uint32_t j = 0; j < chain->size; ++j) {
+      DMD_Return(DMDChain_Get(chain, j));
     }
-    DLLIST2_node *nn = chain->lroot.head;
-    while (nn) {
-      RSDocumentMetadata *md = DLLIST2_ITEM(nn, RSDocumentMetadata, llnode);
-      nn = nn->next;
-      DMD_Return(md);
+    if (chain->size > 1) {
+      rm_free(chain->entries);
     }
   }
   rm_free(t->buckets);
@@ -355,10 +416,13 @@ void DocTable_Free(DocTable *t) {
   DocIdMap_Free(&t->dim);
 }
 
+/* Remove a document from its chain */
 static void DocTable_DmdUnchain(DocTable *t, RSDocumentMetadata *md) {
   uint32_t bucketIndex = DocTable_GetBucket(t, md->id);
   DMDChain *dmdChain = &t->buckets[bucketIndex];
-  dllist2_delete(&dmdChain->lroot, &md->llnode);
+  uint32_t pos = DMDChain_Search(dmdChain, md->id);
+  RS_LOG_ASSERT(pos < dmdChain->size && DMDChain_Get(dmdChain, pos) == md, "Document is not in its chain");
+  DMDChain_Remove(t, dmdChain, pos);
 }
 
 int DocTable_Delete(DocTable *t, const char *s, size_t n) {
@@ -520,6 +584,7 @@ void DocTable_LegacyRdbLoad(DocTable *t, RedisModuleIO *rdb, int encver) {
       DocIdMap_Put(&t->dim, dmd->keyPtr, sdslen(dmd->keyPtr), dmd->id);
       DocTable_Set(t, dmd->id, dmd);
       t->memsize += sizeof(RSDocumentMetadata) + len;
+      t->maxScore = MAX(t->maxScore, dmd->score);
     }
   }
   t->size -= deletedElements;
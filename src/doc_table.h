@@ -57,14 +57,34 @@ void DocIdMap_Free(DocIdMap *m);
  * new
  * incremental ids to inserted keys.
  *
+ * Doc ids are hashed into at most `maxSize` buckets. A bucket holding a single document keeps it
+ * inline. Larger buckets keep their documents in an array sorted by id, which grows and shrinks
+ * geometrically, so a lookup in a table with more documents than buckets is a binary search rather
+ * than a walk over a chain.
+ *
  * NOTE: Currently there is no deduplication on the table so we do not prevent dual insertion of
  * the
  * same key. This may result in document duplication in results  */
 
 typedef struct {
-  DLLIST2 lroot;
+  t_docId id;
+  RSDocumentMetadata *dmd;
+} DMDEntry;
+
+typedef struct {
+  union {
+    RSDocumentMetadata *dmd;  // the document of a chain of size 1
+    DMDEntry *entries;        // sorted by id, for chains of more documents
+  };
+  uint32_t size;
+  uint32_t cap;               // capacity of `entries`
 } DMDChain;
 
+/* The i-th document of a chain */
+static inline RSDocumentMetadata *DMDChain_Get(const DMDChain *chain, uint32_t i) {
+  return chain->size == 1 ? chain->dmd : chain->entries[i].dmd;
+}
+
 typedef struct {
   size_t size;
   t_docId maxSize;          // the maximum size this table is allowed to grow to
@@ -72,6 +92,7 @@ typedef struct {
   size_t cap;               // current capacity of buckets
   size_t memsize;           // total memory size occupied by the table
   size_t sortablesSize;     // total memory size occupied by the sortables
+  double maxScore;          // the highest score a document of the table was given. Never lowered
 
   DMDChain *buckets;
   DocIdMap dim;             // Mapping between document name to internal id
@@ -81,11 +102,8 @@ typedef struct {
 #define DOCTABLE_FOREACH(dt, code)                                           \
   for (size_t i = 0; i < dt->cap; ++i) {                                     \
     DMDChain *chain = &dt->buckets[i];                                       \
-    if (DLLIST2_IS_EMPTY(&chain->lroot)) {                                   \
-      continue;                                                              \
-    }                                                                        \
-    DLLIST2_FOREACH(it, &chain->lroot) {                                     \
-      RSDocumentMetadata *dmd = DLLIST_ITEM(it, RSDocumentMetadata, llnode); \
+    for (uint32_t j = 0; j < chain->size; ++j) {                             \
+      RSDocumentMetadata *dmd = DMDChain_Get(chain, j);                      \
       code;                                                                  \
     }                                                                        \
   }
@@ -925,6 +925,7 @@ static void AddDocumentCtx_UpdateNoIndex(RSAddDocumentCtx *aCtx, RedisSearchCtx
 
   // Update the score
   md->score = doc->score;
+  sctx->spec->docs.maxScore = MAX(sctx->spec->docs.maxScore, md->score);
   // Set the payload if needed
   if (doc->payload) {
     DocTable_SetPayload(&sctx->spec->docs, md, doc->payload, doc->payloadSize);
@@ -175,6 +175,58 @@ typedef struct {
   uint32_t _pad;   // Uninitialized reads, otherwise
 } MSG_DeletedBlock;
 
+/**
+ * Merge `blk`, the block at position `oldix` of the index, into the last block kept in `blocklist`
+ * (which was at position `lastKeptOldix`), if both fit in a single block. Only blocks touched by the
+ * current repair are merged, either `blk` itself (`repaired`) or the kept block, so untouched parts of
+ * the index are not rewritten.
+ * The merged block is sent as a repair of the kept block, and `blk` as a deleted block, so the main
+ * process frees the original buffers of both.
+ */
+static bool FGC_childMergeBlock(IndexBlock *blocklist, MSG_RepairedBlock **fixed,
+                                MSG_DeletedBlock **deleted, MSG_IndexInfo *ixmsg, IndexFlags flags,
+                                const IndexBlock *blk, void *bufptr, size_t oldix,
+                                size_t lastKeptOldix, bool repaired) {
+  const size_t newix = array_len(blocklist) - 1;
+  MSG_RepairedBlock *fixmsg = array_len(*fixed) ? &array_tail(*fixed) : NULL;
+  const bool lastKeptRepaired = fixmsg && fixmsg->newix == newix;
+  if (!repaired && !lastKeptRepaired) {
+    return false;
+  }
+
+  IndexBlock *lastKept = blocklist + newix;
+  const size_t bytesBefore = IndexBlock_DataCap(lastKept) + IndexBlock_DataCap(blk) + sizeof(IndexBlock);
+  if (!IndexBlock_Merge(lastKept, blk, flags)) {
+    return false;
+  }
+  const size_t bytesAfter = IndexBlock_DataCap(lastKept);
+  if (bytesBefore > bytesAfter) {
+    ixmsg->nbytesCollected += bytesBefore - bytesAfter;
+  } else {
+    ixmsg->nbytesAdded += bytesAfter - bytesBefore;
+  }
+
+  if (!lastKeptRepaired) {
+    fixmsg = array_ensure_tail(fixed, MSG_RepairedBlock);
+    fixmsg->newix = newix;
+    fixmsg->oldix = lastKeptOldix;
+    ixmsg->nblocksRepaired++;
+  }
+  fixmsg->blk = *lastKept;
+
+  MSG_DeletedBlock *delmsg = array_ensure_tail(deleted, MSG_DeletedBlock);
+  *delmsg = (MSG_DeletedBlock){.ptr = bufptr, .oldix = oldix};
+  return true;
+}
+
+/**
+ * Whether a document deleted since the last cycle may have entries in [first, last].
+ * The child sorts `gc->deletedIds` before scanning the indexes.
+ */
+static bool FGC_childHasDeletedInRange(const ForkGC *gc, t_docId first, t_docId last) {
+  return gc->repairAll || GC_HasDeletedInRange(gc->deletedIds, first, last);
+}
+
 /**
  * headerCallback and hdrarg are invoked before the inverted index is sent, only
  * if the inverted index was repaired.
@@ -185,10 +237,18 @@ typedef struct {
  * repaired block.
  * RepairCallback and its argument are passed directly to IndexBlock_Repair; see
  * that function for more details.
+ * Blocks left underfilled by the repair are merged into the block preceding them (see
+ * FGC_childMergeBlock).
+ * Blocks that cannot hold a document deleted since the last cycle are not decoded. When a
+ * RepairCallback is given it must see every remaining entry, so only whole indexes are skipped.
  */
 static bool FGC_childRepairInvidx(ForkGC *gc, RedisSearchCtx *sctx, InvertedIndex *idx,
                                   void (*headerCallback)(ForkGC *, void *), void *hdrarg,
                                   IndexRepairParams *params) {
+  if (!idx->size ||
+      !FGC_childHasDeletedInRange(gc, idx->blocks[0].firstId, idx->blocks[idx->size - 1].lastId)) {
+    return false;
+  }
   MSG_RepairedBlock *fixed = array_new(MSG_RepairedBlock, 10);
   MSG_DeletedBlock *deleted = array_new(MSG_DeletedBlock, 10);
   IndexBlock *blocklist = array_new(IndexBlock, idx->size);
@@ -199,6 +259,11 @@ static bool FGC_childRepairInvidx(ForkGC *gc, RedisSearchCtx *sctx, InvertedInde
     params = &params_s;
   }
 
+  // Whether the last block kept in `blocklist` may take the entries of the blocks following it, and
+  // its position in the index
+  bool lastKeptMergeable = false;
+  size_t lastKeptOldix = 0;
+
   for (size_t i = 0; i < idx->size; ++i) {
     params->bytesCollected = 0;
     params->bytesBeforFix = 0;
@@ -212,16 +277,29 @@ static bool FGC_childRepairInvidx(ForkGC *gc, RedisSearchCtx *sctx, InvertedInde
       // The above TODO was written 5 years ago. We currently don't split blocks,
       // and it is also not clear why we care about high variations.
       array_append(blocklist, *blk);
+      lastKeptMergeable = false;
       continue;
     }
 
+    // The last block may be appended to by the main process while we are running, so it is never
+    // merged
+    const bool mergeable = lastKeptMergeable && i != idx->size - 1;
+
     // Capture the pointer address before the block is cleared; otherwise
     // the pointer might be freed! (IndexBlock_Repair rewrites blk->buf if there were repairs)
     void *bufptr = blk->buf.data;
-    size_t nrepaired = IndexBlock_Repair(blk, &sctx->spec->docs, idx->flags, params);
+    size_t nrepaired = 0;
+    if (params->RepairCallback || FGC_childHasDeletedInRange(gc, blk->firstId, blk->lastId)) {
+      nrepaired = IndexBlock_Repair(blk, &sctx->spec->docs, idx->flags, params);
+    }
     if (nrepaired == 0) {
       // unmodified block
-      array_append(blocklist, *blk);
+      if (!mergeable || !FGC_childMergeBlock(blocklist, &fixed, &deleted, &ixmsg, idx->flags, blk,
+                                             bufptr, i, lastKeptOldix, false)) {
+        array_append(blocklist, *blk);
+        lastKeptMergeable = true;
+        lastKeptOldix = i;
+      }
       continue;
     }
 
@@ -232,8 +310,11 @@ static bool FGC_childRepairInvidx(ForkGC *gc, RedisSearchCtx *sctx, InvertedInde
       MSG_DeletedBlock *delmsg = array_ensure_tail(&deleted, MSG_DeletedBlock);
       *delmsg = (MSG_DeletedBlock){.ptr = bufptr, .oldix = i};
       curr_bytesCollected += sizeof(IndexBlock);
-    } else {
+    } else if (!mergeable || !FGC_childMergeBlock(blocklist, &fixed, &deleted, &ixmsg, idx->flags,
+                                                  blk, bufptr, i, lastKeptOldix, true)) {
       array_append(blocklist, *blk);
+      lastKeptMergeable = true;
+      lastKeptOldix = i;
       MSG_RepairedBlock *fixmsg = array_ensure_tail(&fixed, MSG_RepairedBlock);
       fixmsg->newix = array_len(blocklist) - 1;
       fixmsg->oldix = i;
@@ -537,6 +618,9 @@ static void FGC_childScanIndexes(ForkGC *gc, IndexSpec *spec) {
   const char* indexName = IndexSpec_FormatName(spec, RSGlobalConfig.hideUserDataFromLog);
   RedisModule_Log(sctx.redisCtx, "debug", "ForkGC in index %s - child scanning indexes start", indexName);
   FGC_setProgress(gc, 0);
+  if (!gc->repairAll) {
+    GC_SortDeletedIds(gc->deletedIds);
+  }
   FGC_childCollectTerms(gc, &sctx);
   FGC_setProgress(gc, 0.2);
   FGC_childCollectNumeric(gc, &sctx);
@@ -603,7 +687,7 @@ FGC_recvInvIdx(ForkGC *gc, InvIdxBuffers *bufs, MSG_IndexInfo *info) {
 error:
   rm_free(bufs->newBlocklist);
   for (size_t ii = 0; ii < nblocksRecvd; ++ii) {
-    rm_free(bufs->changedBlocks[ii].blk.buf.data);
+    indexBlock_Free(&bufs->changedBlocks[ii].blk);
   }
   rm_free(bufs->changedBlocks);
   memset(bufs, 0, sizeof(*bufs));
@@ -617,7 +701,7 @@ static void freeInvIdx(InvIdxBuffers *bufs, MSG_IndexInfo *info) {
   if (bufs->changedBlocks) {
     // could be null because of pipe error
     for (size_t ii = 0; ii < info->nblocksRepaired; ++ii) {
-      rm_free(bufs->changedBlocks[ii].blk.buf.data);
+      indexBlock_Free(&bufs->changedBlocks[ii].blk);
     }
     rm_free(bufs->changedBlocks);
   }
@@ -825,6 +909,8 @@ static void applyNumIdx(ForkGC *gc, RedisSearchCtx *sctx, NumGcInfo *ninfo) {
   MSG_IndexInfo *info = &ninfo->info;
   size_t blocksSinceFork = currNode->range->entries->size - info->nblocksOrig; // record before applying changes
   FGC_applyInvertedIndex(gc, idxbufs, info, currNode->range->entries);
+  // The value ordered copy is stale now. Its memory is collected along with the repaired blocks'
+  info->nbytesCollected += NumericRange_DropByValue(currNode->range);
   currNode->range->entries->numEntries -= info->nentriesCollected;
   currNode->range->invertedIndexSize += info->nbytesAdded;
   currNode->range->invertedIndexSize -= info->nbytesCollected;
@@ -1353,6 +1439,13 @@ static int periodicCb(void *privdata) {
   // upon deleting a document (this is the actual number of documents to be cleaned by the fork).
   size_t num_docs_to_clean = gc->deletedDocsFromLastRun;
   gc->deletedDocsFromLastRun = 0;
+  // The child keeps its own copy of the deleted ids; the parent starts tracking the next cycle's
+  arrayof(t_docId) cleanedIds = NULL;
+  if (cpid != 0) {
+    cleanedIds = gc->deletedIds;
+    gc->deletedIds = NULL;
+    gc->repairAll = false;
+  }
 
   gc->retryInterval.tv_sec = RSGlobalConfig.gcConfigParams.forkGc.forkGcRunIntervalSec;
 
@@ -1381,9 +1474,14 @@ static int periodicCb(void *privdata) {
 
     gc->execState = FGC_STATE_APPLYING;
     gc->cleanNumericEmptyNodes = RSGlobalConfig.gcConfigParams.forkGc.forkGCCleanNumericEmptyNodes;
-    if (FGC_parentHandleFromChild(gc) == FGC_SPEC_DELETED) {
+    const uint64_t missedBefore = gc->stats.gcBlocksDenied + gc->stats.gcNumericNodesMissed;
+    FGCError status = FGC_parentHandleFromChild(gc);
+    if (status == FGC_SPEC_DELETED) {
       gcrv = 0;
     }
+    // Repairs that were not applied are only found again by a full scan
+    const bool missedRepairs = status != FGC_DONE ||
+                               gc->stats.gcBlocksDenied + gc->stats.gcNumericNodesMissed != missedBefore;
     close(gc->pipe_read_fd);
     // give the child some time to exit gracefully
     for (int attempt = 0; attempt < GC_WAIT_ATTEMPTS; ++attempt) {
@@ -1396,7 +1494,11 @@ static int periodicCb(void *privdata) {
     // out of file descriptor
     RedisModule_ThreadSafeContextLock(ctx);
     RedisModule_KillForkChild(cpid);
+    if (missedRepairs) {
+      gc->repairAll = true;
+    }
     RedisModule_ThreadSafeContextUnlock(ctx);
+    array_free(cleanedIds);
 
     if (gcrv) {
       gcrv = VecSim_CallTieredIndexesGC(gc->index);
@@ -1454,42 +1556,34 @@ void FGC_Apply(ForkGC *gc) NO_TSAN_CHECK {
 static void onTerminateCb(void *privdata) {
   ForkGC *gc = privdata;
   IndexsGlobalStats_UpdateLogicallyDeleted(-gc->deletedDocsFromLastRun);
+  array_free(gc->deletedIds);
   WeakRef_Release(gc->index);
   RedisModule_FreeThreadSafeContext(gc->ctx);
   rm_free(gc);
 }
 
 static void statsCb(RedisModule_Reply *reply, void *gcCtx) {
-#define REPLY_KVNUM(k, v) RedisModule_ReplyKV_Double(reply, (k), (v))
   ForkGC *gc = gcCtx;
   if (!gc) return;
-  REPLY_KVNUM("bytes_collected", gc->stats.totalCollected);
-  REPLY_KVNUM("total_ms_run", gc->stats.totalMSRun);
-  REPLY_KVNUM("total_cycles", gc->stats.numCycles);
-  REPLY_KVNUM("average_cycle_time_ms", (double)gc->stats.totalMSRun / gc->stats.numCycles);
-  REPLY_KVNUM("last_run_time_ms", (double)gc->stats.lastRunTimeMs);
-  REPLY_KVNUM("gc_numeric_trees_missed", (double)gc->stats.gcNumericNodesMissed);
-  REPLY_KVNUM("gc_blocks_denied", (double)gc->stats.gcBlocksDenied);
+  GCStats_Render(&gc->stats, reply);
 }
 
 #ifdef FTINFO_FOR_INFO_MODULES
 static void statsForInfoCb(RedisModuleInfoCtx *ctx, void *gcCtx) {
   ForkGC *gc = gcCtx;
-  RedisModule_InfoBeginDictField(ctx, "gc_stats");
-  RedisModule_InfoAddFieldLongLong(ctx, "bytes_collected", gc->stats.totalCollected);
-  RedisModule_InfoAddFieldLongLong(ctx, "total_ms_run", gc->stats.totalMSRun);
-  RedisModule_InfoAddFieldLongLong(ctx, "total_cycles", gc->stats.numCycles);
-  RedisModule_InfoAddFieldDouble(ctx, "average_cycle_time_ms", (double)gc->stats.totalMSRun / gc->stats.numCycles);
-  RedisModule_InfoAddFieldDouble(ctx, "last_run_time_ms", (double)gc->stats.lastRunTimeMs);
-  RedisModule_InfoAddFieldDouble(ctx, "gc_numeric_trees_missed", (double)gc->stats.gcNumericNodesMissed);
-  RedisModule_InfoAddFieldDouble(ctx, "gc_blocks_denied", (double)gc->stats.gcBlocksDenied);
-  RedisModule_InfoEndDictField(ctx);
+  GCStats_RenderForInfo(&gc->stats, ctx);
 }
 #endif
 
-static void deleteCb(void *ctx) {
+static const GCStats *getStatsCb(void *ctx) {
+  ForkGC *gc = ctx;
+  return &gc->stats;
+}
+
+static void deleteCb(void *ctx, t_docId docId) {
   ForkGC *gc = ctx;
   ++gc->deletedDocsFromLastRun;
+  GC_TrackDeletedId(&gc->deletedIds, &gc->repairAll, docId);
   IndexsGlobalStats_UpdateLogicallyDeleted(1);
 }
 
@@ -1503,6 +1597,8 @@ ForkGC *FGC_New(StrongRef spec_ref, GCCallbacks *callbacks) {
   *forkGc = (ForkGC){
       .index = StrongRef_Demote(spec_ref),
       .deletedDocsFromLastRun = 0,
+      // Nothing is known about the documents removed before the first cycle
+      .repairAll = true,
   };
   forkGc->retryInterval.tv_sec = RSGlobalConfig.gcConfigParams.forkGc.forkGcRunIntervalSec;
   forkGc->retryInterval.tv_nsec = 0;
@@ -1518,6 +1614,7 @@ ForkGC *FGC_New(StrongRef spec_ref, GCCallbacks *callbacks) {
   #endif
   callbacks->getInterval = getIntervalCb;
   callbacks->onDelete = deleteCb;
+  callbacks->getStats = getStatsCb;
 
   return forkGc;
 }
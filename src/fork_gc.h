@@ -12,6 +12,8 @@
 
 #include "redismodule.h"
 #include "gc.h"
+#include "redisearch.h"
+#include "util/arr.h"
 #include "VecSim/vec_sim.h"
 #include <poll.h>
 
@@ -19,19 +21,6 @@
 extern "C" {
 #endif
 
-typedef struct {
-  // total bytes collected by the GC
-  size_t totalCollected;
-  // number of cycle ran
-  size_t numCycles;
-
-  long long totalMSRun;
-  long long lastRunTimeMs;
-
-  uint64_t gcNumericNodesMissed;
-  uint64_t gcBlocksDenied;
-} ForkGCStats;
-
 /* Internal definition of the garbage collector context (each index has one) */
 typedef struct ForkGC {
 
@@ -41,7 +30,7 @@ typedef struct ForkGC {
   RedisModuleCtx *ctx;
 
   // statistics for reporting
-  ForkGCStats stats;
+  GCStats stats;
 
   int pipe_read_fd;
   int pipe_write_fd;
@@ -52,6 +41,11 @@ typedef struct ForkGC {
 
   struct timespec retryInterval;
   volatile size_t deletedDocsFromLastRun;
+  // ids of the documents deleted since the last fork. The child only repairs the blocks that may
+  // hold one of them, unless `repairAll` is set (on the first cycle, after a cycle that did not
+  // apply all of its repairs, or once too many ids were tracked)
+  arrayof(t_docId) deletedIds;
+  bool repairAll;
 
   // current value of RSGlobalConfig.gcConfigParams.forkGc.forkGCCleanNumericEmptyNodes
   // This value is updated during the periodic callback execution.
@@ -195,6 +195,7 @@ static void ForwardIndex_HandleToken(ForwardIndex *idx, const char *tok, size_t
 
     h->len = tokLen;
     h->freq = 0;
+    h->docLen = 0;
 
     if (hasOffsets(idx)) {
       h->vw = mempool_get(idx->vvwPool);
@@ -282,7 +283,7 @@ size_t InvertedIndex_WriteForwardIndexEntry(InvertedIndex *idx, IndexEncoder enc
     rec.data.term.offsets.data = (char *) VVW_GetByteData(ent->vw);
     rec.data.term.offsets.len = VVW_GetByteLength(ent->vw);
   }
-  return InvertedIndex_WriteEntryGeneric(idx, encoder, ent->docId, &rec);
+  return InvertedIndex_WriteEntryWithDocLen(idx, encoder, ent->docId, &rec, ent->docLen);
 }
 
 ForwardIndexEntry *ForwardIndex_Find(ForwardIndex *i, const char *s, size_t n, uint32_t hash) {
@@ -28,6 +28,7 @@ typedef struct ForwardIndexEntry {
 
   uint32_t freq;
   t_fieldMask fieldMask;
+  uint32_t docLen;  // the length of the document (see `RSDocumentMetadata.len`), 0 if unknown
 
   const char *term;
   uint32_t len;
@@ -8,10 +8,12 @@
 */
 #include <pthread.h>
 #include <assert.h>
+#include <stdlib.h>
 #include <unistd.h>
 
 #include "gc.h"
 #include "fork_gc.h"
+#include "thread_gc.h"
 #include "config.h"
 #include "redismodule.h"
 #include "rmalloc.h"
@@ -37,10 +39,14 @@ static GCDebugTask *GCDebugTaskCreate(GCContext *gc, RedisModuleBlockedClient* b
 
 GCContext* GCContext_CreateGC(StrongRef spec_ref, uint32_t gcPolicy) {
   GCContext* ret = rm_calloc(1, sizeof(GCContext));
+  ret->policy = gcPolicy;
   switch (gcPolicy) {
     case GCPolicy_Fork:
       ret->gcCtx = FGC_New(spec_ref, &ret->callbacks);
       break;
+    case GCPolicy_Thread:
+      ret->gcCtx = TGC_New(spec_ref, &ret->callbacks);
+      break;
   }
   return ret;
 }
@@ -52,7 +58,9 @@ static long long getNextPeriod(GCContext* gc) {
   long long ms = interval.tv_sec * 1000 + interval.tv_nsec / 1000000;  // convert to millisecond
 
   // add randomness to avoid congestion by multiple GCs from different shards
-  ms += (rand() % interval.tv_sec) * 1000;
+  if (interval.tv_sec) {
+    ms += (rand() % interval.tv_sec) * 1000;
+  }
 
   return ms;
 }
@@ -94,6 +102,10 @@ static void debugTaskCallback(void* data) {
   RedisModuleBlockedClient* bc = task->bClient;
 
   int ret = gc->callbacks.periodicCallback(gc->gcCtx);
+  // A forced run completes the whole cycle
+  while (ret && gc->callbacks.inCycle && gc->callbacks.inCycle(gc->gcCtx)) {
+    ret = gc->callbacks.periodicCallback(gc->gcCtx);
+  }
 
   // if GC was invoke by debug command, we release the client
   // and terminate without rescheduling the task again.
@@ -138,15 +150,45 @@ void GCContext_RenderStats(GCContext* gc, RedisModule_Reply* reply) {
   gc->callbacks.renderStats(reply, gc->gcCtx);
 }
 
+const GCStats* GCContext_GetStats(GCContext* gc) {
+  return gc->callbacks.getStats(gc->gcCtx);
+}
+
+void GCStats_Render(const GCStats* stats, RedisModule_Reply* reply) {
+#define REPLY_KVNUM(k, v) RedisModule_ReplyKV_Double(reply, (k), (v))
+  REPLY_KVNUM("bytes_collected", stats->totalCollected);
+  REPLY_KVNUM("total_ms_run", stats->totalMSRun);
+  REPLY_KVNUM("total_cycles", stats->numCycles);
+  REPLY_KVNUM("average_cycle_time_ms", (double)stats->totalMSRun / stats->numCycles);
+  REPLY_KVNUM("last_run_time_ms", (double)stats->lastRunTimeMs);
+  REPLY_KVNUM("gc_numeric_trees_missed", (double)stats->gcNumericNodesMissed);
+  REPLY_KVNUM("gc_blocks_denied", (double)stats->gcBlocksDenied);
+#undef REPLY_KVNUM
+}
+
+#ifdef FTINFO_FOR_INFO_MODULES
+void GCStats_RenderForInfo(const GCStats* stats, RedisModuleInfoCtx* ctx) {
+  RedisModule_InfoBeginDictField(ctx, "gc_stats");
+  RedisModule_InfoAddFieldLongLong(ctx, "bytes_collected", stats->totalCollected);
+  RedisModule_InfoAddFieldLongLong(ctx, "total_ms_run", stats->totalMSRun);
+  RedisModule_InfoAddFieldLongLong(ctx, "total_cycles", stats->numCycles);
+  RedisModule_InfoAddFieldDouble(ctx, "average_cycle_time_ms", (double)stats->totalMSRun / stats->numCycles);
+  RedisModule_InfoAddFieldDouble(ctx, "last_run_time_ms", (double)stats->lastRunTimeMs);
+  RedisModule_InfoAddFieldDouble(ctx, "gc_numeric_trees_missed", (double)stats->gcNumericNodesMissed);
+  RedisModule_InfoAddFieldDouble(ctx, "gc_blocks_denied", (double)stats->gcBlocksDenied);
+  RedisModule_InfoEndDictField(ctx);
+}
+#endif
+
 #ifdef FTINFO_FOR_INFO_MODULES
 void GCContext_RenderStatsForInfo(GCContext* gc, RedisModuleInfoCtx* ctx) {
   gc->callbacks.renderStatsForInfo(ctx, gc->gcCtx);
 }
 #endif
 
-void GCContext_OnDelete(GCContext* gc) {
+void GCContext_OnDelete(GCContext* gc, t_docId docId) {
   if (gc->callbacks.onDelete) {
-    gc->callbacks.onDelete(gc->gcCtx);
+    gc->callbacks.onDelete(gc->gcCtx, docId);
   }
 }
 
@@ -173,6 +215,43 @@ void GCContext_WaitForAllOperations(RedisModuleBlockedClient* bc) {
   redisearch_thpool_add_work(gcThreadpool_g, GCContext_UnblockClient, bc, THPOOL_PRIORITY_HIGH);
 }
 
+void GC_TrackDeletedId(arrayof(t_docId) *deletedIds, bool *repairAll, t_docId docId) {
+  if (*repairAll) {
+    return;
+  }
+  if (array_len(*deletedIds) < GC_MAX_TRACKED_DELETIONS) {
+    array_ensure_append_1(*deletedIds, docId);
+  } else {
+    array_free(*deletedIds);
+    *deletedIds = NULL;
+    *repairAll = true;
+  }
+}
+
+static int cmpDocIds(const void *a, const void *b) {
+  const t_docId x = *(const t_docId *)a, y = *(const t_docId *)b;
+  return x < y ? -1 : x > y;
+}
+
+void GC_SortDeletedIds(arrayof(t_docId) deletedIds) {
+  if (deletedIds) {
+    qsort(deletedIds, array_len(deletedIds), sizeof(*deletedIds), cmpDocIds);
+  }
+}
+
+bool GC_HasDeletedInRange(arrayof(t_docId) deletedIds, t_docId first, t_docId last) {
+  size_t lo = 0, hi = array_len(deletedIds);
+  while (lo < hi) {
+    const size_t mid = lo + (hi - lo) / 2;
+    if (deletedIds[mid] < first) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo < array_len(deletedIds) && deletedIds[lo] <= last;
+}
+
 void GC_ThreadPoolStart() {
   if (gcThreadpool_g == NULL) {
     gcThreadpool_g = redisearch_thpool_create(GC_THREAD_POOL_SIZE, DEFAULT_HIGH_PRIORITY_BIAS_THRESHOLD, LogCallback, "gc");
@@ -11,8 +11,10 @@
 #define SRC_GC_H_
 
 #include "reply.h"
+#include "redisearch.h"
 
 #include "redismodule.h"
+#include "util/arr.h"
 #include "util/dllist.h"
 #include "util/references.h"
 #include <time.h>
@@ -22,18 +24,39 @@ extern "C" {
 #endif
 
 #define GC_THREAD_POOL_SIZE 1
+// Maximal number of deleted document ids tracked between two cycles. Past it, the next cycle
+// repairs every block instead
+#define GC_MAX_TRACKED_DELETIONS (1 << 20)
+
+typedef struct GCStats {
+  // total bytes collected by the GC
+  size_t totalCollected;
+  // number of cycle ran
+  size_t numCycles;
+
+  long long totalMSRun;
+  long long lastRunTimeMs;
+
+  uint64_t gcNumericNodesMissed;
+  uint64_t gcBlocksDenied;
+} GCStats;
 
 typedef struct GCCallbacks {
   int  (*periodicCallback)(void* gcCtx);
   void (*renderStats)(RedisModule_Reply* reply, void* gc);
   void (*renderStatsForInfo)(RedisModuleInfoCtx* ctx, void* gc);
-  void (*onDelete)(void* ctx);
+  void (*onDelete)(void* ctx, t_docId docId);
   void (*onTerm)(void* ctx);
   struct timespec (*getInterval)(void* ctx);
+  const GCStats* (*getStats)(void* ctx);
+  // Optional. Whether a cycle is still in progress, for policies that take a cycle over several
+  // periodic calls
+  bool (*inCycle)(void* ctx);
 } GCCallbacks;
 
 typedef struct GCContext {
   void* gcCtx;
+  uint32_t policy;
   RedisModuleTimerID timerID; // Guarded by the GIL
   GCCallbacks callbacks;
 } GCContext;
@@ -48,11 +71,26 @@ void GCContext_RenderStats(GCContext* gc, RedisModule_Reply* ctx);
 #ifdef FTINFO_FOR_INFO_MODULES
 void GCContext_RenderStatsForInfo(GCContext* gc, RedisModuleInfoCtx* ctx);
 #endif
-void GCContext_OnDelete(GCContext* gc);
+void GCContext_OnDelete(GCContext* gc, t_docId docId);
+const GCStats* GCContext_GetStats(GCContext* gc);
+// Shared renderers of the statistics, used by the renderStats callbacks of all the policies
+void GCStats_Render(const GCStats* stats, RedisModule_Reply* reply);
+#ifdef FTINFO_FOR_INFO_MODULES
+void GCStats_RenderForInfo(const GCStats* stats, RedisModuleInfoCtx* ctx);
+#endif
 void GCContext_ForceInvoke(GCContext* gc, RedisModuleBlockedClient* bc);
 void GCContext_ForceBGInvoke(GCContext* gc);
 void GCContext_WaitForAllOperations(RedisModuleBlockedClient* bc);
 
+/* Deleted document ids, shared by the policies. A cycle only repairs the blocks that may hold a
+ * document deleted before it started, unless `repairAll` is set */
+// Track a deleted id. Once too many are tracked they are dropped, and `*repairAll` is set
+void GC_TrackDeletedId(arrayof(t_docId) *deletedIds, bool *repairAll, t_docId docId);
+// Sort the tracked ids, for GC_HasDeletedInRange
+void GC_SortDeletedIds(arrayof(t_docId) deletedIds);
+// Whether any of the sorted ids is in [first, last]
+bool GC_HasDeletedInRange(arrayof(t_docId) deletedIds, t_docId first, t_docId last);
+
 void GC_ThreadPoolStart();
 void GC_ThreadPoolDestroy();
 
@@ -517,6 +517,7 @@ IndexIterator *NewHybridVectorIterator(HybridIteratorParams hParams, QueryError
   ri->Rewind = HR_Rewind;
   ri->HasNext = HR_HasNext;
   ri->SkipTo = NULL; // As long as we return results by score (unsorted by id), this has no meaning.
+  ri->ReadBatch = NULL;
   if (hi->searchMode == VECSIM_STANDARD_KNN) {
     ri->Read = HR_ReadKnnUnsorted;
     ri->current = NewMetricResult();
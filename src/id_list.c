@@ -10,6 +10,9 @@
 #include "index_iterator.h"
 #include "rmalloc.h"
 
+#include <string.h>
+#include <sys/param.h>
+
 typedef struct {
   IndexIterator base;
   t_docId *docIds;
@@ -48,6 +51,25 @@ int IL_Read(void *ctx, RSIndexResult **r) {
   return INDEXREAD_OK;
 }
 
+int IL_ReadBatch(void *ctx, t_docId *out, size_t cap, size_t *n) {
+  IdListIterator *it = ctx;
+  size_t count = 0;
+  if (!isEof(it) && it->offset < it->size) {
+    count = MIN(cap, it->size - it->offset);
+    memcpy(out, it->docIds + it->offset, count * sizeof(*out));
+    it->offset += count;
+    if (count) {
+      it->lastDocId = it->base.current->docId = out[count - 1];
+    }
+  }
+  *n = count;
+  if (count < cap) {
+    setEof(it, 1);
+    return INDEXREAD_EOF;
+  }
+  return INDEXREAD_OK;
+}
+
 void IL_Abort(void *ctx) {
   ((IdListIterator *)ctx)->base.isValid = 0;
 }
@@ -146,6 +168,7 @@ IndexIterator *NewIdListIterator(t_docId *ids, t_offset num, double weight) {
   ret->LastDocId = IL_LastDocId;
   ret->Len = IL_Len;
   ret->Read = IL_Read;
+  ret->ReadBatch = IL_ReadBatch;
   ret->SkipTo = IL_SkipTo;
   ret->Abort = IL_Abort;
   ret->Rewind = IL_Rewind;
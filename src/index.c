@@ -29,6 +29,7 @@ static int UI_SkipToHigh(void *ctx, t_docId docId, RSIndexResult **hit);
 static inline int UI_ReadUnsorted(void *ctx, RSIndexResult **hit);
 static int UI_ReadSorted(void *ctx, RSIndexResult **hit);
 static int UI_ReadSortedHigh(void *ctx, RSIndexResult **hit);
+static int UI_ReadBatch_Bitmap(void *ctx, t_docId *out, size_t cap, size_t *n);
 static size_t UI_NumEstimated(void *ctx);
 static size_t UI_Len(void *ctx);
 
@@ -38,6 +39,21 @@ static size_t II_NumEstimated(void *ctx);
 static size_t II_Len(void *ctx);
 static t_docId II_LastDocId(void *ctx);
 
+/* The state of a union or intersect iterator at the root of a query that passes over the documents
+ * which cannot score into the top results (see `EnableBlockMaxPruning`). The score bound of the
+ * last range of ids it checked is kept, as the following reads usually fall in the same range */
+typedef struct {
+  const double *threshold;  // the lowest score of the top results, if set
+  t_docId from;             // the id from which the range was looked up
+  t_docId first;            // the first id of the range that may hold an entry of the tree
+  t_docId last;             // the last id of the range
+  double bound;             // the score bound of the documents in the range
+} BlockMaxPruning;
+
+static t_docId BlockMax_NextCandidate(IndexIterator *it, BlockMaxPruning *bm, t_docId docId);
+
+#define BLOCK_MAX_PRUNING(bm) ((bm).threshold && *(bm).threshold > 0)
+
 #define CURRENT_RECORD(ii) (ii)->base.current
 
 int cmpMinId(const void *e1, const void *e2, const void *udata) {
@@ -87,8 +103,21 @@ typedef struct {
   QueryNodeType origType;
   // original string for fuzzy or prefix unions
   const char *qstr;
+
+  BlockMaxPruning blockMax;
+
+  // Bitmap accumulator mode: the ids of all the children, drained into a bitmap of `bitmapWords`
+  // 64 bit words on the first batch read
+  uint64_t *bitmap;
+  size_t bitmapWords;
 } UnionIterator;
 
+// Unions that use a heap and are expected to yield at least this many results accumulate the ids of
+// their children in a bitmap when read in batches
+#define UNION_BITMAP_MIN_RESULTS 1024
+// The number of ids drained from a child at a time when accumulating
+#define UNION_BITMAP_DRAIN_BATCH 256
+
 static void resetMinIdHeap(UnionIterator *ui) {
   heap_t *hp = ui->heapMinId;
   heap_clear(hp);
@@ -152,6 +181,15 @@ static void UI_Rewind(void *ctx) {
   ui->minDocId = 0;
   CURRENT_RECORD(ui)->docId = 0;
 
+  if (ui->bitmap) {
+    // Leave the bitmap accumulator mode. The children are drained again on the next batch read
+    rm_free(ui->bitmap);
+    ui->bitmap = NULL;
+    ui->bitmapWords = 0;
+    ui->base.Read = UI_ReadSortedHigh;
+    ui->base.SkipTo = UI_SkipToHigh;
+  }
+
   UI_SyncIterList(ui);
 
   // rewind all child iterators
@@ -205,6 +243,11 @@ IndexIterator *NewUnionIterator(IndexIterator **its, int num, int quickExit,
     ctx->heapMinId = rm_malloc(heap_sizeof(num));
     heap_init(ctx->heapMinId, cmpMinId, NULL, num);
     resetMinIdHeap(ctx);
+    // Batches are only needed for their ids, so wide unions with many results accumulate them in a
+    // bitmap, rather than paying for a heap operation per id
+    if (ctx->nexpected >= UNION_BITMAP_MIN_RESULTS) {
+      it->ReadBatch = UI_ReadBatch_Bitmap;
+    }
   }
 
   return it;
@@ -254,6 +297,26 @@ static inline int UI_ReadSorted(void *ctx, RSIndexResult **hit) {
   int numActive = 0;
   AggregateResult_Reset(CURRENT_RECORD(ui));
 
+  // pass over the ids that cannot score into the top results
+  if (BLOCK_MAX_PRUNING(ui->blockMax)) {
+    t_docId target = BlockMax_NextCandidate(&ui->base, &ui->blockMax, ui->minDocId + 1);
+    if (!target) {
+      IITER_SET_EOF(&ui->base);
+      return INDEXREAD_EOF;
+    }
+    if (target > ui->minDocId + 1) {
+      for (unsigned i = 0; i < ui->num; i++) {
+        IndexIterator *it = ui->its[i];
+        RSIndexResult *res = NULL;
+        // exhausted children are removed below
+        if (it->minId < target && it->SkipTo(it->ctx, target, &res) != INDEXREAD_EOF && res) {
+          it->minId = res->docId;
+        }
+      }
+      ui->minDocId = target - 1;
+    }
+  }
+
   do {
 
     // find the minimal iterator
@@ -535,6 +598,123 @@ static int UI_SkipToHigh(void *ctx, t_docId docId, RSIndexResult **hit) {
   return rc;
 }
 
+static inline void UI_BitmapSet(UnionIterator *ui, t_docId docId) {
+  const size_t word = docId / 64;
+  if (word >= ui->bitmapWords) {
+    const size_t words = MAX(ui->bitmapWords * 2, word + 1);
+    ui->bitmap = rm_realloc(ui->bitmap, words * sizeof(*ui->bitmap));
+    memset(ui->bitmap + ui->bitmapWords, 0, (words - ui->bitmapWords) * sizeof(*ui->bitmap));
+    ui->bitmapWords = words;
+  }
+  ui->bitmap[word] |= 1ULL << (docId % 64);
+}
+
+// Returns the first accumulated id that is greater or equal to `docId`, or 0 if there is none
+static inline t_docId UI_BitmapNext(const UnionIterator *ui, t_docId docId) {
+  size_t word = docId / 64;
+  if (word >= ui->bitmapWords) {
+    return 0;
+  }
+  uint64_t bits = ui->bitmap[word] & (UINT64_MAX << (docId % 64));
+  while (!bits) {
+    if (++word == ui->bitmapWords) {
+      return 0;
+    }
+    bits = ui->bitmap[word];
+  }
+  return word * 64 + __builtin_ctzll(bits);
+}
+
+// SkipTo implementation for the bitmap accumulator mode. All the ids are in the bitmap, and no
+// child results are available
+static int UI_SkipTo_Bitmap(void *ctx, t_docId docId, RSIndexResult **hit) {
+  UnionIterator *ui = ctx;
+  if (!IITER_HAS_NEXT(&ui->base)) {
+    return INDEXREAD_EOF;
+  }
+  const t_docId nextId = UI_BitmapNext(ui, MAX(docId, ui->minDocId + 1));
+  if (!nextId) {
+    IITER_SET_EOF(&ui->base);
+    return INDEXREAD_EOF;
+  }
+  AggregateResult_Reset(CURRENT_RECORD(ui));
+  ui->minDocId = CURRENT_RECORD(ui)->docId = nextId;
+  ui->len++;
+  *hit = CURRENT_RECORD(ui);
+  return nextId == docId ? INDEXREAD_OK : INDEXREAD_NOTFOUND;
+}
+
+static int UI_Read_Bitmap(void *ctx, RSIndexResult **hit) {
+  UnionIterator *ui = ctx;
+  int rc = UI_SkipTo_Bitmap(ctx, ui->minDocId + 1, hit);
+  return rc == INDEXREAD_NOTFOUND ? INDEXREAD_OK : rc;
+}
+
+// Drain the remaining ids of all the children into the bitmap, and switch to reading from it.
+// Instead of a heap operation per id, each id only costs setting a bit.
+static int UI_FillBitmap(UnionIterator *ui) {
+  t_docId ids[UNION_BITMAP_DRAIN_BATCH];
+  size_t n;
+  for (uint32_t i = 0; i < ui->norig; i++) {
+    IndexIterator *it = ui->origits[i];
+    // The child may be positioned on an id that the union has not yielded yet. Ids of lagging
+    // children (in quick exit mode) that are not past the union's last id are never read.
+    if (it->minId > ui->minDocId) {
+      UI_BitmapSet(ui, it->minId);
+    }
+    int rc;
+    while ((rc = IndexIterator_ReadBatch(it, ids, UNION_BITMAP_DRAIN_BATCH, &n)) == INDEXREAD_OK) {
+      for (size_t j = 0; j < n; j++) {
+        UI_BitmapSet(ui, ids[j]);
+      }
+    }
+    for (size_t j = 0; j < n; j++) {
+      UI_BitmapSet(ui, ids[j]);
+    }
+    if (rc != INDEXREAD_EOF) {
+      return rc;
+    }
+  }
+  ui->base.Read = UI_Read_Bitmap;
+  ui->base.SkipTo = UI_SkipTo_Bitmap;
+  return INDEXREAD_OK;
+}
+
+// Batch read implementation for the bitmap accumulator mode, filling the bitmap on the first call
+static int UI_ReadBatch_Bitmap(void *ctx, t_docId *out, size_t cap, size_t *n) {
+  UnionIterator *ui = ctx;
+  *n = 0;
+  if (!IITER_HAS_NEXT(&ui->base)) {
+    return INDEXREAD_EOF;
+  }
+  if (ui->base.Read != UI_Read_Bitmap) {
+    int rc = UI_FillBitmap(ui);
+    if (rc != INDEXREAD_OK) return rc;
+  }
+  const t_docId nextId = ui->minDocId + 1;
+  size_t word = nextId / 64;
+  uint64_t bits = word < ui->bitmapWords ? ui->bitmap[word] & (UINT64_MAX << (nextId % 64)) : 0;
+  size_t count = 0;
+  while (count < cap && word < ui->bitmapWords) {
+    for (; bits && count < cap; bits &= bits - 1) {
+      out[count++] = word * 64 + __builtin_ctzll(bits);
+    }
+    if (!bits && ++word < ui->bitmapWords) {
+      bits = ui->bitmap[word];
+    }
+  }
+  *n = count;
+  if (count) {
+    ui->minDocId = CURRENT_RECORD(ui)->docId = out[count - 1];
+    ui->len += count;
+  }
+  if (count < cap) {
+    IITER_SET_EOF(&ui->base);
+    return INDEXREAD_EOF;
+  }
+  return INDEXREAD_OK;
+}
+
 void UnionIterator_Free(IndexIterator *itbase) {
   if (itbase == NULL) return;
 
@@ -548,6 +728,7 @@ void UnionIterator_Free(IndexIterator *itbase) {
 
   IndexResult_Free(CURRENT_RECORD(ui));
   if (ui->heapMinId) heap_free(ui->heapMinId);
+  rm_free(ui->bitmap);
   rm_free(ui->its);
   rm_free(ui->origits);
   rm_free(ui);
@@ -593,6 +774,8 @@ void trimUnionIterator(IndexIterator *iter, size_t offset, size_t limit, bool as
     UI_SyncIterList(ui);
   }
   iter->Read = UI_ReadUnsorted;
+  // The trimmed children are read one after the other, not merged
+  iter->ReadBatch = NULL;
 }
 
 /* The context used by the intersection methods during iterating an intersect
@@ -616,8 +799,26 @@ typedef struct {
   t_fieldMask fieldMask;
   double weight;
   size_t nexpected;
+
+  // The number of candidates each child rejected since the children were last ordered, used to
+  // move the most selective children to the front of the intersection as the query runs
+  uint32_t *rejects;
+  // The number of candidates read from the first child since the children were last ordered
+  size_t ncandidates;
+  // The number of times the children were reordered
+  size_t nreorders;
+  // Scratch space for the current bitmap block of each child, if all the children are readers that
+  // may have bitmap blocks (NULL otherwise). Candidates are then found with a word-wise AND of the
+  // children's bitmap blocks
+  const IndexBlock **bitmapBlocks;
+
+  BlockMaxPruning blockMax;
 } IntersectIterator;
 
+/* The number of candidates between attempts to reorder the children of an intersection by the
+ * number of candidates they rejected */
+#define II_REORDER_INTERVAL 1024
+
 void IntersectIterator_Free(IndexIterator *it) {
   if (it == NULL) return;
   IntersectIterator *ui = it->ctx;
@@ -628,6 +829,8 @@ void IntersectIterator_Free(IndexIterator *it) {
   }
 
   rm_free(ui->docIds);
+  rm_free(ui->rejects);
+  rm_free(ui->bitmapBlocks);
   rm_free(ui->its);
   IndexResult_Free(it->current);
   rm_free(it);
@@ -647,10 +850,12 @@ static void II_Rewind(void *ctx) {
   IntersectIterator *ii = ctx;
   ii->base.isValid = 1;
   ii->lastDocId = 0;
+  ii->ncandidates = 0;
 
   // rewind all child iterators
   for (int i = 0; i < ii->num; i++) {
     ii->docIds[i] = 0;
+    ii->rejects[i] = 0;
     if (ii->its[i]) {
       ii->its[i]->Rewind(ii->its[i]->ctx);
     }
@@ -658,31 +863,81 @@ static void II_Rewind(void *ctx) {
 }
 
 typedef int (*CompareFunc)(const void *a, const void *b);
+
+/* Estimate the number of docs an iterator yields, refining its own estimate where the index
+ * statistics allow it. The ranges of a numeric filter are only partially covered at its bounds,
+ * so the filter yields about the part of these ranges that it overlaps */
+static double estimateMatches(IndexIterator *it) {
+  size_t estimate = IITER_NUM_ESTIMATED(it);
+  if (it->type == READ_ITERATOR) {
+    return IR_EstimateMatches(it->ctx);
+  } else if (it->type == UNION_ITERATOR && ((UnionIterator *)it)->origType == QN_NUMERIC) {
+    UnionIterator *ui = (UnionIterator *)it;
+    double sum = 0;
+    for (size_t i = 0; i < ui->norig; i++) {
+      if (ui->origits[i]) {
+        sum += estimateMatches(ui->origits[i]);
+      }
+    }
+    return sum < estimate ? sum : estimate;
+  }
+  return estimate;
+}
+
+/* The cost of driving an intersection with an iterator: the number of docs it yields, weighted
+ * by how expensive it is to advance */
+static double iteratorCost(IndexIterator *it) {
+  double factor = 1;
+  if (it->type == INTERSECT_ITERATOR) {
+    // we skip as soon as a doc is not in all of its children
+    factor = 1.0 / MAX(1, ((IntersectIterator *)it)->num);
+  } else if (it->type == UNION_ITERATOR && RSGlobalConfig.prioritizeIntersectUnionChildren) {
+    factor = ((UnionIterator *)it)->num;
+  }
+  return estimateMatches(it) * factor;
+}
+
 static int cmpIter(IndexIterator **it1, IndexIterator **it2) {
   if (!*it1 && !*it2) return 0;
   if (!*it1) return -1;
   if (!*it2) return 1;
 
-  double factor1 = 1;
-  double factor2 = 1;
-  enum IteratorType it_1_type = (*it1)->type;
-  enum IteratorType it_2_type = (*it2)->type;
+  double cost1 = iteratorCost(*it1);
+  double cost2 = iteratorCost(*it2);
+  return cost1 < cost2 ? -1 : cost1 > cost2 ? 1 : 0;
+}
 
-  /*
-   * on INTERSECT iterator, we divide the estimate by the number of children
-   * since we skip as soon as a number is not in all iterators */
-  if (it_1_type == INTERSECT_ITERATOR) {
-    factor1 = 1 / MAX(1, ((IntersectIterator *)*it1)->num);
-  } else if (it_1_type == UNION_ITERATOR && RSGlobalConfig.prioritizeIntersectUnionChildren) {
-    factor1 = ((UnionIterator *)*it1)->num;
+/* Reorder the children following the first one by the number of candidates they rejected, so the
+ * children that filter out most of the candidates of the first child are checked first. The first
+ * child, which drives the intersection, keeps its place */
+static void II_ReorderChildren(IntersectIterator *ic) {
+  bool moved = false;
+  // insertion sort - there are only a few children, and they are mostly in order already
+  for (uint32_t i = 2; i < ic->num; i++) {
+    IndexIterator *it = ic->its[i];
+    t_docId docId = ic->docIds[i];
+    uint32_t rejects = ic->rejects[i];
+    uint32_t j = i;
+    for (; j > 1 && ic->rejects[j - 1] < rejects; j--) {
+      ic->its[j] = ic->its[j - 1];
+      ic->docIds[j] = ic->docIds[j - 1];
+      ic->rejects[j] = ic->rejects[j - 1];
+    }
+    if (j != i) {
+      ic->its[j] = it;
+      ic->docIds[j] = docId;
+      ic->rejects[j] = rejects;
+      moved = true;
+    }
   }
-  if (it_2_type == INTERSECT_ITERATOR) {
-    factor2 = 1 / MAX(1, ((IntersectIterator *)*it2)->num);
-  } else if (it_2_type == UNION_ITERATOR && RSGlobalConfig.prioritizeIntersectUnionChildren) {
-    factor2 = ((UnionIterator *)*it2)->num;
+  if (moved) {
+    ic->nreorders++;
   }
-
-  return (int)((*it1)->NumEstimated((*it1)->ctx) * factor1 - (*it2)->NumEstimated((*it2)->ctx) * factor2);
+  // decay the counts, so the order follows changes in the selectivity along the doc ids
+  for (uint32_t i = 0; i < ic->num; i++) {
+    ic->rejects[i] /= 2;
+  }
+  ic->ncandidates = 0;
 }
 
 static void II_SortChildren(IntersectIterator *ctx) {
@@ -718,12 +973,71 @@ static void II_SortChildren(IntersectIterator *ctx) {
   ctx->num = itsSize;
 }
 
+static bool II_MayHaveBitmaps(IndexIterator *it) {
+  return it && it->type == READ_ITERATOR && IR_MayHaveBitmaps(it->ctx);
+}
+
+static bool II_AllMayHaveBitmaps(const IntersectIterator *ic) {
+  for (uint32_t i = 0; i < ic->num; i++) {
+    if (!II_MayHaveBitmaps(ic->its[i])) {
+      return false;
+    }
+  }
+  return ic->num > 1;
+}
+
+/**
+ * Advance `docId` to the first id that is set in the bitmap blocks of all the children, found with a
+ * word-wise AND of these blocks. Stops as soon as one of the children does not have a bitmap block
+ * that may hold `docId`, leaving `docId` as a candidate to check the regular way.
+ */
+static void II_IntersectBitmaps(IntersectIterator *ic, t_docId *docId) {
+  const IndexBlock **blocks = ic->bitmapBlocks;
+  while (true) {
+    // Only the range shared by all the blocks may hold common ids
+    t_docId start = *docId, end = UINT64_MAX;
+    for (uint32_t i = 0; i < ic->num; i++) {
+      blocks[i] = IR_BitmapBlock(ic->its[i]->ctx, *docId);
+      if (!blocks[i]) {
+        return;
+      }
+      if (blocks[i]->firstId > start) start = blocks[i]->firstId;
+      if (blocks[i]->lastId < end) end = blocks[i]->lastId;
+    }
+    for (t_docId id = start; id <= end; id += 64) {
+      uint64_t word = UINT64_MAX;
+      for (uint32_t i = 0; i < ic->num && word; i++) {
+        word &= IndexBlock_BitmapWord(blocks[i], id);
+      }
+      if (word) {
+        // Ids past the end of a block are never set, so this is within the range
+        *docId = id + __builtin_ctzll(word);
+        return;
+      }
+    }
+    // No common id up to the end of the shortest block
+    *docId = end + 1;
+  }
+}
+
 void AddIntersectIterator(IndexIterator *parentIter, IndexIterator *childIter) {
   RS_LOG_ASSERT(parentIter->type == INTERSECT_ITERATOR, "add applies to intersect iterators only");
   IntersectIterator *ii = (IntersectIterator *)parentIter;
   ii->num++;
-  ii->its = rm_realloc(ii->its, ii->num);
+  ii->its = rm_realloc(ii->its, ii->num * sizeof(*ii->its));
+  ii->docIds = rm_realloc(ii->docIds, ii->num * sizeof(*ii->docIds));
+  ii->rejects = rm_realloc(ii->rejects, ii->num * sizeof(*ii->rejects));
   ii->its[ii->num - 1] = childIter;
+  ii->docIds[ii->num - 1] = 0;
+  ii->rejects[ii->num - 1] = 0;
+  if (ii->bitmapBlocks) {
+    if (II_MayHaveBitmaps(childIter)) {
+      ii->bitmapBlocks = rm_realloc(ii->bitmapBlocks, ii->num * sizeof(*ii->bitmapBlocks));
+    } else {
+      rm_free(ii->bitmapBlocks);
+      ii->bitmapBlocks = NULL;
+    }
+  }
 }
 
 IndexIterator *NewIntersectIterator(IndexIterator **its_, size_t num, DocTable *dt,
@@ -738,6 +1052,7 @@ IndexIterator *NewIntersectIterator(IndexIterator **its_, size_t num, DocTable *
   ctx->fieldMask = fieldMask;
   ctx->weight = weight;
   ctx->docIds = rm_calloc(num, sizeof(t_docId));
+  ctx->rejects = rm_calloc(num, sizeof(*ctx->rejects));
   ctx->docTable = dt;
   ctx->nexpected = IITER_INVALID_NUM_ESTIMATED_RESULTS;
 
@@ -746,7 +1061,7 @@ IndexIterator *NewIntersectIterator(IndexIterator **its_, size_t num, DocTable *
   ctx->its = its_;
   ctx->num = num;
 
-  // Sort children iterators from low count to high count which reduces the number of iterations.
+  // Sort children iterators from low to high cost which reduces the number of iterations.
   if (!ctx->inOrder) {
     qsort(ctx->its, ctx->num, sizeof(*ctx->its), (CompareFunc)cmpIter);
   }
@@ -765,9 +1080,163 @@ IndexIterator *NewIntersectIterator(IndexIterator **its_, size_t num, DocTable *
   it->Rewind = II_Rewind;
   it->HasNext = NULL;
   II_SortChildren(ctx);
+  if (ctx->nexpected != IITER_INVALID_NUM_ESTIMATED_RESULTS && II_AllMayHaveBitmaps(ctx)) {
+    ctx->bitmapBlocks = rm_malloc(ctx->num * sizeof(*ctx->bitmapBlocks));
+  }
   return it;
 }
 
+/**
+ * Block-max pruning.
+ *
+ * A query scored with BM25STD and sorted by score only needs the documents that may score above the
+ * lowest of the top results found so far. Each block of a term index bounds the score of its
+ * entries (see `IndexBlock_MaxScore`), so the score of a document is bound by the sum of the bounds
+ * of the blocks holding it, and the ranges of ids whose bound is below the threshold are skipped.
+ */
+
+/* Find the range [*first, *last] of ids from `docId` on, within which each term reader of the tree
+ * stays in a single block, and set `*bound` to the score bound of the documents in it. Returns false
+ * if the tree has no entries left from `docId` on */
+static bool BlockMax_Bound(IndexIterator *it, t_docId docId, t_docId *first, t_docId *last,
+                           double *bound) {
+  if (it->type == PROFILE_ITERATOR) {
+    it = ((ProfileIterator *)it->ctx)->child;
+  }
+  switch (it->type) {
+    case READ_ITERATOR:
+      return IR_BlockMaxScore(it->ctx, docId, first, last, bound);
+
+    case UNION_ITERATOR: {
+      // any child may hold a document of the range
+      const UnionIterator *ui = it->ctx;
+      bool found = false;
+      *first = *last = UINT64_MAX;
+      double sum = 0;
+      for (uint32_t i = 0; i < ui->num; i++) {
+        t_docId f, l;
+        double b;
+        if (BlockMax_Bound(ui->its[i], docId, &f, &l, &b)) {
+          found = true;
+          *first = MIN(*first, f);
+          *last = MIN(*last, l);
+          sum += b;
+        }
+      }
+      *bound = sum * ui->weight;
+      return found;
+    }
+
+    case INTERSECT_ITERATOR: {
+      // all the children hold the documents of the range
+      const IntersectIterator *ic = it->ctx;
+      while (true) {
+        *first = docId;
+        *last = UINT64_MAX;
+        double sum = 0;
+        for (uint32_t i = 0; i < ic->num; i++) {
+          t_docId f, l;
+          double b;
+          if (!BlockMax_Bound(ic->its[i], docId, &f, &l, &b)) {
+            return false;
+          }
+          *first = MAX(*first, f);
+          *last = MIN(*last, l);
+          sum += b;
+        }
+        if (*first <= *last) {
+          *bound = sum * ic->weight;
+          return true;
+        }
+        // a child has no entries before the first entry of another
+        docId = *first;
+      }
+    }
+
+    default:
+      // an empty iterator
+      return false;
+  }
+}
+
+/* Return the first id from `docId` on which may score above the threshold, or 0 if there is none */
+static t_docId BlockMax_NextCandidate(IndexIterator *it, BlockMaxPruning *bm, t_docId docId) {
+  while (true) {
+    if (docId < bm->from || docId > bm->last) {
+      if (!BlockMax_Bound(it, docId, &bm->first, &bm->last, &bm->bound)) {
+        return 0;
+      }
+      bm->from = docId;
+    }
+    if (bm->bound >= *bm->threshold) {
+      return MAX(docId, bm->first);
+    }
+    docId = bm->last + 1;
+  }
+}
+
+/* Set up the score bounds of the readers of the tree. Returns false if the tree is not made of
+ * term readers, and unions and intersections of them */
+static bool BlockMax_SetScoreBounds(IndexIterator *it, double avgDocLen, double maxDocScore) {
+  switch (it->type) {
+    case READ_ITERATOR:
+      return IR_SetScoreBounds(it->ctx, avgDocLen, maxDocScore);
+
+    case UNION_ITERATOR: {
+      const UnionIterator *ui = it->ctx;
+      // the children of a union with a min-id heap are not read in order of their ranges
+      if (ui->heapMinId || ui->weight < 0) {
+        return false;
+      }
+      for (uint32_t i = 0; i < ui->num; i++) {
+        if (!BlockMax_SetScoreBounds(ui->its[i], avgDocLen, maxDocScore)) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    case INTERSECT_ITERATOR: {
+      const IntersectIterator *ic = it->ctx;
+      if (ic->weight < 0) {
+        return false;
+      }
+      for (uint32_t i = 0; i < ic->num; i++) {
+        if (!ic->its[i] || !BlockMax_SetScoreBounds(ic->its[i], avgDocLen, maxDocScore)) {
+          return false;
+        }
+      }
+      return ic->num > 0;
+    }
+
+    case EMPTY_ITERATOR:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+bool EnableBlockMaxPruning(IndexIterator *root, const double *threshold, double avgDocLen,
+                           double maxDocScore) {
+  if (!BlockMax_SetScoreBounds(root, avgDocLen, maxDocScore)) {
+    return false;
+  }
+  switch (root->type) {
+    case READ_ITERATOR:
+      ((IndexReader *)root->ctx)->scoreThreshold = threshold;
+      return true;
+    case UNION_ITERATOR:
+      ((UnionIterator *)root->ctx)->blockMax = (BlockMaxPruning){.threshold = threshold};
+      return true;
+    case INTERSECT_ITERATOR:
+      ((IntersectIterator *)root->ctx)->blockMax = (BlockMaxPruning){.threshold = threshold};
+      return true;
+    default:
+      return false;
+  }
+}
+
 static int II_SkipTo(void *ctx, t_docId docId, RSIndexResult **hit) {
   /* A seek with docId 0 is equivalent to a read */
   if (docId == 0) {
@@ -809,6 +1278,7 @@ static int II_SkipTo(void *ctx, t_docId docId, RSIndexResult **hit) {
       ++nfound;
     } else if (ic->docIds[i] > ic->lastDocId) {
       ic->lastDocId = ic->docIds[i];
+      ic->rejects[i]++;
       break;
     }
   }
@@ -855,6 +1325,22 @@ static int II_ReadSorted(void *ctx, RSIndexResult **hit) {
     nh = 0;
     AggregateResult_Reset(ic->base.current);
 
+    // the order of the children matters when they have to be in order
+    if (ic->ncandidates >= II_REORDER_INTERVAL && !ic->inOrder) {
+      II_ReorderChildren(ic);
+    }
+
+    // skip the ids that are not set in the bitmap blocks of all the children at once
+    if (ic->bitmapBlocks) {
+      II_IntersectBitmaps(ic, &ic->lastDocId);
+    }
+    // pass over the ids that cannot score into the top results
+    if (BLOCK_MAX_PRUNING(ic->blockMax)) {
+      t_docId target = BlockMax_NextCandidate(&ic->base, &ic->blockMax, MAX(ic->lastDocId, 1));
+      if (!target) goto eof;
+      if (target > ic->lastDocId) ic->lastDocId = target;
+    }
+
     for (i = 0; i < ic->num; i++) {
       IndexIterator *it = ic->its[i];
 
@@ -875,10 +1361,16 @@ static int II_ReadSorted(void *ctx, RSIndexResult **hit) {
 
         if (rc == INDEXREAD_EOF) goto eof;
         ic->docIds[i] = h->docId;
+        if (i == 0) {
+          ic->ncandidates++;
+        }
       }
 
       if (ic->docIds[i] > ic->lastDocId) {
         ic->lastDocId = ic->docIds[i];
+        if (i > 0) {
+          ic->rejects[i]++;
+        }
         break;
       }
       if (rc == INDEXREAD_OK) {
@@ -1645,6 +2137,22 @@ static int WI_Read(void *ctx, RSIndexResult **hit) {
   return INDEXREAD_OK;
 }
 
+static int WI_ReadBatch(void *ctx, t_docId *out, size_t cap, size_t *n) {
+  WildcardIteratorCtx *nc = ctx;
+  size_t count = 0;
+  while (count < cap && nc->current < nc->topId) {
+    out[count++] = ++nc->current;
+  }
+  *n = count;
+  CURRENT_RECORD(nc)->docId = nc->current;
+  if (count < cap) {
+    // past the top id, as a following read would be
+    CURRENT_RECORD(nc)->docId = ++nc->current;
+    return INDEXREAD_EOF;
+  }
+  return INDEXREAD_OK;
+}
+
 /* Skipto for wildcard iterator - always succeeds, but this should normally not happen as it has
  * no
  * meaning */
@@ -1717,6 +2225,7 @@ IndexIterator *NewWildcardIterator_NonOptimized(t_docId maxId, size_t numDocs) {
   ret->LastDocId = WI_LastDocId;
   ret->Len = WI_Len;
   ret->Read = WI_Read;
+  ret->ReadBatch = WI_ReadBatch;
   ret->SkipTo = WI_SkipTo;
   ret->Abort = WI_Abort;
   ret->Rewind = WI_Rewind;
@@ -1746,6 +2255,10 @@ IndexIterator *NewWildcardIterator(QueryEvalCtx *q) {
 static int EOI_Read(void *p, RSIndexResult **e) {
   return INDEXREAD_EOF;
 }
+static int EOI_ReadBatch(void *p, t_docId *out, size_t cap, size_t *n) {
+  *n = 0;
+  return INDEXREAD_EOF;
+}
 static void EOI_Free(struct indexIterator *self) {
   // Nothing
 }
@@ -1768,6 +2281,7 @@ static void EOI_Rewind(void *ctx) {
 }
 
 static IndexIterator eofIterator = {.Read = EOI_Read,
+                                    .ReadBatch = EOI_ReadBatch,
                                     .Free = EOI_Free,
                                     .SkipTo = EOI_SkipTo,
                                     .Len = EOI_Len,
@@ -1781,6 +2295,25 @@ IndexIterator *NewEmptyIterator(void) {
   return &eofIterator;
 }
 
+int IndexIterator_ReadBatch(IndexIterator *it, t_docId *out, size_t cap, size_t *n) {
+  if (it->ReadBatch) {
+    return it->ReadBatch(it->ctx, out, cap, n);
+  }
+  size_t count = 0;
+  int rc = INDEXREAD_OK;
+  while (count < cap) {
+    RSIndexResult *r = NULL;
+    rc = it->Read(it->ctx, &r);
+    if (rc == INDEXREAD_OK) {
+      if (r) out[count++] = r->docId;
+    } else if (rc != INDEXREAD_NOTFOUND) {
+      break;
+    }
+  }
+  *n = count;
+  return count < cap ? rc : INDEXREAD_OK;
+}
+
 /**********************************************************
  * Profile printing functions
  **********************************************************/
@@ -1926,6 +2459,11 @@ PRINT_PROFILE_FUNC(printIntersectIt) {
 
   printProfileCounter(counter);
 
+  // the children are listed in the order they were last checked in
+  if (ii->nreorders) {
+    RedisModule_ReplyKV_LongLong(reply, "Reorders", ii->nreorders);
+  }
+
   RedisModule_ReplyKV_Array(reply, "Child iterators");
     for (int i = 0; i < ii->num; i++) {
       if (ii->its[i]) {
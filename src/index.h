@@ -93,6 +93,17 @@ IndexIterator *NewIdListIterator(t_docId *ids, t_offset num, double weight);
 /** Create a new iterator which returns no results */
 IndexIterator *NewEmptyIterator(void);
 
+/* Let the query pass over the documents which cannot score above `*threshold`, the lowest score of
+ * the top results found so far, if the query is scored with BM25STD over an index with the given
+ * average document length, and documents scoring at most `maxDocScore`. Supported on trees of term
+ * readers, and unions and intersections of them. Returns false if the tree is not supported */
+bool EnableBlockMaxPruning(IndexIterator *root, const double *threshold, double avgDocLen,
+                           double maxDocScore);
+
+/* Read the ids of up to `cap` next entries of the iterator into `out`, as `ReadBatch` does, falling
+ * back to reading them one by one if the iterator does not read batches */
+int IndexIterator_ReadBatch(IndexIterator *it, t_docId *out, size_t cap, size_t *n);
+
 /** Add Profile iterator layer between iterators */
 void Profile_AddIters(IndexIterator **root);
 
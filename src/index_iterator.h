@@ -65,6 +65,12 @@ typedef struct indexIterator {
    *  Returns INDEXREAD_EOF if at the end */
   int (*Read)(void *ctx, RSIndexResult **e);
 
+  /* Read the ids of up to `cap` next entries into `out`, setting `*n` to their number, without
+   * building their records. Returns INDEXREAD_OK if there may be more entries, or the code `Read`
+   * would have returned otherwise (with `*n` possibly above 0). Optional, used to count the results
+   * of a query (see `IndexIterator_ReadBatch`) */
+  int (*ReadBatch)(void *ctx, t_docId *out, size_t cap, size_t *n);
+
   /* Skip to a docid, potentially reading the entry into hit, if the docId
    * matches */
   int (*SkipTo)(void *ctx, t_docId docId, RSIndexResult **hit);
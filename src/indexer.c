@@ -108,6 +108,7 @@ static void writeCurEntries(RSAddDocumentCtx *aCtx, RedisSearchCtx *ctx) {
     }
     if (invidx) {
       entry->docId = aCtx->doc->docId;
+      entry->docLen = aCtx->fwIdx->totalFreq;
       RS_LOG_ASSERT(entry->docId, "docId should not be 0");
       IndexerYieldWhileLoading(ctx->redisCtx);
       writeIndexEntry(spec, invidx, encoder, entry);
@@ -141,7 +142,7 @@ static RSDocumentMetadata *makeDocumentId(RedisModuleCtx *ctx, RSAddDocumentCtx
       DMD_Return(aCtx->oldMd);
       aCtx->oldMd = dmd;
       if (spec->gc) {
-        GCContext_OnDelete(spec->gc);
+        GCContext_OnDelete(spec->gc, dmd->id);
       }
       if (spec->flags & Index_HasVecSim) {
         for (int i = 0; i < spec->numFields; ++i) {
@@ -168,6 +169,7 @@ static RSDocumentMetadata *makeDocumentId(RedisModuleCtx *ctx, RSAddDocumentCtx
   if (dmd) {
     doc->docId = dmd->id;
     ++spec->stats.numDocuments;
+    ++spec->revision;
   }
 
   return dmd;
@@ -78,10 +78,17 @@ void TotalGlobalStats_CountQuery(uint32_t reqflags, clock_t duration) {
   }
 }
 
+void TotalGlobalStats_CountQueryCacheHit(uint32_t reqflags) {
+  if (reqflags & QEXEC_F_INTERNAL) return; // internal queries are not counted
+
+  INCR(RSGlobalStats.totalStats.queries.total_query_cache_hits);
+}
+
 QueriesGlobalStats TotalGlobalStats_GetQueryStats() {
   QueriesGlobalStats stats = {0};
   stats.total_queries_processed = READ(RSGlobalStats.totalStats.queries.total_queries_processed);
   stats.total_query_commands = READ(RSGlobalStats.totalStats.queries.total_query_commands);
+  stats.total_query_cache_hits = READ(RSGlobalStats.totalStats.queries.total_query_cache_hits);
   stats.total_query_execution_time = READ(RSGlobalStats.totalStats.queries.total_query_execution_time) / CLOCKS_PER_MILLISEC;
   return stats;
 }
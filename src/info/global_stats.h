@@ -40,6 +40,7 @@ typedef struct {
   size_t total_queries_processed;       // Number of successful queries. If using cursors, not counting reading from the cursor
   size_t total_query_commands;          // Number of successful query commands, including `FT.CURSOR READ`
   clock_t total_query_execution_time;   // Total time spent on queries (in clock ticks)
+  size_t total_query_cache_hits;        // Number of query commands replied from the query cache, also counted above
 } QueriesGlobalStats;
 
 typedef struct {
@@ -80,6 +81,12 @@ size_t FieldsGlobalStats_GetIndexErrorCount(FieldType field_type);
  */
 void TotalGlobalStats_CountQuery(uint32_t reqflags, clock_t duration);
 
+/**
+ * Increase the number of queries replied from the query cache. The query itself is counted by
+ * `TotalGlobalStats_CountQuery`.
+ */
+void TotalGlobalStats_CountQueryCacheHit(uint32_t reqflags);
+
 /**
  * Safely reads and returns a copy of the global queries stats.
  */
@@ -43,10 +43,10 @@ TotalIndexesInfo IndexesInfo_TotalInfo() {
     info.fields_stats.total_mark_deleted_vectors += vec_info.marked_deleted;
 
     if (sp->gc) {
-      ForkGCStats gcStats = ((ForkGC *)sp->gc->gcCtx)->stats;
-      info.gc_stats.totalCollectedBytes += gcStats.totalCollected;
-      info.gc_stats.totalCycles += gcStats.numCycles;
-      info.gc_stats.totalTime += gcStats.totalMSRun;
+      const GCStats *gcStats = GCContext_GetStats(sp->gc);
+      info.gc_stats.totalCollectedBytes += gcStats->totalCollected;
+      info.gc_stats.totalCycles += gcStats->numCycles;
+      info.gc_stats.totalTime += gcStats->totalMSRun;
     }
 
     // Index
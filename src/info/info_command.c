@@ -21,6 +21,7 @@
 #include "field_spec_info.h"
 #include "info/info_redis/threads/current_thread.h"
 #include "obfuscation/obfuscation_api.h"
+#include "query_cache.h"
 
 static void renderIndexOptions(RedisModule_Reply *reply, const IndexSpec *sp) {
 
@@ -39,6 +40,9 @@ static void renderIndexOptions(RedisModule_Reply *reply, const IndexSpec *sp) {
   if (sp->flags & Index_WideSchema) {
     RedisModule_Reply_SimpleString(reply, SPEC_SCHEMA_EXPANDABLE_STR);
   }
+  if (sp->flags & Index_StorePacked) {
+    RedisModule_Reply_SimpleString(reply, SPEC_PACKEDPOSTINGS_STR);
+  }
   RedisModule_Reply_ArrayEnd(reply);
 }
 
@@ -298,6 +302,10 @@ void fillReplyWithIndexInfo(RedisSearchCtx* sctx, RedisModule_Reply *reply, bool
 
   Cursors_RenderStats(&g_CursorsList, &g_CursorsListCoord, sp, reply);
 
+  if (RSGlobalConfig.queryCacheMaxMemory && sp->queryCache) {
+    QueryCache_RenderStats(sp->queryCache, reply);
+  }
+
   // Unlock spec
   RedisSearchCtx_UnlockSpec(sctx);
 
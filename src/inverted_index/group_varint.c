@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#include "group_varint.h"
+#include <string.h>
+#include <stdbool.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <tmmintrin.h>
+#define GROUP_VARINT_SSSE3
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define GROUP_VARINT_NEON
+#endif
+
+// The byte length (1-4) of the i-th integer of a group, given its control byte
+#define GV_LENGTH(ctrl, i) ((((ctrl) >> (2 * (i))) & 0x03) + 1)
+
+// The SIMD decoders always load 16 data bytes following the control byte
+#define GV_SIMD_LOAD_BYTES (1 + 16)
+
+// Per control byte: the number of data bytes of the group, and the shuffle mask that spreads them
+// into 4 little-endian 32 bit lanes (0x80 zeroes the destination byte)
+static uint8_t groupDataLength[256];
+static uint8_t groupShuffle[256][16] __attribute__((aligned(16)));
+static bool useSIMD = false;
+
+static void __attribute__((constructor)) initGroupVarint() {
+  for (int ctrl = 0; ctrl < 256; ctrl++) {
+    uint8_t offset = 0;
+    for (int i = 0; i < GROUP_VARINT_SIZE; i++) {
+      const uint8_t len = GV_LENGTH(ctrl, i);
+      for (int j = 0; j < 4; j++) {
+        groupShuffle[ctrl][i * 4 + j] = j < len ? offset + j : 0x80;
+      }
+      offset += len;
+    }
+    groupDataLength[ctrl] = offset;
+  }
+
+#if defined(GROUP_VARINT_SSSE3)
+  __builtin_cpu_init();
+  useSIMD = __builtin_cpu_supports("ssse3");
+#elif defined(GROUP_VARINT_NEON)
+  useSIMD = true;
+#endif
+}
+
+size_t GroupVarint_Encode(uint8_t *out, const uint32_t in[GROUP_VARINT_SIZE]) {
+  uint8_t ctrl = 0;
+  size_t pos = 1;
+  for (int i = 0; i < GROUP_VARINT_SIZE; i++) {
+    const uint32_t v = in[i];
+    const uint8_t len = v > 0xFFFFFF ? 4 : v > 0xFFFF ? 3 : v > 0xFF ? 2 : 1;
+    memcpy(out + pos, &v, len);  // little endian, as qint
+    pos += len;
+    ctrl |= (len - 1) << (2 * i);
+  }
+  out[0] = ctrl;
+  return pos;
+}
+
+static inline size_t decodeScalar(const uint8_t *in, uint32_t out[GROUP_VARINT_SIZE]) {
+  const uint8_t ctrl = in[0];
+  const uint8_t *p = in + 1;
+  for (int i = 0; i < GROUP_VARINT_SIZE; i++) {
+    const uint8_t len = GV_LENGTH(ctrl, i);
+    uint32_t v = 0;
+    memcpy(&v, p, len);
+    out[i] = v;
+    p += len;
+  }
+  return p - in;
+}
+
+#if defined(GROUP_VARINT_SSSE3)
+
+__attribute__((target("ssse3")))
+static inline __m128i loadGroup(const uint8_t *in) {
+  const __m128i data = _mm_loadu_si128((const __m128i *)(in + 1));
+  return _mm_shuffle_epi8(data, _mm_load_si128((const __m128i *)groupShuffle[in[0]]));
+}
+
+__attribute__((target("ssse3")))
+static size_t decodeSIMD(const uint8_t *in, uint32_t out[GROUP_VARINT_SIZE]) {
+  _mm_storeu_si128((__m128i *)out, loadGroup(in));
+  return 1 + groupDataLength[in[0]];
+}
+
+__attribute__((target("ssse3")))
+static size_t decodeDeltasSIMD(const uint8_t *in, uint32_t *base, uint32_t out[GROUP_VARINT_SIZE]) {
+  __m128i v = loadGroup(in);
+  // In-register prefix sum of the 4 lanes, on top of the base
+  v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+  v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+  v = _mm_add_epi32(v, _mm_set1_epi32(*base));
+  _mm_storeu_si128((__m128i *)out, v);
+  *base = out[GROUP_VARINT_SIZE - 1];
+  return 1 + groupDataLength[in[0]];
+}
+
+#elif defined(GROUP_VARINT_NEON)
+
+static inline uint32x4_t loadGroup(const uint8_t *in) {
+  // Out of range indices (0x80) yield zero bytes
+  const uint8x16_t v = vqtbl1q_u8(vld1q_u8(in + 1), vld1q_u8(groupShuffle[in[0]]));
+  return vreinterpretq_u32_u8(v);
+}
+
+static size_t decodeSIMD(const uint8_t *in, uint32_t out[GROUP_VARINT_SIZE]) {
+  vst1q_u32(out, loadGroup(in));
+  return 1 + groupDataLength[in[0]];
+}
+
+static size_t decodeDeltasSIMD(const uint8_t *in, uint32_t *base, uint32_t out[GROUP_VARINT_SIZE]) {
+  const uint32x4_t zero = vdupq_n_u32(0);
+  uint32x4_t v = loadGroup(in);
+  v = vaddq_u32(v, vextq_u32(zero, v, 3));
+  v = vaddq_u32(v, vextq_u32(zero, v, 2));
+  v = vaddq_u32(v, vdupq_n_u32(*base));
+  vst1q_u32(out, v);
+  *base = out[GROUP_VARINT_SIZE - 1];
+  return 1 + groupDataLength[in[0]];
+}
+
+#endif
+
+size_t GroupVarint_Decode(const uint8_t *in, size_t avail, uint32_t out[GROUP_VARINT_SIZE]) {
+#if defined(GROUP_VARINT_SSSE3) || defined(GROUP_VARINT_NEON)
+  // The vector load may read past the group, so it is only used when the input is long enough
+  if (useSIMD && avail >= GV_SIMD_LOAD_BYTES) {
+    return decodeSIMD(in, out);
+  }
+#endif
+  return decodeScalar(in, out);
+}
+
+size_t GroupVarint_DecodeDeltas(const uint8_t *in, size_t avail, uint32_t *base,
+                                uint32_t out[GROUP_VARINT_SIZE]) {
+#if defined(GROUP_VARINT_SSSE3) || defined(GROUP_VARINT_NEON)
+  if (useSIMD && avail >= GV_SIMD_LOAD_BYTES) {
+    return decodeDeltasSIMD(in, base, out);
+  }
+#endif
+  size_t sz = decodeScalar(in, out);
+  uint32_t sum = *base;
+  for (int i = 0; i < GROUP_VARINT_SIZE; i++) {
+    sum += out[i];
+    out[i] = sum;
+  }
+  *base = sum;
+  return sz;
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Group varint - encoding of groups of 4 unsigned 32 bit integers with a leading control byte that
+ * holds the byte length (1-4) of each integer. Unlike qint, the layout is designed to be decoded a
+ * whole group at a time with a single byte shuffle (SSSE3 `pshufb` / NEON `tbl`), falling back to
+ * a scalar decoder on other platforms or near the end of the input. */
+
+// The number of integers sharing a single control byte
+#define GROUP_VARINT_SIZE 4
+// The maximal encoded size of a group - a control byte and 4 bytes per integer
+#define GROUP_VARINT_MAX_BYTES (1 + 4 * GROUP_VARINT_SIZE)
+
+/* Encode a group of integers into `out`, which must have room for GROUP_VARINT_MAX_BYTES bytes.
+ * Returns the number of bytes written */
+size_t GroupVarint_Encode(uint8_t *out, const uint32_t in[GROUP_VARINT_SIZE]);
+
+/* Decode a group of integers from `in`, of which `avail` bytes are readable.
+ * Returns the number of bytes consumed */
+size_t GroupVarint_Decode(const uint8_t *in, size_t avail, uint32_t out[GROUP_VARINT_SIZE]);
+
+/* Decode a group of deltas from `in`, of which `avail` bytes are readable, and write their running
+ * sums on top of `*base` to `out`. `*base` is updated to the last sum.
+ * Returns the number of bytes consumed */
+size_t GroupVarint_DecodeDeltas(const uint8_t *in, size_t avail, uint32_t *base,
+                                uint32_t out[GROUP_VARINT_SIZE]);
+
+#ifdef __cplusplus
+}
+#endif
@@ -19,6 +19,8 @@
 #include "numeric_filter.h"
 #include "rmutil/rm_assert.h"
 #include "geo_index.h"
+#include "util/minmax.h"
+#include "group_varint.h"
 
 uint64_t TotalIIBlocks = 0;
 
@@ -28,10 +30,53 @@ uint64_t TotalIIBlocks = 0;
 // pointer to the current block while reading the index
 #define IR_CURRENT_BLOCK(ir) (ir->idx->blocks[ir->currentBlock])
 
+// a buffer reader over the current block's records (decoding its first group if needed)
+#define IR_CURRENT_BLOCK_READER(ir) \
+  IndexBlock_NewReader(&IR_CURRENT_BLOCK(ir), &(ir)->decoders, &(ir)->decodedBlock)
+
+// whether the decoded deltas are relative to the block's first id rather than the previous entry
+#define IR_DELTAS_FROM_FIRST_ID(ir) \
+  ((ir)->decoders.decoder == readRawDocIdsOnly || (ir)->decoders.blockDecoder)
+
+// whether the reader has read all the records of the current block. Bitmap blocks are searched
+// directly rather than read through the buffer reader. Blocks decoded a group at a time move on to
+// their next group once the current one is read
+#define IR_BLOCK_AT_END(ir)                                                               \
+  (IndexBlock_IsBitmap(&IR_CURRENT_BLOCK(ir)) ?                                           \
+     (ir)->bitmapNextId > IR_CURRENT_BLOCK(ir).lastId :                                   \
+     BufferReader_AtEnd(&(ir)->br) &&                                                     \
+       !IndexBlock_NextGroup(&IR_CURRENT_BLOCK(ir), &(ir)->decoders, &(ir)->decodedBlock, \
+                             &(ir)->br))
+
+static void IndexReader_SetBlockReader(IndexReader *ir);
+
 static IndexReader *NewIndexReaderGeneric(const RedisSearchCtx *sctx, InvertedIndex *idx,
                                           IndexDecoderProcs decoder, IndexDecoderCtx decoderCtx, bool skipMulti,
                                           RSIndexResult *record, const FieldFilterContext* filterCtx);
 
+// The initial number of entries after which a new block is started
+static inline uint16_t InvertedIndex_InitialBlockSize(IndexFlags flags) {
+  // use proper block size. Index_DocIdsOnly == 0x00
+  return (flags & INDEX_STORAGE_MASK) ? INDEX_BLOCK_SIZE : INDEX_BLOCK_SIZE_DOCID_ONLY;
+}
+
+// The number of entries after which a new block of the index is started. Long-tail terms keep small
+// blocks, while the blocks of frequent terms grow so they don't end up with too many of them
+static uint16_t InvertedIndex_BlockSize(const InvertedIndex *idx) {
+  const uint32_t initial = InvertedIndex_InitialBlockSize(idx->flags);
+  uint32_t blockSize = initial;
+  while (blockSize < (initial << INDEX_BLOCK_MAX_GROWTH) &&
+         idx->numDocs >= blockSize * INDEX_BLOCK_GROWTH_THRESHOLD) {
+    blockSize <<= 1;
+  }
+  return blockSize;
+}
+
+// The number of entries after which the block is full
+static inline uint16_t IndexBlock_Capacity(const IndexBlock *blk, IndexFlags flags) {
+  return blk->capacity ? blk->capacity : InvertedIndex_InitialBlockSize(flags);
+}
+
 IndexBlock *InvertedIndex_AddBlock(InvertedIndex *idx, t_docId firstId, size_t *memsize) {
   TotalIIBlocks++;
   idx->size++;
@@ -39,6 +84,7 @@ IndexBlock *InvertedIndex_AddBlock(InvertedIndex *idx, t_docId firstId, size_t *
   IndexBlock *last = idx->blocks + (idx->size - 1);
   memset(last, 0, sizeof(*last));  // for msan
   last->firstId = last->lastId = firstId;
+  last->capacity = InvertedIndex_BlockSize(idx);
   Buffer_Init(&INDEX_LAST_BLOCK(idx).buf, INDEX_BLOCK_INITIAL_CAP);
   (*memsize) += sizeof(IndexBlock) + INDEX_BLOCK_INITIAL_CAP;
   return &INDEX_LAST_BLOCK(idx);
@@ -120,10 +166,34 @@ void IndexReader_OnReopen(IndexReader *ir) {
   }
   // the gc marker tells us if there is a chance the keys has undergone GC while we were asleep
   if (ir->gcMarker == ir->idx->gcMarker) {
+    if (IndexBlock_IsBitmap(&IR_CURRENT_BLOCK(ir))) {
+      if (ir->br.buf) {
+        // The block was turned into a bitmap while we were asleep. Continue after the last id we
+        // read from it
+        ir->bitmapNextId = ir->br.pos ? ir->lastId + 1 : IR_CURRENT_BLOCK(ir).firstId;
+        ir->br = (BufferReader){0};
+      }
+      // otherwise we are already searching the bitmap from the next id, ids may only be appended
+      return;
+    }
     // no GC - we just go to the same offset we were at
     size_t offset = ir->br.pos;
-    ir->br = NewBufferReader(&IR_CURRENT_BLOCK(ir).buf);
-    ir->br.pos = offset;
+    if (ir->decoders.blockDecoder) {
+      // The current group is decoded again, as entries may have been added to it (and packed). The
+      // groups before it are left as they are. The skip checkpoints may have been reserved while we
+      // were asleep, if the block was empty. Its first group then follows them
+      DecodedBlock *decoded = &ir->decodedBlock;
+      decoded->nextPos = MAX(decoded->groupPos, IndexBlock_EntriesOffset(&IR_CURRENT_BLOCK(ir)));
+      decoded->nextBase = decoded->groupBase;
+      ir->decoders.blockDecoder(&IR_CURRENT_BLOCK(ir), decoded);
+      ir->br = NewBufferReader(&decoded->records);
+      ir->br.pos = offset;
+      return;
+    }
+    ir->br = IR_CURRENT_BLOCK_READER(ir);
+    // The skip checkpoints may have been reserved while we were asleep, if the block was empty. Its
+    // first entry then follows them
+    ir->br.pos = MAX(offset, ir->br.pos);
   } else {
     // if there has been a GC cycle on this key while we were asleep, the offset might not be valid
     // anymore. This means that we need to seek to last docId we were at
@@ -228,6 +298,49 @@ ENCODER(encodeRawDocIdsOnly) {
   return Buffer_Write(bw, &delta, 4);
 }
 
+/* 10. Packed doc ids (and frequencies).
+ * The entries of a packed block are stored in groups of GROUP_VARINT_SIZE consecutive entries. A full
+ * group holds the group varint encoded doc id deltas, followed by the group varint encoded
+ * frequencies if they are stored. The encoders append the entries of the last (partial) group raw,
+ * as 4 bytes per value, and the group is packed by `IndexBlock_PackLastGroup` once it is full. */
+ENCODER(encodePackedDocIds) {
+  return Buffer_Write(bw, &delta, sizeof(uint32_t));
+}
+
+ENCODER(encodePackedFreqs) {
+  size_t sz = Buffer_Write(bw, &delta, sizeof(uint32_t));
+  sz += Buffer_Write(bw, &res->freq, sizeof(uint32_t));
+  return sz;
+}
+
+#define IS_PACKED_ENCODER(encoder) ((encoder) == encodePackedDocIds || (encoder) == encodePackedFreqs)
+
+// Pack the last group of the block, which must hold GROUP_VARINT_SIZE raw entries.
+// Returns the number of bytes the block buffer grew by
+static size_t IndexBlock_PackLastGroup(IndexBlock *blk, bool withFreqs) {
+  const size_t entrySize = withFreqs ? 2 * sizeof(uint32_t) : sizeof(uint32_t);
+  const size_t groupStart = IndexBlock_DataLen(blk) - GROUP_VARINT_SIZE * entrySize;
+  const char *raw = IndexBlock_DataBuf(blk) + groupStart;
+  uint32_t deltas[GROUP_VARINT_SIZE], freqs[GROUP_VARINT_SIZE];
+  for (int i = 0; i < GROUP_VARINT_SIZE; i++) {
+    memcpy(&deltas[i], raw + i * entrySize, sizeof(uint32_t));
+    if (withFreqs) {
+      memcpy(&freqs[i], raw + i * entrySize + sizeof(uint32_t), sizeof(uint32_t));
+    }
+  }
+
+  // A packed group may be slightly longer than the raw one (a control byte per value group), so
+  // encode it aside and write it over the raw entries
+  uint8_t packed[2 * GROUP_VARINT_MAX_BYTES];
+  size_t len = GroupVarint_Encode(packed, deltas);
+  if (withFreqs) {
+    len += GroupVarint_Encode(packed + len, freqs);
+  }
+  blk->buf.offset = groupStart;
+  BufferWriter bw = NewBufferWriter(&blk->buf);
+  return Buffer_Write(&bw, packed, len);
+}
+
 /**
  * DeltaType{1,2} Float{3}(=1), IsInf{4}   -  Sign{5} IsDouble{6} Unused{7,8}
  * DeltaType{1,2} Float{3}(=0), Tiny{4}(1) -  Number{5,6,7,8}
@@ -395,6 +508,18 @@ IndexDecoderCtx NewIndexDecoderCtx_NumericFilter() {
 
 /* Get the appropriate encoder based on index flags */
 IndexEncoder InvertedIndex_GetEncoder(IndexFlags flags) {
+  if (flags & Index_StorePacked) {
+    switch (flags & INDEX_STORAGE_MASK) {
+      case Index_DocIdsOnly:
+        return encodePackedDocIds;
+      case Index_StoreFreqs:
+        return encodePackedFreqs;
+      default:
+        RS_LOG_ASSERT_FMT(0, "Invalid packed encoder flags: %d", flags);
+        return NULL;
+    }
+  }
+
   switch (flags & INDEX_STORAGE_MASK) {
     // 1. Full encoding - docId, freq, flags, offset
     case Index_StoreFreqs | Index_StoreTermOffsets | Index_StoreFieldFlags:
@@ -453,9 +578,165 @@ IndexEncoder InvertedIndex_GetEncoder(IndexFlags flags) {
   }
 }
 
+
+// Raw doc ids have fixed-size entries and a binary searching seeker, so they don't need skip
+// checkpoints. The skip interval of a packed block is a multiple of GROUP_VARINT_SIZE, so its
+// checkpoints start groups
+#define HAS_SKIP_CHECKPOINTS(encoder) ((encoder) != encodeRawDocIdsOnly)
+
+#define SKIP_INTERVAL(blockSize) ((blockSize) / (INDEX_BLOCK_NUM_SKIPS + 1))
+
+// Reserve the skip checkpoints at the start of the buffer of a block that is about to take its first
+// entry, if the block is large enough to take them. Reserving them before any entry is written
+// means no entry is ever moved, so the positions of the readers of the block stay valid. Returns the
+// number of bytes the buffer grew by
+static size_t IndexBlock_ReserveSkips(IndexBlock *blk, uint16_t blockSize) {
+  if ((blk->flags & IndexBlock_WithSkips) || blockSize < INDEX_BLOCK_SKIPS_MIN_CAPACITY ||
+      IndexBlock_DataLen(blk)) {
+    return 0;
+  }
+  const size_t grew = Buffer_Reserve(&blk->buf, sizeof(IndexBlockSkips));
+  memset(IndexBlock_DataBuf(blk), 0, sizeof(IndexBlockSkips));
+  blk->buf.offset = sizeof(IndexBlockSkips);
+  blk->flags |= IndexBlock_WithSkips;
+  return grew;
+}
+
+// Take a skip checkpoint in `skips` (the checkpoints of a block starting with `firstId`) if the
+// entry number `entryIdx` of the block is due to start one. The entry starts at byte `offset` of the
+// block, and the entry preceding it has the id `prevId`. Blocks without checkpoints (NULL `skips`)
+// are left as they are, so a repair never adds them
+static void IndexBlock_UpdateSkips(IndexBlockSkips *skips, t_docId firstId, uint16_t blockSize,
+                                   size_t entryIdx, t_docId prevId, size_t offset) {
+  const uint16_t interval = SKIP_INTERVAL(blockSize);
+  if (!skips || !entryIdx || entryIdx % interval) {
+    return;
+  }
+  const size_t i = entryIdx / interval - 1;
+  if (i >= INDEX_BLOCK_NUM_SKIPS) {
+    return;
+  }
+  // Base ids are kept as offsets from the first id, so checkpoints of blocks with a wider range of
+  // ids (possible with numeric entries) are not taken. The slot is cleared, as a repair may leave
+  // it with a checkpoint of the entries that were there before
+  if (prevId - firstId > UINT32_MAX) {
+    skips->offsets[i] = 0;
+    return;
+  }
+  skips->baseIds[i] = prevId - firstId;
+  skips->offsets[i] = offset;
+}
+
+// The number of bytes of a bitmap covering `range` ids
+#define BITMAP_BYTES(range) ((((range) + 63) / 64) * sizeof(uint64_t))
+
+// Whether a bitmap covering `range` ids is dense enough for a block of `numEntries` entries - it
+// must take no more than a byte per entry, which is about what encoding the deltas would take
+#define BITMAP_IS_DENSE(range, numEntries) \
+  ((range) <= INDEX_BITMAP_BLOCK_RANGE && BITMAP_BYTES(range) <= (numEntries))
+
+#define BITMAP_WORDS(blk) ((uint64_t *)IndexBlock_DataBuf(blk))
+#define BITMAP_NUM_WORDS(blk) (IndexBlock_DataLen(blk) / sizeof(uint64_t))
+#define BITMAP_SET(words, bit) ((words)[(bit) / 64] |= 1ULL << ((bit) % 64))
+
+// Add an id to a bitmap block. Returns the number of bytes the block's buffer grew by
+static size_t IndexBlock_BitmapAdd(IndexBlock *blk, t_docId docId) {
+  const size_t bit = docId - blk->firstId;
+  const size_t len = BITMAP_BYTES(bit + 1);
+  size_t grew = 0;
+  if (len > IndexBlock_DataLen(blk)) {
+    grew = Buffer_Reserve(&blk->buf, len - IndexBlock_DataLen(blk));
+    memset(IndexBlock_DataBuf(blk) + IndexBlock_DataLen(blk), 0, len - IndexBlock_DataLen(blk));
+    blk->buf.offset = len;
+  }
+  BITMAP_SET(BITMAP_WORDS(blk), bit);
+  return grew;
+}
+
+// Initialize `buf` as an empty bitmap covering `range` ids
+static void Bitmap_Init(Buffer *buf, size_t range) {
+  const size_t len = BITMAP_BYTES(range);
+  Buffer_Init(buf, len);
+  memset(buf->data, 0, len);
+  buf->offset = len;
+}
+
+// Turn a full block of doc ids (written by `encodeDocIdsOnly`) into a bitmap block. The bitmap is
+// written over the deltas in the block's own buffer, so the block keeps its allocations and the
+// memory the writer reports stays exact. Returns the number of bytes the buffer grew by
+static size_t IndexBlock_ConvertToBitmap(IndexBlock *blk) {
+  const size_t len = BITMAP_BYTES(blk->lastId - blk->firstId + 1);
+  uint64_t *words = rm_calloc(1, len);
+  BufferReader br = NewBufferReader(&blk->buf);
+  Buffer_Seek(&br, IndexBlock_EntriesOffset(blk));
+  t_docId id = blk->firstId;
+  for (uint16_t i = 0; i < blk->numEntries; i++) {
+    id += ReadVarint(&br);
+    BITMAP_SET(words, id - blk->firstId);
+  }
+  blk->buf.offset = 0;
+  size_t grew = Buffer_Reserve(&blk->buf, len);
+  memcpy(IndexBlock_DataBuf(blk), words, len);
+  blk->buf.offset = len;
+  rm_free(words);
+  // Bitmaps are searched directly, so the checkpoints are written over as well
+  blk->flags = (blk->flags | IndexBlock_Bitmap) & ~IndexBlock_WithSkips;
+  return grew;
+}
+
+void IndexBlock_DecodeBitmap(const IndexBlock *blk, Buffer *out) {
+  out->offset = 0;
+  Buffer_Reserve(out, blk->numEntries);  // Most deltas of a dense block take a single byte
+  BufferWriter bw = NewBufferWriter(out);
+  const uint64_t *words = BITMAP_WORDS(blk);
+  t_docId prevId = blk->firstId;
+  for (size_t i = 0; i < BITMAP_NUM_WORDS(blk); i++) {
+    for (uint64_t w = words[i]; w; w &= w - 1) {
+      const t_docId id = blk->firstId + i * 64 + __builtin_ctzll(w);
+      WriteVarint(id - prevId, &bw);
+      prevId = id;
+    }
+  }
+}
+
+t_docId IndexBlock_BitmapNext(const IndexBlock *blk, t_docId docId) {
+  if (docId < blk->firstId) {
+    docId = blk->firstId;
+  } else if (docId > blk->lastId) {
+    return 0;
+  }
+  const uint64_t *words = BITMAP_WORDS(blk);
+  const size_t bit = docId - blk->firstId;
+  size_t i = bit / 64;
+  uint64_t w = words[i] & (~0ULL << (bit % 64));
+  while (!w) {
+    if (++i == BITMAP_NUM_WORDS(blk)) {
+      return 0;
+    }
+    w = words[i];
+  }
+  return blk->firstId + i * 64 + __builtin_ctzll(w);
+}
+
+uint64_t IndexBlock_BitmapWord(const IndexBlock *blk, t_docId docId) {
+  const uint64_t *words = BITMAP_WORDS(blk);
+  if (docId > blk->lastId || docId + 64 <= blk->firstId) {
+    return 0;
+  } else if (docId < blk->firstId) {
+    return words[0] << (blk->firstId - docId);
+  }
+  const size_t bit = docId - blk->firstId;
+  const size_t i = bit / 64, shift = bit % 64;
+  uint64_t w = words[i] >> shift;
+  if (shift && i + 1 < BITMAP_NUM_WORDS(blk)) {
+    w |= words[i + 1] << (64 - shift);
+  }
+  return w;
+}
+
 /* Write a forward-index entry to an index writer */
-size_t InvertedIndex_WriteEntryGeneric(InvertedIndex *idx, IndexEncoder encoder, t_docId docId,
-                                       RSIndexResult *entry) {
+static size_t InvertedIndex_WriteEntry(InvertedIndex *idx, IndexEncoder encoder, t_docId docId,
+                                       RSIndexResult *entry, uint32_t docLen) {
   size_t sz = 0;
   bool same_doc = 0;
   if (idx->lastId && idx->lastId == docId) {
@@ -472,40 +753,78 @@ size_t InvertedIndex_WriteEntryGeneric(InvertedIndex *idx, IndexEncoder encoder,
   t_docId delta = 0;
   IndexBlock *blk = &INDEX_LAST_BLOCK(idx);
 
-  // use proper block size. Index_DocIdsOnly == 0x00
-  uint16_t blockSize = (idx->flags & INDEX_STORAGE_MASK) ?
-          INDEX_BLOCK_SIZE :
-          INDEX_BLOCK_SIZE_DOCID_ONLY;
-
   // see if we need to grow the current block
-  if (blk->numEntries >= blockSize && !same_doc) {
-    // If same doc can span more than a single block - need to adjust IndexReader_SkipToBlock
-    blk = InvertedIndex_AddBlock(idx, docId, &sz);
+  if (IndexBlock_IsBitmap(blk)) {
+    // A bitmap block takes more entries as long as it stays dense
+    if (!BITMAP_IS_DENSE(docId - blk->firstId + 1, blk->numEntries + 1)) {
+      blk = InvertedIndex_AddBlock(idx, docId, &sz);
+    }
+  } else if ((blk->numEntries >= IndexBlock_Capacity(blk, idx->flags) ||
+              IndexBlock_DataLen(blk) >= INDEX_BLOCK_MAX_BYTES) && !same_doc) {
+    if (encoder == encodeDocIdsOnly && BITMAP_IS_DENSE(docId - blk->firstId + 1, blk->numEntries + 1)) {
+      // A dense block of doc ids is turned into a bitmap instead, which takes the new entry as well
+      sz += IndexBlock_ConvertToBitmap(blk);
+    } else {
+      // If same doc can span more than a single block - need to adjust IndexReader_SkipToBlock
+      blk = InvertedIndex_AddBlock(idx, docId, &sz);
+    }
   } else if (blk->numEntries == 0) {
     blk->firstId = blk->lastId = docId;
   }
 
-  if (encoder != encodeRawDocIdsOnly) {
-    delta = docId - blk->lastId;
+  if (IndexBlock_IsBitmap(blk)) {
+    sz += IndexBlock_BitmapAdd(blk, docId);
   } else {
-    delta = docId - blk->firstId;
-  }
+    if (encoder != encodeRawDocIdsOnly) {
+      delta = docId - blk->lastId;
+    } else {
+      delta = docId - blk->firstId;
+    }
 
-  // For non-numeric encoders the maximal delta is UINT32_MAX (since it is encoded with 4 bytes)
-  // For numeric encoder the maximal delta has to fit in 7 bytes (since it is encoded with 0-7 bytes)
-  const t_docId maxDelta = encoder == encodeNumeric ? (UINT64_MAX >> 8) : UINT32_MAX;
-  if (delta > maxDelta) {
-    blk = InvertedIndex_AddBlock(idx, docId, &sz);
-    delta = 0;
-  }
+    // For non-numeric encoders the maximal delta is UINT32_MAX (since it is encoded with 4 bytes)
+    // For numeric encoder the maximal delta has to fit in 7 bytes (since it is encoded with 0-7 bytes)
+    // Packed blocks are decoded into offsets from the first id, so these must fit in 4 bytes as well
+    const t_docId maxDelta = encoder == encodeNumeric ? (UINT64_MAX >> 8) : UINT32_MAX;
+    if (delta > maxDelta || (IS_PACKED_ENCODER(encoder) && docId - blk->firstId > maxDelta)) {
+      blk = InvertedIndex_AddBlock(idx, docId, &sz);
+      delta = 0;
+    }
 
-  BufferWriter bw = NewBufferWriter(&blk->buf);
+    if (HAS_SKIP_CHECKPOINTS(encoder)) {
+      const uint16_t blockSize = IndexBlock_Capacity(blk, idx->flags);
+      if (blk->numEntries == 0) {
+        sz += IndexBlock_ReserveSkips(blk, blockSize);
+      }
+      IndexBlock_UpdateSkips(IndexBlock_Skips(blk), blk->firstId, blockSize, blk->numEntries,
+                             blk->lastId, IndexBlock_DataLen(blk));
+    }
+
+    BufferWriter bw = NewBufferWriter(&blk->buf);
 
-  sz += encoder(&bw, delta, entry);
+    sz += encoder(&bw, delta, entry);
+  }
 
   idx->lastId = docId;
   blk->lastId = docId;
   ++blk->numEntries;
+  if (IS_PACKED_ENCODER(encoder) && blk->numEntries % GROUP_VARINT_SIZE == 0) {
+    sz += IndexBlock_PackLastGroup(blk, encoder == encodePackedFreqs);
+  }
+  // Keep the score bounds of the block. The frequency of an entry written without a record is
+  // unknown, and an unknown frequency stays so, as the block may hold entries of any frequency (e.g.
+  // if it was loaded from RDB)
+  const uint8_t freq = entry ? MIN(entry->freq, UINT8_MAX) : 0;
+  if (blk->numEntries == 1) {
+    blk->maxFreq = freq;
+    blk->minDocLen = MIN(docLen, UINT16_MAX);
+  } else {
+    if (!entry || (blk->maxFreq && freq > blk->maxFreq)) {
+      blk->maxFreq = freq;
+    }
+    if (docLen < blk->minDocLen) {
+      blk->minDocLen = docLen;
+    }
+  }
   if (!same_doc) {
     ++idx->numDocs;
   }
@@ -516,6 +835,33 @@ size_t InvertedIndex_WriteEntryGeneric(InvertedIndex *idx, IndexEncoder encoder,
   return sz;
 }
 
+size_t InvertedIndex_WriteEntryGeneric(InvertedIndex *idx, IndexEncoder encoder, t_docId docId,
+                                       RSIndexResult *entry) {
+  return InvertedIndex_WriteEntry(idx, encoder, docId, entry, 0);
+}
+
+size_t InvertedIndex_WriteEntryWithDocLen(InvertedIndex *idx, IndexEncoder encoder, t_docId docId,
+                                          RSIndexResult *entry, uint32_t docLen) {
+  return InvertedIndex_WriteEntry(idx, encoder, docId, entry, docLen);
+}
+
+// The constants of the standard BM25 scorer (see `bm25StdRecursive` in ext/default.c)
+#define BM25_STD_B 0.75f
+#define BM25_STD_K1 1.2f
+
+double IndexBlock_MaxScore(const IndexBlock *blk, const BlockMaxScoreCtx *ctx) {
+  if (!blk->maxFreq || blk->maxFreq == UINT8_MAX) {
+    // The frequency is unknown or saturated. The score is bound by its limit as the frequency grows
+    return ctx->weight * ctx->idf * (BM25_STD_K1 + 1);
+  }
+  // The BM25 term score grows with the frequency and shrinks with the document length, so the
+  // block's extremes bound the scores of all of its entries. The expression follows the scorer's,
+  // so rounding cannot take the score of an entry past it
+  const double f = blk->maxFreq;
+  return ctx->weight * ctx->idf * f * (BM25_STD_K1 + 1) /
+         (f + BM25_STD_K1 * (1.0f - BM25_STD_B + BM25_STD_B * (float)blk->minDocLen / ctx->avgDocLen));
+}
+
 /* Write a numeric entry to the index */
 size_t InvertedIndex_WriteNumericEntry(InvertedIndex *idx, t_docId docId, double value) {
 
@@ -527,10 +873,35 @@ size_t InvertedIndex_WriteNumericEntry(InvertedIndex *idx, t_docId docId, double
   return InvertedIndex_WriteEntryGeneric(idx, encodeNumeric, docId, &rec);
 }
 
+// Start reading the current block from its beginning
+static void IndexReader_SetBlockReader(IndexReader *ir) {
+  ir->lastId = IR_CURRENT_BLOCK(ir).firstId;
+  if (IndexBlock_IsBitmap(&IR_CURRENT_BLOCK(ir))) {
+    // An unset buffer reader tells that the bitmap is searched from the start
+    ir->bitmapNextId = ir->lastId;
+    ir->br = (BufferReader){0};
+    return;
+  }
+  ir->br = IR_CURRENT_BLOCK_READER(ir);
+}
+
 static void IndexReader_AdvanceBlock(IndexReader *ir) {
   ir->currentBlock++;
-  ir->br = NewBufferReader(&IR_CURRENT_BLOCK(ir).buf);
-  ir->lastId = IR_CURRENT_BLOCK(ir).firstId;
+  IndexReader_SetBlockReader(ir);
+}
+
+// Move to the next block to read, passing over the blocks whose entries cannot score above the
+// threshold, if one is set (see `scoreThreshold`). Returns false if there is no such block left
+static bool IndexReader_NextBlock(IndexReader *ir) {
+  do {
+    if (ir->currentBlock + 1 == ir->idx->size) {
+      return false;
+    }
+    ir->currentBlock++;
+  } while (ir->scoreThreshold &&
+           IndexBlock_MaxScore(&IR_CURRENT_BLOCK(ir), &ir->scoreCtx) < *ir->scoreThreshold);
+  IndexReader_SetBlockReader(ir);
+  return true;
 }
 
 /******************************************************************************
@@ -799,6 +1170,143 @@ DECODER(readDocIdsOnly) {
   return 1;  // Don't care about field mask
 }
 
+/* Packed blocks are decoded a group at a time into raw entries - the offset of each doc id from the
+ * block's first id, followed by its frequency if stored. Packed doc ids are then read with the raw
+ * doc ids decoder */
+#define PACKED_FREQS_ENTRY_SIZE (2 * sizeof(uint32_t))
+
+// Decode the group of a packed block starting at byte `*pos` into `out`, adding up its doc id deltas
+// from `*base`. Both are moved past the group. The entries of the last partial group are raw.
+// Returns the number of entries decoded, or 0 at the end of the block
+static size_t decodePackedGroup(const IndexBlock *blk, size_t *pos, uint32_t *base, uint32_t *out,
+                                bool withFreqs) {
+  const size_t entrySize = withFreqs ? PACKED_FREQS_ENTRY_SIZE : sizeof(uint32_t);
+  const size_t len = IndexBlock_DataLen(blk);
+  const size_t rawStart = len - (blk->numEntries % GROUP_VARINT_SIZE) * entrySize;
+  const uint8_t *start = (const uint8_t *)IndexBlock_DataBuf(blk);
+  const uint8_t *p = start + *pos, *end = start + len;
+
+  if (*pos < rawStart) {
+    if (!withFreqs) {
+      p += GroupVarint_DecodeDeltas(p, end - p, base, out);
+    } else {
+      uint32_t offsets[GROUP_VARINT_SIZE], freqs[GROUP_VARINT_SIZE];
+      p += GroupVarint_DecodeDeltas(p, end - p, base, offsets);
+      p += GroupVarint_Decode(p, end - p, freqs);
+      for (int i = 0; i < GROUP_VARINT_SIZE; i++) {
+        *out++ = offsets[i];
+        *out++ = freqs[i];
+      }
+    }
+    *pos = p - start;
+    return GROUP_VARINT_SIZE;
+  }
+
+  size_t n = 0;
+  for (; p < end; p += entrySize, n++) {
+    uint32_t delta;
+    memcpy(&delta, p, sizeof(delta));
+    *base += delta;
+    *out++ = *base;
+    if (withFreqs) {
+      memcpy(out++, p + sizeof(uint32_t), sizeof(uint32_t));
+    }
+  }
+  *pos = p - start;
+  return n;
+}
+
+// Decode all the entries of a packed block into `out`
+static void decodePackedBlock(const IndexBlock *blk, Buffer *out, bool withFreqs) {
+  const size_t entryWords = withFreqs ? 2 : 1;
+  const size_t len = blk->numEntries * entryWords * sizeof(uint32_t);
+  if (out->cap < len) {
+    out->data = rm_realloc(out->data, len);
+    out->cap = len;
+  }
+  out->offset = len;
+
+  uint32_t *dst = (uint32_t *)out->data;
+  size_t pos = IndexBlock_EntriesOffset(blk), n;
+  uint32_t base = 0;
+  while ((n = decodePackedGroup(blk, &pos, &base, dst, withFreqs))) {
+    dst += n * entryWords;
+  }
+}
+
+static size_t decodeNextPackedGroup(const IndexBlock *blk, DecodedBlock *decoded, bool withFreqs) {
+  Buffer *records = &decoded->records;
+  if (!records->cap) {
+    records->cap = GROUP_VARINT_SIZE * PACKED_FREQS_ENTRY_SIZE;
+    records->data = rm_malloc(records->cap);
+  }
+  size_t pos = decoded->nextPos;
+  uint32_t base = decoded->nextBase;
+  const size_t n = decodePackedGroup(blk, &pos, &base, (uint32_t *)records->data, withFreqs);
+  if (n) {
+    decoded->groupPos = decoded->nextPos;
+    decoded->groupBase = decoded->nextBase;
+    decoded->nextPos = pos;
+    decoded->nextBase = base;
+    records->offset = n * (withFreqs ? PACKED_FREQS_ENTRY_SIZE : sizeof(uint32_t));
+  }
+  return n;
+}
+
+static size_t decodePackedDocIds(const IndexBlock *blk, DecodedBlock *decoded) {
+  return decodeNextPackedGroup(blk, decoded, false);
+}
+
+static size_t decodePackedFreqs(const IndexBlock *blk, DecodedBlock *decoded) {
+  return decodeNextPackedGroup(blk, decoded, true);
+}
+
+DECODER(readPackedFreqs) {
+  uint32_t offset;
+  Buffer_Read(&blockReader->buffReader, &offset, sizeof offset);
+  Buffer_Read(&blockReader->buffReader, &res->freq, sizeof res->freq);
+  res->docId = offset + blockReader->curBaseId; // Base ID is the block's first id, as for raw doc ids
+  return 1;  // Don't care about field mask
+}
+
+// Binary search the decoded entries of the current group, of `entryWords` words each, for the first
+// one not smaller than `expid`. Unlike raw doc id blocks, the group may not have one
+static bool seekPackedEntries(IndexBlockReader *blockReader, t_docId expid, RSIndexResult *res,
+                              size_t entryWords) {
+  BufferReader *br = &blockReader->buffReader;
+  const size_t entrySize = entryWords * sizeof(uint32_t);
+  const uint32_t *entries = (const uint32_t *)br->buf->data;
+  const t_docId target = expid > blockReader->curBaseId ? expid - blockReader->curBaseId : 0;
+  const size_t numEntries = Buffer_Offset(br->buf) / entrySize;
+  size_t lo = BufferReader_Offset(br) / entrySize;
+  size_t hi = numEntries;
+  while (lo < hi) {
+    size_t mid = (lo + hi) / 2;
+    if (entries[entryWords * mid] < target) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo == numEntries) {
+    // All the remaining entries are smaller than the requested id
+    Buffer_Seek(br, Buffer_Offset(br->buf));
+    return 0;
+  }
+  Buffer_Seek(br, (lo + 1) * entrySize);
+  res->docId = entries[entryWords * lo] + blockReader->curBaseId;
+  res->freq = entryWords > 1 ? entries[entryWords * lo + 1] : 1;
+  return 1;
+}
+
+SKIPPER(seekPackedDocIds) {
+  return seekPackedEntries(blockReader, expid, res, 1);
+}
+
+SKIPPER(seekPackedFreqs) {
+  return seekPackedEntries(blockReader, expid, res, 2);
+}
+
 // Wrapper around the private static `readNumeric` function to expose it to benchmarking
 bool read_numeric(IndexBlockReader *blockReader, const IndexDecoderCtx *ctx, RSIndexResult *res) {
   readNumeric(blockReader, ctx, res);
@@ -811,6 +1319,22 @@ IndexDecoderProcs InvertedIndex_GetDecoder(uint32_t flags) {
   return procs;
 
   IndexDecoderProcs procs = {0};
+  if (flags & Index_StorePacked) {
+    switch (flags & INDEX_STORAGE_MASK) {
+      case Index_DocIdsOnly:
+        procs.blockDecoder = decodePackedDocIds;
+        RETURN_DECODERS(readRawDocIdsOnly, seekPackedDocIds);
+
+      case Index_StoreFreqs:
+        procs.blockDecoder = decodePackedFreqs;
+        RETURN_DECODERS(readPackedFreqs, seekPackedFreqs);
+
+      default:
+        RS_LOG_ASSERT_FMT(0, "Invalid packed index flags: %d", flags);
+        RETURN_DECODERS(NULL, NULL);
+    }
+  }
+
   switch (flags & INDEX_STORAGE_MASK) {
 
     // (freqs, fields, offset)
@@ -870,6 +1394,78 @@ IndexDecoderProcs InvertedIndex_GetDecoder(uint32_t flags) {
   }
 }
 
+BufferReader IndexBlock_NewReader(IndexBlock *blk, const IndexDecoderProcs *decoders,
+                                  DecodedBlock *scratch) {
+  RS_ASSERT(!IndexBlock_IsBitmap(blk));
+  if (!decoders->blockDecoder) {
+    BufferReader br = NewBufferReader(&blk->buf);
+    Buffer_Seek(&br, IndexBlock_EntriesOffset(blk));
+    return br;
+  }
+  scratch->records.offset = 0;
+  scratch->groupPos = scratch->nextPos = IndexBlock_EntriesOffset(blk);
+  scratch->groupBase = scratch->nextBase = 0;
+  decoders->blockDecoder(blk, scratch);
+  return NewBufferReader(&scratch->records);
+}
+
+bool IndexBlock_NextGroup(const IndexBlock *blk, const IndexDecoderProcs *decoders,
+                          DecodedBlock *scratch, BufferReader *br) {
+  if (!decoders->blockDecoder || !decoders->blockDecoder(blk, scratch)) {
+    return false;
+  }
+  *br = NewBufferReader(&scratch->records);
+  return true;
+}
+
+// The last skip checkpoint of the block starting past byte `pos` whose preceding entry is smaller
+// than `docId`, or -1 if there is none
+static int IndexBlock_FindSkip(const IndexBlock *blk, size_t pos, t_docId docId) {
+  const IndexBlockSkips *skips = IndexBlock_Skips(blk);
+  if (!skips) {
+    return -1;
+  }
+  for (int i = INDEX_BLOCK_NUM_SKIPS - 1; i >= 0; i--) {
+    const uint32_t offset = skips->offsets[i];
+    if (!offset) {
+      continue;  // Unused checkpoint
+    }
+    if (offset <= pos) {
+      return -1;  // This checkpoint and all the ones before it are behind the reader
+    }
+    if (blk->firstId + skips->baseIds[i] < docId) {
+      // All the entries before the checkpoint are smaller than the requested id
+      return i;
+    }
+  }
+  return -1;
+}
+
+bool IndexBlock_SkipTo(const IndexBlock *blk, const IndexDecoderProcs *decoders,
+                       DecodedBlock *scratch, IndexBlockReader *reader, t_docId docId) {
+  if (decoders->blockDecoder) {
+    // The groups up to the next one are decoded already
+    const int i = IndexBlock_FindSkip(blk, scratch->nextPos, docId);
+    if (i < 0) {
+      return false;
+    }
+    const IndexBlockSkips *skips = IndexBlock_Skips(blk);
+    scratch->nextPos = skips->offsets[i];
+    scratch->nextBase = skips->baseIds[i];
+    decoders->blockDecoder(blk, scratch);
+    reader->buffReader = NewBufferReader(&scratch->records);
+    return true;
+  }
+  const int i = IndexBlock_FindSkip(blk, BufferReader_Offset(&reader->buffReader), docId);
+  if (i < 0) {
+    return false;
+  }
+  const IndexBlockSkips *skips = IndexBlock_Skips(blk);
+  Buffer_Seek(&reader->buffReader, skips->offsets[i]);
+  reader->curBaseId = blk->firstId + skips->baseIds[i];
+  return true;
+}
+
 IndexReader *NewNumericReader(const RedisSearchCtx *sctx, InvertedIndex *idx, const NumericFilter *flt,
                               double rangeMin, double rangeMax, bool skipMulti,
                               const FieldFilterContext* fieldCtx) {
@@ -897,6 +1493,23 @@ size_t IR_NumEstimated(void *ctx) {
   return ir->idx->numDocs;
 }
 
+size_t IR_EstimateMatches(const IndexReader *ir) {
+  size_t numDocs = ir->idx->numDocs;
+  const NumericFilter *f = ir->decoders.decoder == readNumeric ? ir->decoderCtx.filter : NULL;
+  if (!f || !NumericFilter_IsNumeric(f) || numDocs <= 1) {
+    return numDocs;
+  }
+  double rangeMin = ir->profileCtx.numeric.rangeMin, rangeMax = ir->profileCtx.numeric.rangeMax;
+  if (rangeMax <= rangeMin) {
+    return numDocs;
+  }
+  double lo = f->min > rangeMin ? f->min : rangeMin;
+  double hi = f->max < rangeMax ? f->max : rangeMax;
+  double ratio = hi > lo ? (hi - lo) / (rangeMax - rangeMin) : 0;
+  size_t estimate = (size_t)(numDocs * ratio) + 1;
+  return estimate < numDocs ? estimate : numDocs;
+}
+
 #define FIELD_MASK_BIT_COUNT (sizeof(t_fieldMask) * 8)
 
 // Used to determine if the field mask for the given doc id are valid based on their ttl:
@@ -939,29 +1552,37 @@ int IR_Read(void *ctx, RSIndexResult **e) {
   do {
 
     // if needed - skip to the next block (skipping empty blocks that may appear here due to GC)
-    while (BufferReader_AtEnd(&ir->br)) {
+    while (IR_BLOCK_AT_END(ir)) {
       RS_LOG_ASSERT_FMT(ir->currentBlock < ir->idx->size, "Current block %d is out of bounds %d",
                         ir->currentBlock, ir->idx->size);
-      if (ir->currentBlock + 1 == ir->idx->size) {
+      if (!IndexReader_NextBlock(ir)) {
         // We're at the end of the last block...
         goto eof;
       }
-      IndexReader_AdvanceBlock(ir);
     }
 
-    IndexBlockReader reader = (IndexBlockReader){
-      .buffReader = ir->br,
-      .curBaseId = (ir->decoders.decoder != readRawDocIdsOnly) ? ir->lastId : IR_CURRENT_BLOCK(ir).firstId,
-    };
-    int rv = ir->decoders.decoder(&reader, &ir->decoderCtx, ir->record);
     RSIndexResult *record = ir->record;
-    ir->lastId = record->docId;
-    ir->br = reader.buffReader;
-
-    // The decoder also acts as a filter. A zero return value means that the
-    // current record should not be processed.
-    if (!rv) {
-      continue;
+    if (IndexBlock_IsBitmap(&IR_CURRENT_BLOCK(ir))) {
+      // Bitmap blocks hold doc ids only, so there is nothing to decode or filter. The last id of the
+      // block is always set, so there is a next id
+      record->docId = IndexBlock_BitmapNext(&IR_CURRENT_BLOCK(ir), ir->bitmapNextId);
+      record->freq = 1;
+      ir->bitmapNextId = record->docId + 1;
+      ir->lastId = record->docId;
+    } else {
+      IndexBlockReader reader = (IndexBlockReader){
+        .buffReader = ir->br,
+        .curBaseId = IR_DELTAS_FROM_FIRST_ID(ir) ? IR_CURRENT_BLOCK(ir).firstId : ir->lastId,
+      };
+      int rv = ir->decoders.decoder(&reader, &ir->decoderCtx, record);
+      ir->lastId = record->docId;
+      ir->br = reader.buffReader;
+
+      // The decoder also acts as a filter. A zero return value means that the
+      // current record should not be processed.
+      if (!rv) {
+        continue;
+      }
     }
 
     if (ir->skipMulti) {
@@ -989,6 +1610,64 @@ eof:
   return INDEXREAD_EOF;
 }
 
+// Read the ids set in a bitmap block from `*nextId` on into `out`, up to `cap` of them, and move
+// `*nextId` past the last one read
+static size_t IndexBlock_BitmapRead(const IndexBlock *blk, t_docId *nextId, t_docId *out,
+                                    size_t cap) {
+  if (*nextId < blk->firstId) {
+    *nextId = blk->firstId;
+  }
+  const uint64_t *words = BITMAP_WORDS(blk);
+  const size_t bit = *nextId - blk->firstId, nwords = BITMAP_NUM_WORDS(blk);
+  size_t i = bit / 64, count = 0;
+  if (i >= nwords || !cap) {
+    return 0;
+  }
+  uint64_t w = words[i] & (~0ULL << (bit % 64));
+  while (count < cap) {
+    while (!w) {
+      if (++i == nwords) {
+        *nextId = blk->lastId + 1;
+        return count;
+      }
+      w = words[i];
+    }
+    out[count++] = blk->firstId + i * 64 + __builtin_ctzll(w);
+    w &= w - 1;
+  }
+  *nextId = out[count - 1] + 1;
+  return count;
+}
+
+int IR_ReadBatch(void *ctx, t_docId *out, size_t cap, size_t *n) {
+  IndexReader *ir = ctx;
+  // Bitmap blocks are read a word at a time, unless their ids have to be filtered one by one
+  const bool filtered = ir->skipMulti || (ir->sctx && ir->sctx->spec && ir->sctx->spec->docs.ttl);
+  size_t count = 0;
+  int rc = INDEXREAD_OK;
+  while (count < cap) {
+    if (!filtered && !IR_IS_AT_END(ir) && IndexBlock_IsBitmap(&IR_CURRENT_BLOCK(ir))) {
+      size_t read = IndexBlock_BitmapRead(&IR_CURRENT_BLOCK(ir), &ir->bitmapNextId, out + count,
+                                          cap - count);
+      if (read) {
+        count += read;
+        ir->len += read;
+        ir->lastId = ir->record->docId = out[count - 1];
+        ir->record->freq = 1;
+        continue;
+      }
+    }
+    RSIndexResult *r;
+    rc = IR_Read(ir, &r);
+    if (rc != INDEXREAD_OK) {
+      break;
+    }
+    out[count++] = r->docId;
+  }
+  *n = count;
+  return count < cap ? rc : INDEXREAD_OK;
+}
+
 #define BLOCK_MATCHES(blk, docId) ((blk).firstId <= docId && docId <= (blk).lastId)
 
 // Will use the seeker to reach a valid doc id that is greater or equal to the requested doc id
@@ -1001,7 +1680,7 @@ static bool IndexReader_ReadWithSeeker(IndexReader *ir, t_docId docId) {
     // try and find docId using seeker
     IndexBlockReader reader = (IndexBlockReader){
       .buffReader = ir->br,
-      .curBaseId = (ir->decoders.decoder != readRawDocIdsOnly) ? ir->lastId : IR_CURRENT_BLOCK(ir).firstId,
+      .curBaseId = IR_DELTAS_FROM_FIRST_ID(ir) ? IR_CURRENT_BLOCK(ir).firstId : ir->lastId,
     };
     found = ir->decoders.seeker(&reader, &ir->decoderCtx, docId, ir->record);
     ir->br = reader.buffReader;
@@ -1021,7 +1700,7 @@ static bool IndexReader_ReadWithSeeker(IndexReader *ir, t_docId docId) {
 
     // if found is true we found a doc id that is greater or equal to the searched doc id
     // if found is false we need to continue scanning the inverted index, possibly advancing to the next block
-    if (!found && BufferReader_AtEnd(&ir->br)) {
+    if (!found && IR_BLOCK_AT_END(ir)) {
       if (ir->currentBlock < ir->idx->size - 1) {
         // We reached the end of the current block but we have more blocks to advance to
         // advance to the next block and continue the search using the seeker from there
@@ -1077,8 +1756,7 @@ static void IndexReader_SkipToBlock(IndexReader *ir, t_docId docId) {
 
 new_block:
   RS_LOG_ASSERT(ir->currentBlock < idx->size, "Invalid block index");
-  ir->lastId = IR_CURRENT_BLOCK(ir).firstId;
-  ir->br = NewBufferReader(&IR_CURRENT_BLOCK(ir).buf);
+  IndexReader_SetBlockReader(ir);
 }
 
 int IR_SkipTo(void *ctx, t_docId docId, RSIndexResult **hit) {
@@ -1099,7 +1777,7 @@ int IR_SkipTo(void *ctx, t_docId docId, RSIndexResult **hit) {
     // We know that `docId <= idx->lastId`, so there must be a following block that contains the
     // lastId, which either contains the requested docId or higher ids. We can skip to it.
     IndexReader_SkipToBlock(ir, docId);
-  } else if (BufferReader_AtEnd(&ir->br)) {
+  } else if (IR_BLOCK_AT_END(ir)) {
     // Current block, but there's nothing here
     if (IR_Read(ir, hit) == INDEXREAD_EOF) {
       goto eof;
@@ -1108,6 +1786,25 @@ int IR_SkipTo(void *ctx, t_docId docId, RSIndexResult **hit) {
     }
   }
 
+  if (IndexBlock_IsBitmap(&IR_CURRENT_BLOCK(ir))) {
+    // Bitmap blocks are searched directly from the requested id. The block's last id is not smaller
+    // than the requested id, so reading finds an id in this block, unless it is filtered out
+    if (docId > ir->bitmapNextId) {
+      ir->bitmapNextId = docId;
+    }
+    if (IR_Read(ir, hit) == INDEXREAD_EOF) {
+      return INDEXREAD_EOF;
+    }
+    return (ir->lastId == docId) ? INDEXREAD_OK : INDEXREAD_NOTFOUND;
+  }
+
+  // Skip the entries of the block that are known to be smaller than the requested id
+  IndexBlockReader reader = { .buffReader = ir->br, .curBaseId = ir->lastId };
+  if (IndexBlock_SkipTo(&IR_CURRENT_BLOCK(ir), &ir->decoders, &ir->decodedBlock, &reader, docId)) {
+    ir->br = reader.buffReader;
+    ir->lastId = reader.curBaseId;
+  }
+
   /**
    * We need to replicate the effects of IR_Read() without actually calling it
    * continuously.
@@ -1168,15 +1865,17 @@ static void IndexReader_Init(const RedisSearchCtx *sctx, IndexReader *ret, Inver
   ret->gcMarker = idx->gcMarker;
   ret->record = record;
   ret->len = 0;
-  ret->lastId = IR_CURRENT_BLOCK(ret).firstId;
   ret->sameId = 0;
   ret->skipMulti = skipMulti;
-  ret->br = NewBufferReader(&IR_CURRENT_BLOCK(ret).buf);
   ret->decoders = decoder;
+  ret->decodedBlock = (DecodedBlock){0};
+  IndexReader_SetBlockReader(ret);
   ret->decoderCtx = decoderCtx;
   ret->filterCtx = *filterCtx;
   ret->isValidP = NULL;
   ret->sctx = sctx;
+  ret->scoreCtx = (BlockMaxScoreCtx){0};
+  ret->scoreThreshold = NULL;
   IR_SetAtEnd(ret, 0);
 }
 
@@ -1244,6 +1943,7 @@ IndexReader *NewGenericIndexReader(InvertedIndex *idx, const RedisSearchCtx *sct
 void IR_Free(IndexReader *ir) {
 
   IndexResult_Free(ir->record);
+  Buffer_Free(&ir->decodedBlock.records);
   rm_free(ir);
 }
 
@@ -1270,8 +1970,7 @@ void IR_Rewind(void *ctx) {
   IR_SetAtEnd(ir, 0);
   ir->currentBlock = 0;
   ir->gcMarker = ir->idx->gcMarker;
-  ir->br = NewBufferReader(&IR_CURRENT_BLOCK(ir).buf);
-  ir->lastId = IR_CURRENT_BLOCK(ir).firstId;
+  IndexReader_SetBlockReader(ir);
   ir->sameId = 0;
 }
 
@@ -1281,6 +1980,7 @@ IndexIterator *NewReadIterator(IndexReader *ir) {
   ri->type = READ_ITERATOR;
   ri->NumEstimated = IR_NumEstimated;
   ri->Read = IR_Read;
+  ri->ReadBatch = IR_ReadBatch;
   ri->SkipTo = IR_SkipTo;
   ri->LastDocId = IR_LastDocId;
   ri->Free = ReadIterator_Free;
@@ -1295,6 +1995,234 @@ IndexIterator *NewReadIterator(IndexReader *ir) {
   return ri;
 }
 
+bool IR_MayHaveBitmaps(const IndexReader *ir) {
+  // Only doc ids written with the (non raw) varint encoding are turned into bitmaps
+  return (ir->idx->flags & (INDEX_STORAGE_MASK | Index_StorePacked)) == Index_DocIdsOnly &&
+         !ir->decoders.seeker;
+}
+
+// Return the block of the reader's index holding `docId` (or the first id following it), or NULL if
+// `docId` is past the end of the index. Does not move the reader
+static const IndexBlock *IndexReader_FindBlock(const IndexReader *ir, t_docId docId) {
+  const InvertedIndex *idx = ir->idx;
+  if (docId > idx->lastId || idx->size == 0) {
+    return NULL;
+  }
+  // Most of the time the current block is the one. Otherwise, find the first following block whose
+  // last id is not smaller than `docId`
+  uint32_t bottom = ir->currentBlock;
+  uint32_t top = idx->size - 1;
+  while (bottom < top && idx->blocks[bottom].lastId < docId) {
+    uint32_t i = (bottom + top) / 2;
+    if (idx->blocks[i].lastId < docId) {
+      bottom = i + 1;
+    } else {
+      top = i;
+    }
+  }
+  return idx->blocks + bottom;
+}
+
+const IndexBlock *IR_BitmapBlock(const IndexReader *ir, t_docId docId) {
+  const IndexBlock *blk = IndexReader_FindBlock(ir, docId);
+  return blk && IndexBlock_IsBitmap(blk) ? blk : NULL;
+}
+
+// The bounds are compared to the scores of the top results, which the scorer computes in a
+// different order. Leave room for the rounding of the sums
+#define SCORE_BOUND_MARGIN (1 + 1e-6)
+
+bool IR_SetScoreBounds(IndexReader *ir, double avgDocLen, double maxDocScore) {
+  const RSIndexResult *record = ir->record;
+  if (record->type != RSResultType_Term || !record->data.term.term || avgDocLen <= 0 ||
+      record->weight < 0 || record->data.term.term->bm25_idf < 0) {
+    return false;
+  }
+  ir->scoreCtx = (BlockMaxScoreCtx){
+      .idf = record->data.term.term->bm25_idf,
+      .weight = record->weight * MAX(maxDocScore, 0) * SCORE_BOUND_MARGIN,
+      .avgDocLen = avgDocLen,
+  };
+  return true;
+}
+
+bool IR_BlockMaxScore(const IndexReader *ir, t_docId docId, t_docId *firstId, t_docId *lastId,
+                      double *bound) {
+  const IndexBlock *blk = IR_IS_AT_END(ir) ? NULL : IndexReader_FindBlock(ir, docId);
+  if (!blk) {
+    return false;
+  }
+  // The entries of the reader past the ones it read are in the blocks from its current one on, so
+  // it has none between `docId` and the found block
+  *firstId = MAX(docId, blk->firstId);
+  *lastId = blk->lastId;
+  *bound = IndexBlock_MaxScore(blk, &ir->scoreCtx);
+  return true;
+}
+
+// Append an entry to a packed block that is being rebuilt, taking its skip checkpoints if
+// `withSkips` is set (and its capacity is large enough)
+static void IndexBlock_AppendPacked(IndexBlock *blk, IndexEncoder encoder, RSIndexResult *res,
+                                    bool withSkips) {
+  if (blk->numEntries == 0) {
+    blk->firstId = blk->lastId = res->docId;
+    if (withSkips) {
+      IndexBlock_ReserveSkips(blk, blk->capacity);
+    }
+  }
+  IndexBlock_UpdateSkips(IndexBlock_Skips(blk), blk->firstId, blk->capacity, blk->numEntries,
+                         blk->lastId, IndexBlock_DataLen(blk));
+  // (created after the checkpoints are reserved, which moves the end of the buffer)
+  BufferWriter bw = NewBufferWriter(&blk->buf);
+  encoder(&bw, res->docId - blk->lastId, res);
+  blk->lastId = res->docId;
+  if (++blk->numEntries % GROUP_VARINT_SIZE == 0) {
+    IndexBlock_PackLastGroup(blk, encoder == encodePackedFreqs);
+  }
+}
+
+/* Repair a packed block. Unlike the other encodings, entries cannot be copied over as is (they may
+ * move between packed groups), so the block is decoded and rebuilt from its valid entries. The
+ * rebuilt block takes skip checkpoints if the block had them */
+static size_t IndexBlock_RepairPacked(IndexBlock *blk, DocTable *dt, IndexFlags flags,
+                                      IndexRepairParams *params) {
+  IndexEncoder encoder = InvertedIndex_GetEncoder(flags);
+  const size_t entryWords = encoder == encodePackedFreqs ? 2 : 1;
+  const bool withSkips = blk->flags & IndexBlock_WithSkips;
+  Buffer decoded = {0};
+  decodePackedBlock(blk, &decoded, encoder == encodePackedFreqs);
+  const uint32_t *entries = (const uint32_t *)decoded.data;
+
+  RSIndexResult *res = NewTokenRecord(NULL, 1);
+  IndexBlock repaired = {.capacity = IndexBlock_Capacity(blk, flags)};
+  size_t frags = 0;
+
+  params->bytesBeforFix = blk->buf.cap;
+
+#define LOAD_ENTRY(i)                                                  \
+  do {                                                                 \
+    res->docId = blk->firstId + entries[(i) * entryWords];             \
+    res->freq = entryWords > 1 ? entries[(i) * entryWords + 1] : 1;    \
+  } while (0)
+
+  for (size_t i = 0; i < blk->numEntries; i++) {
+    LOAD_ENTRY(i);
+    if (!DocTable_Exists(dt, res->docId)) {
+      if (!frags) {
+        // First invalid doc; rebuild the block with all the entries prior to it
+        for (size_t j = 0; j < i; j++) {
+          LOAD_ENTRY(j);
+          IndexBlock_AppendPacked(&repaired, encoder, res, withSkips);
+        }
+      }
+      ++frags;
+      ++params->entriesCollected;
+      continue;
+    }
+
+    if (params->RepairCallback) {
+      params->RepairCallback(res, blk, params->arg);
+    }
+    if (frags) {
+      IndexBlock_AppendPacked(&repaired, encoder, res, withSkips);
+    }
+  }
+#undef LOAD_ENTRY
+
+  if (frags) {
+    // Removing entries may move others back to the raw tail, so the block does not always shrink
+    if (IndexBlock_DataLen(blk) > IndexBlock_DataLen(&repaired)) {
+      params->bytesCollected += IndexBlock_DataLen(blk) - IndexBlock_DataLen(&repaired);
+    }
+    blk->firstId = repaired.firstId;
+    blk->lastId = repaired.lastId;
+    blk->numEntries = repaired.numEntries;
+    // A block left with no entries has no room for its checkpoints
+    blk->flags = (blk->flags & ~IndexBlock_WithSkips) | (repaired.flags & IndexBlock_WithSkips);
+    Buffer_Free(&blk->buf);
+    blk->buf = repaired.buf;
+    Buffer_ShrinkToSize(&blk->buf);
+  }
+
+  params->bytesAfterFix = blk->buf.cap;
+
+  Buffer_Free(&decoded);
+  IndexResult_Free(res);
+  return frags;
+}
+
+/* Repair a bitmap block. The bits of deleted documents are cleared and the block is rebuilt around
+ * the remaining ids - as a bitmap if it is still dense enough, and as doc id deltas otherwise */
+static size_t IndexBlock_RepairBitmap(IndexBlock *blk, DocTable *dt, IndexRepairParams *params) {
+  uint64_t *words = BITMAP_WORDS(blk);
+  const t_docId baseId = blk->firstId;
+  RSIndexResult *res = NewTokenRecord(NULL, 1);
+  t_docId firstValid = 0, lastValid = 0;
+  size_t frags = 0;
+
+  params->bytesBeforFix = blk->buf.cap;
+
+  for (size_t i = 0; i < BITMAP_NUM_WORDS(blk); i++) {
+    for (uint64_t w = words[i]; w; w &= w - 1) {
+      const int bit = __builtin_ctzll(w);
+      res->docId = baseId + i * 64 + bit;
+      if (!DocTable_Exists(dt, res->docId)) {
+        words[i] &= ~(1ULL << bit);
+        ++frags;
+        continue;
+      }
+      if (params->RepairCallback) {
+        params->RepairCallback(res, blk, params->arg);
+      }
+      if (!firstValid) {
+        firstValid = res->docId;
+      }
+      lastValid = res->docId;
+    }
+  }
+
+  if (frags) {
+    params->entriesCollected += frags;
+    blk->numEntries -= frags;
+    blk->firstId = firstValid;
+    blk->lastId = lastValid;
+    Buffer repaired = {0};
+    if (blk->numEntries && BITMAP_IS_DENSE(lastValid - firstValid + 1, blk->numEntries)) {
+      Bitmap_Init(&repaired, lastValid - firstValid + 1);
+      uint64_t *repairedWords = (uint64_t *)repaired.data;
+      for (size_t i = 0; i < BITMAP_NUM_WORDS(blk); i++) {
+        for (uint64_t w = words[i]; w; w &= w - 1) {
+          BITMAP_SET(repairedWords, baseId + i * 64 + __builtin_ctzll(w) - firstValid);
+        }
+      }
+    } else {
+      // Not dense anymore (or empty) - encode the remaining ids as deltas, as any other doc id block.
+      // A bitmap block's checkpoints are cleared, and a repair does not retake them
+      BufferWriter bw = NewBufferWriter(&repaired);
+      t_docId prevId = firstValid;
+      for (size_t i = 0; i < BITMAP_NUM_WORDS(blk); i++) {
+        for (uint64_t w = words[i]; w; w &= w - 1) {
+          const t_docId id = baseId + i * 64 + __builtin_ctzll(w);
+          WriteVarint(id - prevId, &bw);
+          prevId = id;
+        }
+      }
+      blk->flags &= ~IndexBlock_Bitmap;
+    }
+    if (IndexBlock_DataLen(blk) > Buffer_Offset(&repaired)) {
+      params->bytesCollected += IndexBlock_DataLen(blk) - Buffer_Offset(&repaired);
+    }
+    Buffer_Free(&blk->buf);
+    blk->buf = repaired;
+    Buffer_ShrinkToSize(&blk->buf);
+  }
+
+  params->bytesAfterFix = blk->buf.cap;
+
+  IndexResult_Free(res);
+  return frags;
+}
+
 /* Repair an index block by removing garbage - records pointing at deleted documents,
  * and write valid entries in their place.
  * Returns the number of docs collected, and puts the number of bytes collected in the given
@@ -1303,14 +2231,24 @@ IndexIterator *NewReadIterator(IndexReader *ir) {
 size_t IndexBlock_Repair(IndexBlock *blk, DocTable *dt, IndexFlags flags, IndexRepairParams *params) {
   static const IndexDecoderCtx empty = {0};
 
+  if (IndexBlock_IsBitmap(blk)) {
+    return IndexBlock_RepairBitmap(blk, dt, params);
+  }
+  if (flags & Index_StorePacked) {
+    return IndexBlock_RepairPacked(blk, dt, flags, params);
+  }
+
   IndexBlockReader reader = { .buffReader = NewBufferReader(&blk->buf), .curBaseId = blk->firstId };
   BufferReader *br = &reader.buffReader;
+  Buffer_Seek(br, IndexBlock_EntriesOffset(blk));
   Buffer repair = {0};
   BufferWriter bw = NewBufferWriter(&repair);
   uint32_t readFlags = flags & INDEX_STORAGE_MASK;
   RSIndexResult *res = readFlags == Index_StoreNumeric ? NewNumericResult() : NewTokenRecord(NULL, 1);
   IndexDecoderProcs decoders = InvertedIndex_GetDecoder(readFlags);
   IndexEncoder encoder = InvertedIndex_GetEncoder(readFlags);
+  const uint16_t blockSize = IndexBlock_Capacity(blk, flags);
+  size_t numValid = 0;
 
   blk->lastId = blk->firstId = 0;
   size_t frags = 0;
@@ -1359,6 +2297,15 @@ size_t IndexBlock_Repair(IndexBlock *blk, DocTable *dt, IndexFlags flags, IndexR
         blk->lastId = res->docId; // first diff should be 0
       }
 
+      // Entries may move, so the skip checkpoints are taken again (the ones before the first
+      // deleted entry remain the same). They were copied to the start of the repaired buffer along
+      // with these entries
+      if (frags && HAS_SKIP_CHECKPOINTS(encoder) && (blk->flags & IndexBlock_WithSkips)) {
+        IndexBlock_UpdateSkips((IndexBlockSkips *)repair.data, blk->firstId, blockSize, numValid,
+                               blk->lastId, Buffer_Offset(&repair));
+      }
+      ++numValid;
+
       // Valid document, but we're rewriting the block:
       if (frags) {
         if (encoder != encodeRawDocIdsOnly) {
@@ -1384,6 +2331,13 @@ size_t IndexBlock_Repair(IndexBlock *blk, DocTable *dt, IndexFlags flags, IndexR
     Buffer_Free(&blk->buf);
     blk->buf = repair;
     Buffer_ShrinkToSize(&blk->buf);
+    // Drop the checkpoints past the remaining entries
+    IndexBlockSkips *skips = IndexBlock_Skips(blk);
+    for (size_t i = 0; skips && i < INDEX_BLOCK_NUM_SKIPS; i++) {
+      if ((i + 1) * SKIP_INTERVAL(blockSize) >= blk->numEntries) {
+        skips->offsets[i] = 0;
+      }
+    }
   }
 
   params->bytesAfterFix = blk->buf.cap;
@@ -1391,3 +2345,89 @@ size_t IndexBlock_Repair(IndexBlock *blk, DocTable *dt, IndexFlags flags, IndexR
   IndexResult_Free(res);
   return frags;
 }
+
+// Append the entries of a packed block to a packed block that is being rebuilt, taking its skip
+// checkpoints along the way
+static void IndexBlock_AppendPackedBlock(IndexBlock *merged, const IndexBlock *blk,
+                                         IndexFlags flags, RSIndexResult *res) {
+  IndexEncoder encoder = InvertedIndex_GetEncoder(flags);
+  const size_t entryWords = encoder == encodePackedFreqs ? 2 : 1;
+  Buffer decoded = {0};
+  decodePackedBlock(blk, &decoded, encoder == encodePackedFreqs);
+  const uint32_t *entries = (const uint32_t *)decoded.data;
+  for (size_t i = 0; i < blk->numEntries; i++) {
+    res->docId = blk->firstId + entries[i * entryWords];
+    res->freq = entryWords > 1 ? entries[i * entryWords + 1] : 1;
+    IndexBlock_AppendPacked(merged, encoder, res, true);
+  }
+  Buffer_Free(&decoded);
+}
+
+// Append the entries of a block to a block that is being rebuilt, taking its skip checkpoints
+// along the way
+static void IndexBlock_AppendBlock(IndexBlock *merged, const IndexBlock *blk, IndexFlags flags,
+                                   RSIndexResult *res) {
+  static const IndexDecoderCtx empty = {0};
+  IndexDecoderProcs decoders = InvertedIndex_GetDecoder(flags);
+  IndexEncoder encoder = InvertedIndex_GetEncoder(flags);
+  // The reader does not modify the block
+  IndexBlockReader reader = {.buffReader = NewBufferReader((Buffer *)&blk->buf),
+                             .curBaseId = blk->firstId};
+  Buffer_Seek(&reader.buffReader, IndexBlock_EntriesOffset(blk));
+
+  while (!BufferReader_AtEnd(&reader.buffReader)) {
+    decoders.decoder(&reader, &empty, res);
+    if (merged->numEntries == 0) {
+      merged->firstId = merged->lastId = res->docId;
+      if (HAS_SKIP_CHECKPOINTS(encoder)) {
+        IndexBlock_ReserveSkips(merged, merged->capacity);
+      }
+    }
+    IndexBlock_UpdateSkips(IndexBlock_Skips(merged), merged->firstId, merged->capacity,
+                           merged->numEntries, merged->lastId, IndexBlock_DataLen(merged));
+    // (created after the checkpoints are reserved, which moves the end of the buffer)
+    BufferWriter bw = NewBufferWriter(&merged->buf);
+    if (encoder != encodeRawDocIdsOnly) {
+      encoder(&bw, res->docId - merged->lastId, res);
+    } else {
+      encoder(&bw, res->docId - merged->firstId, res);
+    }
+    merged->lastId = res->docId;
+    ++merged->numEntries;
+  }
+}
+
+bool IndexBlock_Merge(IndexBlock *dst, const IndexBlock *src, IndexFlags flags) {
+  const uint16_t dstCapacity = IndexBlock_Capacity(dst, flags);
+  const uint16_t srcCapacity = IndexBlock_Capacity(src, flags);
+  const uint16_t capacity = MAX(dstCapacity, srcCapacity);
+  // Deltas and skip checkpoints of the merged block are bounded by its range of ids, same as when
+  // writing it
+  if (IndexBlock_IsBitmap(dst) || IndexBlock_IsBitmap(src) ||
+      dst->numEntries + src->numEntries > capacity ||
+      IndexBlock_DataLen(dst) + IndexBlock_DataLen(src) > INDEX_BLOCK_MAX_BYTES ||
+      src->lastId - dst->firstId > UINT32_MAX) {
+    return false;
+  }
+
+  uint32_t readFlags = flags & (INDEX_STORAGE_MASK | Index_StorePacked);
+  RSIndexResult *res = (readFlags & INDEX_STORAGE_MASK) == Index_StoreNumeric ? NewNumericResult()
+                                                                               : NewTokenRecord(NULL, 1);
+  IndexBlock merged = {.capacity = capacity};
+  if (flags & Index_StorePacked) {
+    IndexBlock_AppendPackedBlock(&merged, dst, readFlags, res);
+    IndexBlock_AppendPackedBlock(&merged, src, readFlags, res);
+  } else {
+    IndexBlock_AppendBlock(&merged, dst, readFlags, res);
+    IndexBlock_AppendBlock(&merged, src, readFlags, res);
+  }
+  IndexResult_Free(res);
+
+  // An unknown frequency of either block (0) stays unknown
+  merged.maxFreq = (dst->maxFreq && src->maxFreq) ? MAX(dst->maxFreq, src->maxFreq) : 0;
+  merged.minDocLen = MIN(dst->minDocLen, src->minDocLen);
+  Buffer_ShrinkToSize(&merged.buf);
+  indexBlock_Free(dst);
+  *dst = merged;
+  return true;
+}
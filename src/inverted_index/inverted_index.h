@@ -22,20 +22,79 @@
 extern "C" {
 #endif
 
-// The number of entries in each index block. A new block will be created after every N entries
+// The initial number of entries in each index block. A new block will be created after every N
+// entries. The block size of an index grows with its number of documents (see
+// `INDEX_BLOCK_GROWTH_THRESHOLD`), so frequent terms take fewer, larger blocks
 #define INDEX_BLOCK_SIZE 100
 #define INDEX_BLOCK_SIZE_DOCID_ONLY 1000
 
+// The block size of an index doubles once the index holds INDEX_BLOCK_GROWTH_THRESHOLD blocks worth
+// of documents, up to `2^INDEX_BLOCK_MAX_GROWTH` times the initial block size
+#define INDEX_BLOCK_GROWTH_THRESHOLD 16
+#define INDEX_BLOCK_MAX_GROWTH 4
+
+// A new block is also created once the block's data reaches this number of bytes, whatever its
+// number of entries
+#define INDEX_BLOCK_MAX_BYTES 8192
+
+// The number of skip checkpoints of a block. A checkpoint is taken every
+// `blockSize / (INDEX_BLOCK_NUM_SKIPS + 1)` entries
+#define INDEX_BLOCK_NUM_SKIPS 4
+
+// Only blocks of at least this capacity take skip checkpoints. Smaller blocks are cheap enough to
+// decode from their start, and most blocks of small indexes are of this kind
+#define INDEX_BLOCK_SKIPS_MIN_CAPACITY (2 * INDEX_BLOCK_SIZE)
+
+// The maximal range of ids a bitmap block may cover (so its number of entries fits in 16 bits)
+#define INDEX_BITMAP_BLOCK_RANGE UINT16_MAX
+
+typedef enum {
+  // The block holds a bitmap of the ids it covers rather than encoded entries (see
+  // `IndexBlock_IsBitmap`)
+  IndexBlock_Bitmap = 0x01,
+  // The block's buffer starts with its skip checkpoints (see `IndexBlock_Skips`)
+  IndexBlock_WithSkips = 0x02,
+} IndexBlockFlags;
+
 extern uint64_t TotalIIBlocks;
 
+/* Sparse skip checkpoints of a block, letting a reader resume decoding in the middle of it (see
+ * `IndexBlock_SkipTo`). Checkpoint i starts at byte `offsets[i]` of the block, and the entry
+ * preceding it has the id `firstId + baseIds[i]`. A zero offset marks an unused checkpoint.
+ * The checkpoints are kept at the start of the block's buffer, ahead of its entries, so they cost
+ * no room in the block itself. */
+typedef struct {
+  uint32_t baseIds[INDEX_BLOCK_NUM_SKIPS];
+  uint32_t offsets[INDEX_BLOCK_NUM_SKIPS];
+} IndexBlockSkips;
+
 /* A single block of data in the index. The index is basically a list of blocks we iterate */
 typedef struct {
   t_docId firstId;
   t_docId lastId;
   Buffer buf;
   uint16_t numEntries;  // Number of entries (i.e., docs)
+  uint8_t flags;        // IndexBlockFlags
+  // Upper-bound statistics of the block entries, used to skip whole blocks that cannot make it into
+  // the top results (see `IndexBlock_MaxScore`). They fill the padding of the struct, so both are
+  // saturated, and conservative: `maxFreq` is 0 if unknown and `minDocLen` may be lower than the
+  // actual one.
+  uint8_t maxFreq;      // Maximal term frequency of an entry in the block
+  // The number of entries after which a new block is started, set when the block is created. The
+  // skip checkpoints of the block are taken at fixed intervals of it. 0 for blocks loaded from RDB,
+  // which use the initial block size
+  uint16_t capacity;
+  uint16_t minDocLen;   // Minimal length of the document of an entry in the block. 0 if unknown
 } IndexBlock;
 
+/* The scoring parameters of a single term, used to compute an upper bound of the (standard BM25)
+ * score any entry of a block can contribute to a document */
+typedef struct {
+  double idf;         // The term's BM25 IDF
+  double weight;      // The weight of the term, times the highest document score
+  double avgDocLen;   // The average document length in the index
+} BlockMaxScoreCtx;
+
 typedef struct InvertedIndex {
   IndexBlock *blocks; // Array containing the inverted index blocks
   uint32_t size;      // Number of blocks
@@ -111,6 +170,40 @@ void InvertedIndex_Free(void *idx);
 #define IndexBlock_DataLen(b) (b)->buf.offset
 #define IndexBlock_DataCap(b) (b)->buf.cap
 
+/* The skip checkpoints of the block, or NULL if it has none. Blocks of at least
+ * `INDEX_BLOCK_SKIPS_MIN_CAPACITY` entries reserve them ahead of their first entry. Blocks of raw doc
+ * ids, which are searched directly, and bitmap blocks never have them. The checkpoints of packed
+ * blocks start groups, from which the block is decoded */
+static inline IndexBlockSkips *IndexBlock_Skips(const IndexBlock *blk) {
+  return (blk->flags & IndexBlock_WithSkips) ? (IndexBlockSkips *)blk->buf.data : NULL;
+}
+
+/* The offset of the first entry in the block's buffer, past its skip checkpoints if it has any */
+static inline size_t IndexBlock_EntriesOffset(const IndexBlock *blk) {
+  return (blk->flags & IndexBlock_WithSkips) ? sizeof(IndexBlockSkips) : 0;
+}
+
+/* Dense doc-id only postings (e.g. tag values matching most of the documents) are stored in bitmap
+ * blocks, the way roaring bitmaps switch to bitmap containers. Bit i of the block's buffer (read as
+ * 64 bit words) is set if the id `firstId + i` is in the block. A full block of doc ids is turned
+ * into a bitmap once that takes no more space than a byte per entry, and keeps taking appended ids
+ * while it stays that dense and within INDEX_BITMAP_BLOCK_RANGE ids. */
+static inline bool IndexBlock_IsBitmap(const IndexBlock *blk) {
+  return blk->flags & IndexBlock_Bitmap;
+}
+
+/* Return the first id of the bitmap block that is greater or equal to `docId`, or 0 if there is
+ * none */
+t_docId IndexBlock_BitmapNext(const IndexBlock *blk, t_docId docId);
+
+/* Return the bits of the bitmap block for the 64 ids starting at `docId`, where bit i stands for
+ * `docId + i`. Ids outside of the block read as unset */
+uint64_t IndexBlock_BitmapWord(const IndexBlock *blk, t_docId docId);
+
+/* Decode a bitmap block into the doc id deltas the blocks of its index are encoded with, for saving
+ * the block in the legacy RDB format. Readers search bitmap blocks directly */
+void IndexBlock_DecodeBitmap(const IndexBlock *blk, Buffer *out);
+
 /**
  * Decode a single record from the buffer reader. This function is responsible for:
  * (1) Decoding the record at the given position of br
@@ -134,15 +227,56 @@ struct IndexReader;
  */
 typedef bool (*IndexSeeker)(IndexBlockReader *, const IndexDecoderCtx *, t_docId to, RSIndexResult *out);
 
+/* The records of a block decoded a group at a time (see `IndexBlockDecoder`). The group following
+ * the current one is decoded once its records are read, or from a skip checkpoint */
+typedef struct {
+  Buffer records;      // The decoded records of the current group
+  uint32_t groupPos;   // The byte offset in the block of the current group
+  uint32_t groupBase;  // The offset from the block's first id its doc id deltas add up from
+  uint32_t nextPos;    // The byte offset in the block of the next group
+  uint32_t nextBase;   // The offset from the block's first id its doc id deltas add up from
+} DecodedBlock;
+
+/**
+ * Decode the group of records of a block at `decoded->nextPos` into `decoded->records`, and make it
+ * the current group. Packed blocks (see `Index_StorePacked`) cannot be read one record at a time, so
+ * readers decode them a group at a time using this function, and read the decoded records with the
+ * decoder/seeker. Returns the number of records decoded, or 0 (leaving `decoded` as it is) if there
+ * are no more groups.
+ */
+typedef size_t (*IndexBlockDecoder)(const IndexBlock *blk, DecodedBlock *decoded);
+
 typedef struct {
   IndexDecoder decoder;
   IndexSeeker seeker;
+  IndexBlockDecoder blockDecoder;  // Optional. If set, blocks are decoded a group at a time
 } IndexDecoderProcs;
 
 /* Get the decoder for the index based on the index flags. This is used to externally inject the
  * endoder/decoder when reading and writing */
 IndexDecoderProcs InvertedIndex_GetDecoder(uint32_t flags);
 
+/* Create a buffer reader over the records of a block, for the given decoders. If the decoders read
+ * the block a group at a time, its first group is decoded into `scratch` (owned by the caller and
+ * reused across blocks) and the returned reader is over the decoded records, until
+ * `IndexBlock_NextGroup` moves it to the next group. Not for bitmap blocks, which are read with
+ * `IndexBlock_BitmapNext` */
+BufferReader IndexBlock_NewReader(IndexBlock *blk, const IndexDecoderProcs *decoders,
+                                  DecodedBlock *scratch);
+
+/* Move a reader that read all the decoded records of its group to the next group of the block.
+ * Returns false if the decoders don't read the block a group at a time, or if there are no more
+ * groups */
+bool IndexBlock_NextGroup(const IndexBlock *blk, const IndexDecoderProcs *decoders,
+                          DecodedBlock *scratch, BufferReader *br);
+
+/* Move a reader of the block forward to the last skip checkpoint preceding `docId`, if there is one
+ * ahead of the reader's position. The reader's base id is set to the id of the entry preceding the
+ * checkpoint. Blocks read a group at a time are decoded from the checkpoint's group into `scratch`
+ * instead, and the reader's base id is left as it is. Returns true if the reader was moved */
+bool IndexBlock_SkipTo(const IndexBlock *blk, const IndexDecoderProcs *decoders,
+                       DecodedBlock *scratch, IndexBlockReader *reader, t_docId docId);
+
 /* An IndexReader wraps an inverted index record for reading and iteration */
 typedef struct IndexReader {
   const RedisSearchCtx *sctx;
@@ -168,6 +302,11 @@ typedef struct IndexReader {
   IndexDecoderCtx decoderCtx;
   /* The decoding function for reading the index */
   IndexDecoderProcs decoders;
+  /* The current group of the current block. Only used if `decoders.blockDecoder` is set */
+  DecodedBlock decodedBlock;
+  /* The next id to look for in the current block, if it is a bitmap block (which is read directly
+   * rather than through `br`) */
+  t_docId bitmapNextId;
 
   /* The number of records read */
   size_t len;
@@ -190,6 +329,13 @@ typedef struct IndexReader {
   uint32_t gcMarker;
 
   FieldFilterContext filterCtx;
+
+  /* The parameters of the score bounds of the blocks, for a term reader of a query that skips the
+   * documents that cannot make it into the top results (see `IR_SetScoreBounds`) */
+  BlockMaxScoreCtx scoreCtx;
+  /* If set, the blocks whose score bound is below the pointed threshold are passed over when
+   * reading. Only set on a reader at the root of the query */
+  const double *scoreThreshold;
 } IndexReader;
 
 // On Reopen callback for term index
@@ -221,6 +367,15 @@ size_t InvertedIndex_WriteNumericEntry(InvertedIndex *idx, t_docId docId, double
 
 size_t InvertedIndex_WriteEntryGeneric(InvertedIndex *idx, IndexEncoder encoder, t_docId docId,
                                        RSIndexResult *entry);
+
+/* Write a term entry of a document of the given length, which the block keeps for its score bounds.
+ * Entries written with `InvertedIndex_WriteEntryGeneric` are taken to be of unknown length */
+size_t InvertedIndex_WriteEntryWithDocLen(InvertedIndex *idx, IndexEncoder encoder, t_docId docId,
+                                          RSIndexResult *entry, uint32_t docLen);
+
+/* Return an upper bound of the standard BM25 score (see `BM25StdScorer`) any entry of the block
+ * contributes to the score of its document */
+double IndexBlock_MaxScore(const IndexBlock *blk, const BlockMaxScoreCtx *ctx);
 /* Create a new index reader for numeric records, optionally using a given filter. If the filter
  * is
  * NULL we will return all the records in the index */
@@ -256,6 +411,10 @@ void IR_Free(IndexReader *ir);
 /* Read an entry from an inverted index into RSIndexResult */
 int IR_Read(void *ctx, RSIndexResult **e);
 
+/* Read the ids of up to `cap` next entries of an inverted index into `out` (see
+ * `IndexIterator.ReadBatch`) */
+int IR_ReadBatch(void *ctx, t_docId *out, size_t cap, size_t *n);
+
 /**
  * Skip to a specific document ID in the index, or one position after it
  * @param ctx the index reader
@@ -274,11 +433,42 @@ void IR_Rewind(void *ctx);
 /* LastDocId of an inverted index stateful reader */
 t_docId IR_LastDocId(void *ctx);
 
+/* Estimate the number of docs the reader yields. Unlike the reader's NumEstimated, which is the
+ * number of docs in the index, this accounts for a numeric filter reading only part of the range,
+ * assuming the values are evenly spread over it. Used to order the children of intersections */
+size_t IR_EstimateMatches(const IndexReader *ir);
+
 /* Create a reader iterator that iterates an inverted index record */
 IndexIterator *NewReadIterator(IndexReader *ir);
 
+/* Returns whether the reader reads doc-id only postings, which may be stored in bitmap blocks */
+bool IR_MayHaveBitmaps(const IndexReader *ir);
+
+/* Returns the block of the reader's index holding `docId` (or the first id following it), if it is
+ * a bitmap block, and NULL otherwise or if `docId` is past the end of the index. Does not move the
+ * reader. Should only be called if `IR_MayHaveBitmaps` is true */
+const IndexBlock *IR_BitmapBlock(const IndexReader *ir, t_docId docId);
+
+/* Set up the score bounds of a term reader, for a query scored with BM25STD over an index with the
+ * given average document length, and documents scoring at most `maxDocScore`.
+ * Returns false if the reader is not a term reader, or its score cannot be bound */
+bool IR_SetScoreBounds(IndexReader *ir, double avgDocLen, double maxDocScore);
+
+/* Find the block of the reader's index holding `docId` (or the first id following it), and set
+ * [*firstId, *lastId] to the ids it covers from `docId` on, and `*bound` to the score bound of its
+ * entries. Does not move the reader. Returns false if the reader has no entries left from `docId`
+ * on. Should only be called once `IR_SetScoreBounds` succeeded */
+bool IR_BlockMaxScore(const IndexReader *ir, t_docId docId, t_docId *firstId, t_docId *lastId,
+                      double *bound);
+
 size_t IndexBlock_Repair(IndexBlock *blk, DocTable *dt, IndexFlags flags, IndexRepairParams *params);
 
+/* Merge the entries of `src` into `dst`, the block preceding it in the index, if all of them fit in
+ * a single block (by entries and by bytes). Bitmap blocks are never merged.
+ * Returns true if the blocks were merged, in which case `dst` holds a new buffer with the entries
+ * of both, and `src` is left untouched for the caller to free */
+bool IndexBlock_Merge(IndexBlock *dst, const IndexBlock *src, IndexFlags flags);
+
 #ifdef __cplusplus
 }
 #endif
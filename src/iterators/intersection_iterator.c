@@ -11,6 +11,7 @@
 #include "empty_iterator.h"
 #include "union_iterator.h"
 #include "index_result.h"
+#include "inverted_index_iterator.h"
 
 /**************************** Read + SkipTo Helpers ****************************/
 
@@ -88,9 +89,46 @@ static inline IteratorStatus II_Find_Consensus_WithRelevancyCheck(IntersectionIt
   return rc;
 }
 
+/**
+ * Advance `docId` to the first id that is set in the bitmap blocks of all the children, found with a
+ * word-wise AND of these blocks. Stops as soon as one of the children does not have a bitmap block
+ * that may hold `docId`, leaving `docId` as a candidate to check the regular way.
+ */
+static void II_IntersectBitmaps(IntersectionIterator *it, t_docId *docId) {
+  const IndexBlock **blocks = it->bitmapBlocks;
+  while (true) {
+    // Only the range shared by all the blocks may hold common ids
+    t_docId start = *docId, end = UINT64_MAX;
+    for (uint32_t i = 0; i < it->num_its; i++) {
+      blocks[i] = InvIndIterator_BitmapBlock(it->its[i], *docId);
+      if (!blocks[i]) {
+        return;
+      }
+      if (blocks[i]->firstId > start) start = blocks[i]->firstId;
+      if (blocks[i]->lastId < end) end = blocks[i]->lastId;
+    }
+    for (t_docId id = start; id <= end; id += 64) {
+      uint64_t word = UINT64_MAX;
+      for (uint32_t i = 0; i < it->num_its && word; i++) {
+        word &= IndexBlock_BitmapWord(blocks[i], id);
+      }
+      if (word) {
+        // Ids past the end of a block are never set, so this is within the range
+        *docId = id + __builtin_ctzll(word);
+        return;
+      }
+    }
+    // No common id up to the end of the shortest block
+    *docId = end + 1;
+  }
+}
+
 static inline IteratorStatus II_Find_Consensus(IntersectionIterator *it, t_docId docId) {
   IteratorStatus rc;
   do { // retry until we agree on the docId
+    if (it->bitmapBlocks) {
+      II_IntersectBitmaps(it, &docId);
+    }
     rc = II_AgreeOnDocId(it, &docId);
   } while (rc == ITERATOR_NOTFOUND);
   if (rc == ITERATOR_OK) {
@@ -203,6 +241,7 @@ static void II_Free(QueryIterator *base) {
   }
 
   rm_free(ii->its);
+  rm_free(ii->bitmapBlocks);
   IndexResult_Free(base->current);
   rm_free(base);
 }
@@ -251,6 +290,15 @@ static bool II_SetEstimation(IntersectionIterator *it) {
   return true;
 }
 
+static bool II_AllMayHaveBitmaps(const IntersectionIterator *it) {
+  for (uint32_t i = 0; i < it->num_its; i++) {
+    if (!InvIndIterator_MayHaveBitmaps(it->its[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
 QueryIterator *NewIntersectionIterator(QueryIterator **its, size_t num, int max_slop, bool in_order, double weight) {
   RS_ASSERT(its && num > 0);
   IntersectionIterator *it = rm_calloc(1, sizeof(*it));
@@ -278,6 +326,9 @@ QueryIterator *NewIntersectionIterator(QueryIterator **its, size_t num, int max_
     // No slop and no order means every result is relevant, so we can use the fast path
     base->Read = II_Read;
     base->SkipTo = II_SkipTo;
+    if (allValid && II_AllMayHaveBitmaps(it)) {
+      it->bitmapBlocks = rm_malloc(num * sizeof(*it->bitmapBlocks));
+    }
   } else {
     // Otherwise, we need to check relevancy
     base->Read = II_Read_CheckRelevancy;
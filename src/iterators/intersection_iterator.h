@@ -14,6 +14,7 @@ extern "C" {
 #endif
 
 #include "iterator_api.h"
+#include "inverted_index.h"
 
 typedef struct IntersectionIterator {
   QueryIterator base;
@@ -26,6 +27,11 @@ typedef struct IntersectionIterator {
   bool in_order;
 
   size_t num_expected;
+
+  // Scratch space for the bitmap blocks of the children, if all of them may have bitmap blocks.
+  // Candidates are then found with a word-wise AND of the blocks (see `II_IntersectBitmaps`).
+  // NULL otherwise
+  const IndexBlock **bitmapBlocks;
 } IntersectionIterator;
 
 /**
@@ -11,17 +11,28 @@
 
 // pointer to the current block while reading the index
 #define CURRENT_BLOCK(it) ((it)->idx->blocks[(it)->currentBlock])
-#define CURRENT_BLOCK_READER_AT_END(it) BufferReader_AtEnd(&(it)->blockReader.buffReader)
+// Blocks decoded a group at a time move on to their next group once the current one is read
+#define CURRENT_BLOCK_READER_AT_END(it)                                                  \
+  (IndexBlock_IsBitmap(&CURRENT_BLOCK(it)) ?                                             \
+     (it)->bitmapNextId > CURRENT_BLOCK(it).lastId :                                     \
+     BufferReader_AtEnd(&(it)->blockReader.buffReader) &&                                \
+       !IndexBlock_NextGroup(&CURRENT_BLOCK(it), &(it)->decoders, &(it)->decodedBlock,   \
+                             &(it)->blockReader.buffReader))
 
 void InvIndIterator_Free(QueryIterator *it) {
   if (!it) return;
   IndexResult_Free(it->current);
+  Buffer_Free(&((InvIndIterator *)it)->decodedBlock.records);
   rm_free(it);
 }
 
 static inline void SetCurrentBlockReader(InvIndIterator *it) {
+  if (IndexBlock_IsBitmap(&CURRENT_BLOCK(it))) {
+    it->bitmapNextId = CURRENT_BLOCK(it).firstId;
+    return;
+  }
   it->blockReader = (IndexBlockReader) {
-    NewBufferReader(&CURRENT_BLOCK(it).buf),
+    IndexBlock_NewReader(&CURRENT_BLOCK(it), &it->decoders, &it->decodedBlock),
     CURRENT_BLOCK(it).firstId,
   };
 }
@@ -98,11 +109,16 @@ IteratorStatus InvIndIterator_Read(QueryIterator *base) {
       AdvanceBlock(it);
     }
 
-    // The decoder also acts as a filter. If the decoder returns false, the
-    // current record should not be processed.
-    // Since we are not at the end of the block (previous check), the decoder is guaranteed
-    // to read a record (advanced by at least one entry).
-    if (!it->decoders.decoder(&it->blockReader, &it->decoderCtx, record)) {
+    if (IndexBlock_IsBitmap(&CURRENT_BLOCK(it))) {
+      // Bitmap blocks hold doc ids only, so there is nothing to decode or filter. The last id of the
+      // block is always set, so there is a next id
+      record->docId = IndexBlock_BitmapNext(&CURRENT_BLOCK(it), it->bitmapNextId);
+      it->bitmapNextId = record->docId + 1;
+    } else if (!it->decoders.decoder(&it->blockReader, &it->decoderCtx, record)) {
+      // The decoder also acts as a filter. If the decoder returns false, the
+      // current record should not be processed.
+      // Since we are not at the end of the block (previous check), the decoder is guaranteed
+      // to read a record (advanced by at least one entry).
       continue;
     }
 
@@ -183,6 +199,15 @@ IteratorStatus InvIndIterator_SkipTo_Default(QueryIterator *base, t_docId docId)
     // lastId, which either contains the requested docId or higher ids. We can skip to it.
     SkipToBlock(it, docId);
   }
+  if (IndexBlock_IsBitmap(&CURRENT_BLOCK(it))) {
+    // Bitmap blocks are searched directly from the requested id
+    if (docId > it->bitmapNextId) {
+      it->bitmapNextId = docId;
+    }
+  } else {
+    // Skip the entries of the block that are known to be smaller than the requested id
+    IndexBlock_SkipTo(&CURRENT_BLOCK(it), &it->decoders, &it->decodedBlock, &it->blockReader, docId);
+  }
 
   while (ITERATOR_EOF != InvIndIterator_Read(base)) {
     if (base->lastDocId < docId) continue;
@@ -250,6 +275,8 @@ IteratorStatus InvIndIterator_SkipTo_withSeeker(QueryIterator *base, t_docId doc
     // lastId, which either contains the requested docId or higher ids. We can skip to it.
     SkipToBlock(it, docId);
   }
+  // Skip the entries of the block that are known to be smaller than the requested id
+  IndexBlock_SkipTo(&CURRENT_BLOCK(it), &it->decoders, &it->decodedBlock, &it->blockReader, docId);
 
   // the seeker will return 1 only when it found a docid which is greater or equals the
   // searched docid and the field mask matches the searched fields mask. We need to continue
@@ -266,6 +293,43 @@ eof:
   return ITERATOR_EOF;
 }
 
+// Find the first block (starting from the current one) whose last id is not smaller than `docId`.
+// If `docId` is past the end of the index, the last block is returned
+static const IndexBlock *FindBlock(const InvIndIterator *it, t_docId docId) {
+  const InvertedIndex *idx = it->idx;
+  uint32_t bottom = it->currentBlock;
+  uint32_t top = idx->size - 1;
+  while (bottom < top) {
+    uint32_t i = (bottom + top) / 2;
+    if (idx->blocks[i].lastId < docId) {
+      bottom = i + 1;
+    } else {
+      top = i;
+    }
+  }
+  return idx->blocks + bottom;
+}
+
+bool InvIndIterator_MayHaveBitmaps(const QueryIterator *base) {
+  if (base->Free != InvIndIterator_Free) {
+    return false;
+  }
+  const InvIndIterator *it = (const InvIndIterator *)base;
+  // Only doc ids written with the (non raw) varint encoding are turned into bitmaps
+  return (it->idx->flags & (INDEX_STORAGE_MASK | Index_StorePacked)) == Index_DocIdsOnly &&
+         !it->decoders.seeker;
+}
+
+const IndexBlock *InvIndIterator_BitmapBlock(const QueryIterator *base, t_docId docId) {
+  const InvIndIterator *it = (const InvIndIterator *)base;
+  if (docId > it->idx->lastId) {
+    return NULL;
+  }
+  // Most of the time the current block is the one
+  const IndexBlock *blk = CURRENT_BLOCK(it).lastId >= docId ? &CURRENT_BLOCK(it) : FindBlock(it, docId);
+  return IndexBlock_IsBitmap(blk) ? blk : NULL;
+}
+
 static QueryIterator *NewInvIndIterator(InvertedIndex *idx, RSIndexResult *res, const FieldFilterContext *filterCtx,
                                         bool skipMulti, const RedisSearchCtx *sctx, IndexDecoderCtx *decoderCtx) {
   RS_ASSERT(idx && idx->size > 0);
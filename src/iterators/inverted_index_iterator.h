@@ -26,11 +26,16 @@ typedef struct InvIndIterator {
 
   /* The decoding function for reading the index */
   IndexDecoderProcs decoders;
+  /* The current group of the current block. Only used if `decoders.blockDecoder` is set */
+  DecodedBlock decodedBlock;
   /* The decoder's filtering context. It may be a number or a pointer. The number is used for
    * filtering field masks, the pointer for numeric filtering */
   IndexDecoderCtx decoderCtx;
 
   uint32_t currentBlock;
+  /* The next id to look for in the current block, if it is a bitmap block (which is read directly
+   * rather than through `blockReader`) */
+  t_docId bitmapNextId;
 
   /* This marker lets us know whether the garbage collector has visited this index while the reading
    * thread was asleep, and reset the state in a deeper way
@@ -72,6 +77,14 @@ QueryIterator *NewInvIndIterator_TermQuery(InvertedIndex *idx, const RedisSearch
 QueryIterator *NewInvIndIterator_GenericQuery(InvertedIndex *idx, const RedisSearchCtx *sctx, t_fieldIndex fieldIndex,
                                               enum FieldExpirationPredicate predicate);
 
+// Returns whether the iterator reads doc-id only postings, which may be stored in bitmap blocks
+bool InvIndIterator_MayHaveBitmaps(const QueryIterator *it);
+
+// Returns the block that may hold `docId` (the block containing it, or the first block past it) if
+// it is a bitmap block, and NULL otherwise or if `docId` is past the end of the index.
+// Does not move the iterator. Should only be called if `InvIndIterator_MayHaveBitmaps` is true
+const IndexBlock *InvIndIterator_BitmapBlock(const QueryIterator *it, t_docId docId);
+
 #ifdef __cplusplus
 }
 #endif
@@ -153,6 +153,7 @@ IndexIterator *NewMetricIterator(t_docId *ids_list, double *metric_list, Metric
     ri->Read = MR_Read;
     ri->SkipTo = MR_SkipTo;
   }
+  ri->ReadBatch = NULL;
   ri->Rewind = MR_Rewind;
   ri->Free = MR_Free;
   ri->HasNext = MR_HasNext;
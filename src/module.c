@@ -490,6 +490,10 @@ overwritten
     - NOFIELDS: If set, we do not store field bits for each term. Saves memory, does not allow
       filtering by specific fields.
 
+    - PACKEDPOSTINGS: If set, the doc ids of tag and text postings are stored in packed groups that
+      are decoded a whole block at a time, which speeds up reading them. Requires NOOFFSETS and
+      NOFIELDS.
+
     - SCHEMA: After the SCHEMA keyword we define the index fields. They can be either numeric or
       textual.
       For textual fields we optionally specify a weight. The default weight is 1.0
@@ -690,6 +694,7 @@ int SynUpdateCommand(RedisModuleCtx *ctx, RedisModuleString **argv, int argc) {
   IndexSpec_InitializeSynonym(sp);
 
   SynonymMap_UpdateRedisStr(sp->smap, argv + offset, argc - offset, id);
+  IndexSpec_ClearQueryCache(sp);
 
   if (initialScan) {
     IndexSpec_ScanAndReindex(ctx, ref);
@@ -832,6 +837,7 @@ static int AlterIndexInternalCommand(RedisModuleCtx *ctx, RedisModuleString **ar
     return QueryError_ReplyAndClear(ctx, &status);
   }
 
+  IndexSpec_ClearQueryCache(sp);
   RedisSearchCtx_UnlockSpec(&sctx);
   CurrentThread_ClearIndexSpec();
 
@@ -1995,6 +2001,18 @@ static int cmpStrings(const char *s1, size_t l1, const char *s2, size_t l2) {
   }
 }
 
+// Returns true if the results have the same sorting key (or both have none), so their order is
+// decided by their ids
+static bool sort_keys_tie(const searchResult *r1, const searchResult *r2) {
+  if (!r1->sortKey || !r2->sortKey) {
+    return !r1->sortKey && !r2->sortKey;
+  }
+  if (r1->sortKeyNum != HUGE_VAL && r2->sortKeyNum != HUGE_VAL) {
+    return r1->sortKeyNum == r2->sortKeyNum;
+  }
+  return !cmpStrings(r1->sortKey, r1->sortKeyLen, r2->sortKey, r2->sortKeyLen);
+}
+
 static int cmp_results(const void *p1, const void *p2, const void *udata) {
 
   const searchResult *r1 = p1, *r2 = p2;
@@ -2400,14 +2418,16 @@ error:
   rCtx->cachedResult = res;
 }
 
-static void processSearchReplyResult(searchResult *res, searchReducerCtx *rCtx, RedisModuleCtx *ctx) {
+// Adds a result of a shard to the heap.
+// Returns false if the rest of the shard's results should be skipped
+static bool processSearchReplyResult(searchResult *res, searchReducerCtx *rCtx, RedisModuleCtx *ctx) {
   if (!res || !res->id) {
     RedisModule_Log(ctx, "warning", "got an unexpected argument when parsing redisearch results");
     rCtx->errorOccurred = true;
     // invalid result - usually means something is off with the response, and we should just
     // quit this response
     rCtx->cachedResult = res;
-    return;
+    return true;
   }
 
   rCtx->cachedResult = NULL;
@@ -2424,13 +2444,17 @@ static void processSearchReplyResult(searchResult *res, searchReducerCtx *rCtx,
       rCtx->cachedResult = smallest;
     } else {
       rCtx->cachedResult = res;
-      if (rCtx->searchCtx->withSortby) {
+      if (rCtx->searchCtx->withSortby && !sort_keys_tie(res, smallest)) {
         // If the result is lower than the last result in the heap,
-        // AND there is a user-defined sort order - we can stop now
-        return;
+        // AND there is a user-defined sort order - we can stop now.
+        // The shard's results are sorted, so none of the following ones can make it to the heap.
+        // On a tie of the sorting keys the order is decided by the ids, which the shard did not
+        // sort by, so we keep going in that case
+        return false;
       }
     }
   }
+  return true;
 }
 
 static void processSearchReply(MRReply *arr, searchReducerCtx *rCtx, RedisModuleCtx *ctx) {
@@ -2474,7 +2498,9 @@ static void processSearchReply(MRReply *arr, searchReducerCtx *rCtx, RedisModule
     bool needScore = rCtx->offsets.score > 0;
     for (int i = 0; i < len; ++i) {
       searchResult *res = newResult_resp3(rCtx->cachedResult, results, i, &rCtx->offsets, rCtx->searchCtx->withExplainScores, rCtx->reduceSpecialCaseCtxSortby);
-      processSearchReplyResult(res, rCtx, ctx);
+      if (!processSearchReplyResult(res, rCtx, ctx)) {
+        break;
+      }
     }
     processResultFormat(&rCtx->searchCtx->format, arr);
   }
@@ -2495,7 +2521,9 @@ static void processSearchReply(MRReply *arr, searchReducerCtx *rCtx, RedisModule
         break;
       }
       searchResult *res = newResult_resp2(rCtx->cachedResult, arr, j, &rCtx->offsets , rCtx->searchCtx->withExplainScores);
-      processSearchReplyResult(res, rCtx, ctx);
+      if (!processSearchReplyResult(res, rCtx, ctx)) {
+        break;
+      }
     }
   }
 }
@@ -140,6 +140,10 @@ int HashNotificationCallback(RedisModuleCtx *ctx, int type, const char *event,
 
   switch (redisCommand) {
     case loaded_cmd:
+      // While loading, skip keys no index covers before copying the key name and opening the key
+      if (!Indexes_MatchAnyPrefix(key)) {
+        break;
+      }
       // on loaded event the key is stack allocated so to use it to load the
       // document we must copy it
       key = RedisModule_CreateStringFromString(ctx, key);
@@ -362,6 +366,8 @@ void ConfigChangedCallback(RedisModuleCtx *ctx, RedisModuleEvent eid, uint64_t e
       event != REDISMODULE_SUBEVENT_CONFIG_CHANGE) {
     return;
   }
+  // Any change may affect query replies, so the replies cached so far are not served anymore
+  RSGlobalConfig.generation++;
   RedisModuleConfigChangeV1 *ei = data;
   for (unsigned int i = 0; i < ei->num_changes; i++) {
     const char *conf = ei->config_names[i];
@@ -65,18 +65,21 @@ size_t NumericRange_GetCardinality(const NumericRange *n) {
 }
 
 /*
- * Add a numeric entry to the range. Returns the additional memory used for the action.
+ * Add a numeric entry to the range. Returns the additional memory used for the action, which is
+ * negative if dropping the range's value ordered copy released more than the entry took.
  * This function DOES NOT update the cardinality of the range.
  * It is the caller's responsibility to update the cardinality if needed, by calling `updateCardinality`
  */
-static size_t NumericRange_Add(NumericRange *n, t_docId docId, double value) {
+static int NumericRange_Add(NumericRange *n, t_docId docId, double value) {
+  size_t dropped = NumericRange_DropByValue(n);
 
   if (value < n->minVal) n->minVal = value;
   if (value > n->maxVal) n->maxVal = value;
 
   size_t size = InvertedIndex_WriteNumericEntry(n->entries, docId, value);
   n->invertedIndexSize += size;
-  return size;
+  n->invertedIndexSize -= dropped;
+  return (int)size - (int)dropped;
 }
 
 /**
@@ -116,6 +119,8 @@ static inline NumericRange *NumericRange_New() {
   ret->entries = NewInvertedIndex(Index_StoreNumeric, 1, &ret->invertedIndexSize);
   ret->minVal = INFINITY;
   ret->maxVal = -INFINITY;
+  ret->byValue = NULL;
+  ret->byValueMisses = 0;
   hll_init(&ret->hll, NR_BIT_PRECISION);
   return ret;
 }
@@ -176,6 +181,7 @@ static void removeRange(NumericRangeNode *n, NRN_AddRv *rv) {
   rv->sz -= temp->invertedIndexSize;
   rv->numRecords -= temp->entries->numEntries;
   InvertedIndex_Free(temp->entries);
+  NumericRange_DropByValue(temp);
   hll_destroy(&temp->hll);
   rm_free(temp);
 
@@ -232,7 +238,7 @@ static void NumericRangeNode_Add(NumericRangeNode **np, t_docId docId, double va
     // if this node is a leaf - we add AND check the cardinality. We only split leaf nodes
     updateCardinality(n->range, value);
     *rv = (NRN_AddRv){
-      .sz = (uint32_t)NumericRange_Add(n->range, docId, value),
+      .sz = NumericRange_Add(n->range, docId, value),
       .numRecords = 1,
       .changed = 0,
       .numRanges = 0,
@@ -459,7 +465,175 @@ void NumericRangeTree_Free(NumericRangeTree *t) {
   rm_free(t);
 }
 
-IndexIterator *NewNumericRangeIterator(const RedisSearchCtx *sctx, NumericRange *nr,
+// Ranges smaller than this are cheap enough to decode in full
+#define NR_BY_VALUE_MIN_ENTRIES 256
+// The value ordered copy is used only if the filter selects at most 1/N of the range's entries.
+// Otherwise decoding the range in doc id order is cheaper than sorting the selected entries
+#define NR_BY_VALUE_MAX_SELECTIVITY 4
+
+size_t NumericRangeByValue_MaxMemory = NR_BY_VALUE_DEFAULT_MAX_MEMORY;
+// The memory taken by the value ordered copies of all the ranges
+static size_t byValueMemory = 0;
+
+size_t NumericRangeByValue_Memory() {
+  return __atomic_load_n(&byValueMemory, __ATOMIC_RELAXED);
+}
+
+size_t NumericRange_DropByValue(NumericRange *n) {
+  n->byValueMisses = 0;
+  if (!n->byValue) {
+    return 0;
+  }
+  size_t sz = NumericRangeByValue_Size(n->byValue->len);
+  rm_free(n->byValue);
+  n->byValue = NULL;
+  __atomic_sub_fetch(&byValueMemory, sz, __ATOMIC_RELAXED);
+  return sz;
+}
+
+static int cmpEntryValue(const void *p1, const void *p2) {
+  const NumericRangeEntry *e1 = p1, *e2 = p2;
+  return (e1->value > e2->value) - (e1->value < e2->value);
+}
+
+static int cmpEntryDocId(const void *p1, const void *p2) {
+  const NumericRangeEntry *e1 = p1, *e2 = p2;
+  if (e1->docId != e2->docId) {
+    return e1->docId > e2->docId ? 1 : -1;
+  }
+  return cmpEntryValue(p1, p2);
+}
+
+/* Estimate the share of the range's entries a filter selects, assuming the values are spread
+ * evenly between the range's bounds */
+static double NumericRange_EstimateSelectivity(const NumericRange *n, const NumericFilter *f) {
+  if (n->maxVal <= n->minVal) {
+    return 1;
+  }
+  const double lo = MAX(f->min, n->minVal), hi = MIN(f->max, n->maxVal);
+  return hi > lo ? (hi - lo) / (n->maxVal - n->minVal) : 0;
+}
+
+/* Build the range's entries ordered by value. Queries may share the range concurrently under the
+ * read lock, so the array is published with a CAS, and a builder that loses the race frees its own
+ * copy. The winner accounts for the copy's memory in the range, the tree and the spec.
+ * Returns NULL if the copy would take the copies of all the ranges past their memory limit */
+static const NumericRangeByValue *NumericRange_BuildByValue(NumericRange *n, NumericRangeTree *t,
+                                                            IndexSpec *sp) {
+  const size_t cap = n->entries->numEntries;
+  const size_t sz = NumericRangeByValue_Size(cap);
+  // Reserve the memory up front, so concurrent builders cannot overshoot the limit together
+  if (__atomic_add_fetch(&byValueMemory, sz, __ATOMIC_RELAXED) > NumericRangeByValue_MaxMemory) {
+    __atomic_sub_fetch(&byValueMemory, sz, __ATOMIC_RELAXED);
+    return NULL;
+  }
+  NumericRangeByValue *byValue = rm_malloc(sz);
+  byValue->len = 0;
+  RSIndexResult *res;
+  IndexReader *ir = NewMinimalNumericReader(n->entries, false);
+  while (byValue->len < cap && INDEXREAD_OK == IR_Read(ir, &res)) {
+    byValue->entries[byValue->len++] =
+        (NumericRangeEntry){.docId = res->docId, .value = res->data.num.value};
+  }
+  IR_Free(ir);
+  qsort(byValue->entries, byValue->len, sizeof(NumericRangeEntry), cmpEntryValue);
+
+  NumericRangeByValue *published = NULL;
+  if (!__atomic_compare_exchange_n(&n->byValue, &published, byValue, false,
+                                   __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+    rm_free(byValue);
+    __atomic_sub_fetch(&byValueMemory, sz, __ATOMIC_RELAXED);
+    return published;
+  }
+  // Give back the reservation of the entries that were not read
+  const size_t used = NumericRangeByValue_Size(byValue->len);
+  __atomic_sub_fetch(&byValueMemory, sz - used, __ATOMIC_RELAXED);
+  __atomic_add_fetch(&n->invertedIndexSize, used, __ATOMIC_RELAXED);
+  if (t) {
+    __atomic_add_fetch(&t->invertedIndexesSize, used, __ATOMIC_RELAXED);
+  }
+  if (sp) {
+    __atomic_add_fetch(&sp->stats.invertedSize, used, __ATOMIC_RELAXED);
+  }
+  return byValue;
+}
+
+/* Returns the index of the first entry whose value is above `bound` (or equal to it, if
+ * `inclusive`) */
+static size_t NumericRange_ByValueBound(const NumericRangeEntry *entries, size_t len, double bound,
+                                        bool inclusive) {
+  size_t lo = 0, hi = len;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    double v = entries[mid].value;
+    if (v > bound || (inclusive && v == bound)) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+  return lo;
+}
+
+/* Free a reader over a private index of a range's slice, along with the index */
+static void NumericSlice_Free(IndexIterator *it) {
+  InvertedIndex *idx = ((IndexReader *)it->ctx)->idx;
+  ReadIterator_Free(it);
+  InvertedIndex_Free(idx);
+}
+
+/* Create a reader over the entries of `nr` that match the numeric filter `f`, found with a binary
+ * search in the range's value ordered copy and written to a private index in doc id order. The
+ * reader is a plain numeric reader over that index, so it is profiled and reopened like the range's
+ * own. Returns NULL if the range is too small, or the filter not selective enough, for this to beat
+ * decoding the range. The copy is only built for ranges that are not being written to, when the
+ * range's bounds suggest the filter is selective enough and the copies' memory limit allows it */
+static IndexIterator *NewNumericSliceIterator(const RedisSearchCtx *sctx, NumericRangeTree *t,
+                                              NumericRange *nr, const NumericFilter *f,
+                                              int skipMulti, const FieldFilterContext *filterCtx) {
+  const size_t numEntries = nr->entries->numEntries;
+  if (numEntries < NR_BY_VALUE_MIN_ENTRIES) {
+    return NULL;
+  }
+
+  const NumericRangeByValue *byValue = __atomic_load_n(&nr->byValue, __ATOMIC_ACQUIRE);
+  if (!byValue) {
+    if (NumericRange_EstimateSelectivity(nr, f) * NR_BY_VALUE_MAX_SELECTIVITY > 1 ||
+        __atomic_add_fetch(&nr->byValueMisses, 1, __ATOMIC_RELAXED) < NR_BY_VALUE_MIN_QUERIES) {
+      return NULL;
+    }
+    byValue = NumericRange_BuildByValue(nr, t, sctx ? sctx->spec : NULL);
+    if (!byValue) {
+      return NULL;
+    }
+  }
+  const NumericRangeEntry *entries = byValue->entries;
+  const size_t lo = NumericRange_ByValueBound(entries, byValue->len, f->min, f->inclusiveMin);
+  const size_t hi = NumericRange_ByValueBound(entries, byValue->len, f->max, !f->inclusiveMax);
+  const size_t num = hi > lo ? hi - lo : 0;
+  if (num * NR_BY_VALUE_MAX_SELECTIVITY > numEntries) {
+    return NULL;
+  }
+
+  NumericRangeEntry *slice = rm_malloc(MAX(num, 1) * sizeof(*slice));
+  memcpy(slice, entries + lo, num * sizeof(*slice));
+  qsort(slice, num, sizeof(*slice), cmpEntryDocId);
+  size_t memsize;
+  InvertedIndex *idx = NewInvertedIndex(Index_StoreNumeric, 1, &memsize);
+  for (size_t i = 0; i < num; i++) {
+    InvertedIndex_WriteNumericEntry(idx, slice[i].docId, slice[i].value);
+  }
+  rm_free(slice);
+
+  // The entries all match, so the reader needs no filter. Multi values are skipped by the reader
+  IndexReader *ir = NewNumericReader(sctx, idx, NULL, nr->minVal, nr->maxVal, skipMulti, filterCtx);
+  IndexIterator *ret = NewReadIterator(ir);
+  ret->Free = NumericSlice_Free;
+  return ret;
+}
+
+IndexIterator *NewNumericRangeIterator(const RedisSearchCtx *sctx, NumericRangeTree *t,
+                                       NumericRange *nr,
                                        const NumericFilter *f, int skipMulti,
                                        const FieldFilterContext* filterCtx) {
 
@@ -470,6 +644,15 @@ IndexIterator *NewNumericRangeIterator(const RedisSearchCtx *sctx, NumericRange
       NumericFilter_Match(f, nr->minVal) && NumericFilter_Match(f, nr->maxVal)) {
     // make the filter NULL so the reader will ignore it
     f = NULL;
+  } else if (f && NumericFilter_IsNumeric(f) &&
+             (!sctx || !sctx->spec || !sctx->spec->docs.ttl)) {
+    // A partial overlap - look up the matching entries by value instead of decoding and filtering
+    // every entry of the range. Not done when documents may have expiring fields, since these are
+    // checked by the reader
+    IndexIterator *it = NewNumericSliceIterator(sctx, t, nr, f, skipMulti, filterCtx);
+    if (it) {
+      return it;
+    }
   }
   IndexReader *ir = NewNumericReader(sctx, nr->entries, f, nr->minVal, nr->maxVal, skipMulti, filterCtx);
 
@@ -495,7 +678,7 @@ IndexIterator *createNumericIterator(const RedisSearchCtx *sctx, NumericRangeTre
   if (n == 1) {
     NumericRange *rng;
     Vector_Get(v, 0, &rng);
-    IndexIterator *it = NewNumericRangeIterator(sctx, rng, f, true, filterCtx);
+    IndexIterator *it = NewNumericRangeIterator(sctx, t, rng, f, true, filterCtx);
     Vector_Free(v);
     return it;
   }
@@ -511,7 +694,7 @@ IndexIterator *createNumericIterator(const RedisSearchCtx *sctx, NumericRangeTre
       continue;
     }
 
-    its[i] = NewNumericRangeIterator(sctx, rng, f, true, filterCtx);
+    its[i] = NewNumericRangeIterator(sctx, t, rng, f, true, filterCtx);
   }
   Vector_Free(v);
 
@@ -625,13 +808,6 @@ int NumericIndexType_Register(RedisModuleCtx *ctx) {
   return REDISMODULE_OK;
 }
 
-/* A single entry in a numeric index's single range. Since entries are binned together, each needs
- * to have the exact value */
-typedef struct {
-  t_docId docId;
-  double value;
-} NumericRangeEntry;
-
 static int cmpdocId(const void *p1, const void *p2) {
   NumericRangeEntry *e1 = (NumericRangeEntry *)p1;
   NumericRangeEntry *e2 = (NumericRangeEntry *)p2;
@@ -28,6 +28,28 @@ extern "C" {
 #define NR_BIT_PRECISION 6 // For error rate of `1.04 / sqrt(2^6)` = 13%
 #define NR_REG_SIZE (1 << NR_BIT_PRECISION)
 
+/* A single entry in a numeric index's single range. Since entries are binned together, each needs
+ * to have the exact value */
+typedef struct {
+  t_docId docId;
+  double value;
+} NumericRangeEntry;
+
+/* A copy of a range's entries, ordered by value */
+typedef struct {
+  size_t len;
+  NumericRangeEntry entries[];
+} NumericRangeByValue;
+
+#define NumericRangeByValue_Size(len) (sizeof(NumericRangeByValue) + (len) * sizeof(NumericRangeEntry))
+
+// The value ordered copy of a range is only built once this many queries could have used it since
+// the range was last written to, so ranges that are still being filled are just decoded
+#define NR_BY_VALUE_MIN_QUERIES 8
+
+// The default memory limit of the value ordered copies of all the ranges together
+#define NR_BY_VALUE_DEFAULT_MAX_MEMORY (256 * 1024 * 1024)
+
 /* A numeric range is a node in a numeric range tree, representing a range of
  * values bunched together.
  * Since we do not know the distribution of scores ahead, we use a splitting
@@ -43,6 +65,14 @@ typedef struct {
 
   size_t invertedIndexSize;
   InvertedIndex *entries;
+
+  // Lazily built copy of the entries ordered by value, so a filter that only partially overlaps
+  // the range can find its entries with a binary search instead of decoding the whole range.
+  // Dropped whenever the entries change. Its memory is counted in invertedIndexSize, and bounded
+  // along with the other ranges' copies by NumericRangeByValue_MaxMemory.
+  NumericRangeByValue *byValue;
+  // Queries that could have used byValue since the range was last written to
+  uint32_t byValueMisses;
 } NumericRange;
 
 /* NumericRangeNode is a node in the range tree that can have a range in it or not, and can be a
@@ -88,7 +118,8 @@ typedef struct {
 
 #define NumericRangeNode_IsLeaf(n) (n->left == NULL && n->right == NULL)
 
-struct indexIterator *NewNumericRangeIterator(const RedisSearchCtx *sctx, NumericRange *nr,
+struct indexIterator *NewNumericRangeIterator(const RedisSearchCtx *sctx, NumericRangeTree *t,
+                                              NumericRange *nr,
                                               const NumericFilter *f, int skipMulti,
                                               const FieldFilterContext* filterCtx);
 
@@ -123,6 +154,18 @@ void NumericRangeTree_Free(NumericRangeTree *t);
 /* Return the estimated cardinality of the numeric range */
 size_t NumericRange_GetCardinality(const NumericRange *nr);
 
+/* Drop the value ordered copy of the range's entries. Must be called (under the write lock)
+ * whenever the range's inverted index is modified. Returns the memory released, which the caller
+ * should take off the range, tree and spec sizes */
+size_t NumericRange_DropByValue(NumericRange *nr);
+
+/* The memory limit of the value ordered copies of all the ranges together. Once reached, no copy is
+ * built until others are dropped, and partial overlaps are answered by decoding the ranges */
+extern size_t NumericRangeByValue_MaxMemory;
+
+/* The memory currently taken by the value ordered copies of all the ranges */
+size_t NumericRangeByValue_Memory();
+
 extern RedisModuleType *NumericIndexType;
 
 NumericRangeTree *openNumericKeysDict(IndexSpec* spec, RedisModuleString *keyName, bool create_if_missing);
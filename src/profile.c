@@ -14,7 +14,7 @@ void printReadIt(RedisModule_Reply *reply, IndexIterator *root, size_t counter,
   IndexReader *ir = root->ctx;
 
   RedisModule_Reply_Map(reply);
-  if (ir->idx->flags == Index_DocIdsOnly) {
+  if ((ir->idx->flags & ~Index_StorePacked) == Index_DocIdsOnly) {
     if (ir->record->data.term.term != NULL) {
       printProfileType("TAG");
       REPLY_KVSTR_SAFE("Term", ir->record->data.term.term->str);
@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#include "query_cache.h"
+#include "rmalloc.h"
+#include "util/dict.h"
+#include "util/dllist.h"
+
+#include <pthread.h>
+#include <string.h>
+
+typedef struct {
+  const char *data;
+  size_t len;
+} QueryCacheKey;
+
+typedef struct {
+  DLLIST_node llnode;  // In the LRU list, most recently used first
+  QueryCacheKey key;
+  uint64_t revision;
+  arrayof(char) reply;
+} QueryCacheEntry;
+
+struct QueryCache {
+  pthread_mutex_t lock;
+  dict *entries;  // QueryCacheKey -> QueryCacheEntry
+  DLLIST lru;
+  size_t memory;
+  size_t hits;
+  size_t misses;
+  size_t evictions;
+};
+
+// Keys may contain binary arguments (e.g. vector blobs), so they are compared by length
+static uint64_t keyHash(const void *key) {
+  const QueryCacheKey *k = key;
+  return dictGenHashFunction(k->data, (int)k->len);
+}
+
+static int keyCompare(void *privdata, const void *key1, const void *key2) {
+  const QueryCacheKey *k1 = key1, *k2 = key2;
+  return k1->len == k2->len && !memcmp(k1->data, k2->data, k1->len);
+}
+
+static dictType queryCacheDictType = {
+    .hashFunction = keyHash,
+    .keyDup = NULL,
+    .valDup = NULL,
+    .keyCompare = keyCompare,
+    .keyDestructor = NULL,
+    .valDestructor = NULL,
+};
+
+static inline size_t entryMemory(const QueryCacheEntry *e) {
+  return sizeof(*e) + e->key.len + array_len(e->reply);
+}
+
+// Assumes the cache is locked
+static void removeEntry(QueryCache *qc, QueryCacheEntry *e) {
+  dictDelete(qc->entries, &e->key);
+  dllist_delete(&e->llnode);
+  qc->memory -= entryMemory(e);
+  rm_free((char *)e->key.data);
+  array_free(e->reply);
+  rm_free(e);
+}
+
+QueryCache *QueryCache_New(void) {
+  QueryCache *qc = rm_calloc(1, sizeof(*qc));
+  pthread_mutex_init(&qc->lock, NULL);
+  qc->entries = dictCreate(&queryCacheDictType, NULL);
+  dllist_init(&qc->lru);
+  return qc;
+}
+
+static void clearUnsafe(QueryCache *qc) {
+  DLLIST_node *nn;
+  while ((nn = dllist_pop_tail(&qc->lru))) {
+    QueryCacheEntry *e = DLLIST_ITEM(nn, QueryCacheEntry, llnode);
+    dictDelete(qc->entries, &e->key);
+    rm_free((char *)e->key.data);
+    array_free(e->reply);
+    rm_free(e);
+  }
+  qc->memory = 0;
+}
+
+void QueryCache_Clear(QueryCache *qc) {
+  pthread_mutex_lock(&qc->lock);
+  clearUnsafe(qc);
+  pthread_mutex_unlock(&qc->lock);
+}
+
+void QueryCache_Free(QueryCache *qc) {
+  clearUnsafe(qc);
+  dictRelease(qc->entries);
+  pthread_mutex_destroy(&qc->lock);
+  rm_free(qc);
+}
+
+char *QueryCache_Get(QueryCache *qc, const char *key, size_t keyLen, uint64_t revision,
+                     size_t *len) {
+  QueryCacheKey k = {.data = key, .len = keyLen};
+  char *ret = NULL;
+
+  pthread_mutex_lock(&qc->lock);
+  QueryCacheEntry *e = dictFetchValue(qc->entries, &k);
+  if (e && e->revision != revision) {
+    // The index changed since the reply was recorded
+    removeEntry(qc, e);
+    e = NULL;
+  }
+  if (e) {
+    dllist_delete(&e->llnode);
+    dllist_prepend(&qc->lru, &e->llnode);
+    *len = array_len(e->reply);
+    ret = rm_malloc(*len);
+    memcpy(ret, e->reply, *len);
+    qc->hits++;
+  } else {
+    qc->misses++;
+  }
+  pthread_mutex_unlock(&qc->lock);
+  return ret;
+}
+
+void QueryCache_Put(QueryCache *qc, const char *key, size_t keyLen, uint64_t revision,
+                    arrayof(char) reply, size_t maxMemory) {
+  QueryCacheEntry *e = rm_malloc(sizeof(*e));
+  e->revision = revision;
+  e->key.len = keyLen;
+  e->reply = reply;
+  if (entryMemory(e) > maxMemory) {
+    array_free(reply);
+    rm_free(e);
+    return;
+  }
+  char *data = rm_malloc(keyLen);
+  memcpy(data, key, keyLen);
+  e->key.data = data;
+
+  pthread_mutex_lock(&qc->lock);
+  QueryCacheEntry *old = dictFetchValue(qc->entries, &e->key);
+  if (old) {
+    removeEntry(qc, old);
+  }
+  while (qc->memory + entryMemory(e) > maxMemory) {
+    DLLIST_node *nn = qc->lru.prev;
+    removeEntry(qc, DLLIST_ITEM(nn, QueryCacheEntry, llnode));
+    qc->evictions++;
+  }
+  dictAdd(qc->entries, &e->key, e);
+  dllist_prepend(&qc->lru, &e->llnode);
+  qc->memory += entryMemory(e);
+  pthread_mutex_unlock(&qc->lock);
+}
+
+void QueryCache_RenderStats(QueryCache *qc, RedisModule_Reply *reply) {
+  pthread_mutex_lock(&qc->lock);
+
+  RedisModule_ReplyKV_Map(reply, "query_cache_stats");
+
+    RedisModule_ReplyKV_LongLong(reply, "hits", qc->hits);
+    RedisModule_ReplyKV_LongLong(reply, "misses", qc->misses);
+    RedisModule_ReplyKV_LongLong(reply, "entries", dictSize(qc->entries));
+    RedisModule_ReplyKV_LongLong(reply, "memory", qc->memory);
+    RedisModule_ReplyKV_LongLong(reply, "evictions", qc->evictions);
+
+  RedisModule_Reply_MapEnd(reply);
+
+  pthread_mutex_unlock(&qc->lock);
+}
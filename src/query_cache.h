@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "util/arr.h"
+#include "reply.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* A per-index cache of query replies. Each entry maps a request key (the request arguments and
+ * output options) to the serialized reply it produced (see RedisModule_Reply_StartCapture),
+ * together with the index revision it was computed at. An entry is only valid as long as the
+ * index revision did not change, so writes to the index implicitly invalidate all entries.
+ * The cache is bounded by memory and evicts the least recently used entries.
+ * All functions are thread safe. */
+typedef struct QueryCache QueryCache;
+
+QueryCache *QueryCache_New(void);
+void QueryCache_Free(QueryCache *qc);
+
+/* Remove all the entries of the cache */
+void QueryCache_Clear(QueryCache *qc);
+
+/* Look up the reply of `key` at index revision `revision`. On a hit, returns a copy of the
+ * recorded reply (to be freed with rm_free) and sets `len` to its length. Returns NULL on a miss */
+char *QueryCache_Get(QueryCache *qc, const char *key, size_t keyLen, uint64_t revision,
+                     size_t *len);
+
+/* Store the recorded `reply` of `key` computed at index revision `revision`, evicting entries so
+ * that the cache does not exceed `maxMemory` bytes. Takes ownership of `reply` */
+void QueryCache_Put(QueryCache *qc, const char *key, size_t keyLen, uint64_t revision,
+                    arrayof(char) reply, size_t maxMemory);
+
+/* Reply with the cache statistics, as the `query_cache_stats` map of FT.INFO */
+void QueryCache_RenderStats(QueryCache *qc, RedisModule_Reply *reply);
+
+#ifdef __cplusplus
+}
+#endif
@@ -56,6 +56,8 @@ void QOptimizer_Parse(AREQ *req) {
     const char *scorer = req->searchopts.scorerName;
     if (!scorer) {      // default is BM25STD
       opt->scorerType = SCORER_TYPE_TERM;
+    } else if (!strcmp(scorer, BM25_STD_SCORER_NAME)) {
+      opt->scorerType = SCORER_TYPE_TERM;
     } else if (!strcmp(scorer, TFIDF_SCORER_NAME)) {
       opt->scorerType = SCORER_TYPE_TERM;
     } else if (!strcmp(scorer, TFIDF_DOCNORM_SCORER_NAME)) {
@@ -69,6 +71,9 @@ void QOptimizer_Parse(AREQ *req) {
     } else if (!strcmp(scorer, HAMMINGDISTANCE_SCORER)) {
       opt->scorerType = SCORER_TYPE_DOC;
     }
+    // the blocks of the term indexes bound the BM25STD score of their entries
+    opt->blockMax = IsSearch(req) && !(arng && arng->sortKeys) &&
+                    (!scorer || !strcmp(scorer, BM25_STD_SCORER_NAME));
   }
 }
 
@@ -182,12 +187,18 @@ void QOptimizer_QueryNodes(QueryNode *root, QOptimizer *opt) {
     }
   }
 
-  // there is no sorting field and scorer is required - we must check all results
-  if ((!isSortby && opt->scorerReq) || (root->type == QN_VECTOR && root->vn.vq->type == VECSIM_QT_KNN)) {
+  if (root->type == QN_VECTOR && root->vn.vq->type == VECSIM_QT_KNN) {
     opt->type = Q_OPT_NONE;
     return;
   }
 
+  // there is no sorting field and scorer is required - we must check all results, but those that
+  // cannot score into the top results
+  if (!isSortby && opt->scorerReq) {
+    opt->type = opt->blockMax ? Q_OPT_BLOCK_MAX : Q_OPT_NONE;
+    return;
+  }
+
   // there are no other filter except for our numeric
   // if has sortby, use limited range
   // else, return after enough result found
@@ -233,6 +244,16 @@ void QOptimizer_Iterators(AREQ *req, QOptimizer *opt) {
     case Q_OPT_FILTER:
       return;
 
+    // the score sorter keeps the lowest score of the top results in `minScore`
+    case Q_OPT_BLOCK_MAX: {
+      RSIndexStats stats = {0};
+      IndexSpec_GetStats(spec, &stats);
+      if (!EnableBlockMaxPruning(root, &req->qiter.minScore, stats.avgDocLen, spec->docs.maxScore)) {
+        opt->type = Q_OPT_NONE;
+      }
+      return;
+    }
+
     // limit range to number of required LIMIT
     case Q_OPT_PARTIAL_RANGE: {
       if (root->type == WILDCARD_ITERATOR) {
@@ -291,6 +312,8 @@ const char *QOptimizer_PrintType(QOptimizer *opt) {
       return "Undecided";
     case Q_OPT_FILTER:
       return "Filter";
+    case Q_OPT_BLOCK_MAX:
+      return "Block-max pruning";
   }
   return NULL;
 }
@@ -22,11 +22,12 @@ struct AREQ;
 ***********************************************************
 *  Y  *   N   *  Q_OPT_PARTIAL_RANGE  *  Q_OPT_NO_SORTER  *
 ***********************************************************
-*  N  *   Y   *    Q_OPT_HYBRID       *     Q_OPT_NONE    *
+*  N  *   Y   *    Q_OPT_HYBRID       *   (note2)         *
 ***********************************************************
 *  N  *   N   *  Q_OPT_PARTIAL_RANGE  *  Q_OPT_NO_SORTER  *
 **********************************************************/
 // note1: potential for filter or no sorter
+// note2: Q_OPT_BLOCK_MAX when scored with BM25STD, Q_OPT_NONE otherwise
 
 typedef enum {
   // No optimization
@@ -49,6 +50,9 @@ typedef enum {
   // Use `FILTER` result processor instead of numeric range
   Q_OPT_FILTER = 4,
 
+  // Sorted by BM25STD score. Skip the blocks that cannot score into the top results
+  Q_OPT_BLOCK_MAX = 5,
+
   // sortby other field. currently no optimization
   // Q_OPT_SORTBY_OTHER
 } Q_Optimize_Type;
@@ -66,6 +70,7 @@ typedef struct QOptimizer {
 
     bool scorerReq;             // does the query require a scorer (WITHSCORES does not count)
     ScorerType scorerType;      // 
+    bool blockMax;              // are the results sorted by BM25STD score only
 
     const char *fieldName;      // name of sortby field
     const FieldSpec *field;     // spec of sortby field
@@ -123,8 +123,18 @@ void InvertedIndex_RdbSave(RedisModuleIO *rdb, void *value) {
     RedisModule_SaveUnsigned(rdb, blk->firstId);
     RedisModule_SaveUnsigned(rdb, blk->lastId);
     RedisModule_SaveUnsigned(rdb, blk->numEntries);
-    if (IndexBlock_DataLen(blk)) {
-      RedisModule_SaveStringBuffer(rdb, IndexBlock_DataBuf(blk), IndexBlock_DataLen(blk));
+    if (IndexBlock_IsBitmap(blk)) {
+      // Bitmap blocks only exist in memory, and are saved as the deltas they replaced
+      Buffer deltas;
+      Buffer_Init(&deltas, blk->numEntries);
+      IndexBlock_DecodeBitmap(blk, &deltas);
+      RedisModule_SaveStringBuffer(rdb, deltas.data, deltas.offset);
+      Buffer_Free(&deltas);
+    } else if (IndexBlock_DataLen(blk)) {
+      // The skip checkpoints only exist in memory as well, and are not saved
+      const size_t entriesOffset = IndexBlock_EntriesOffset(blk);
+      RedisModule_SaveStringBuffer(rdb, IndexBlock_DataBuf(blk) + entriesOffset,
+                                   IndexBlock_DataLen(blk) - entriesOffset);
     } else {
       RedisModule_SaveStringBuffer(rdb, "", 0);
     }
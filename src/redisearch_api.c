@@ -270,8 +270,9 @@ int RediSearch_DeleteDocument(RefManager* rm, const void* docKey, size_t len) {
     if (DocTable_Delete(&sp->docs, docKey, len)) {
       // Delete returns true/false, not RM_{OK,ERR}
       sp->stats.numDocuments--;
+      sp->revision++;
       if (sp->gc) {
-        GCContext_OnDelete(sp->gc);
+        GCContext_OnDelete(sp->gc, id);
       }
     } else {
       rc = REDISMODULE_ERR;
@@ -864,7 +865,7 @@ int RediSearch_IndexInfo(RSIndex* rm, RSIdxInfo *info) {
    * Avoid rehashing the terms dictionary */
   dictPauseRehashing(sp->keysDict);
 
-  info->gcPolicy = sp->gc ? GC_POLICY_FORK : GC_POLICY_NONE;
+  info->gcPolicy = sp->gc ? sp->gc->policy : GC_POLICY_NONE;
   if (sp->rule) {
     info->score = sp->rule->score_default;
     info->lang = RSLanguage_ToString(sp->rule->lang_default);
@@ -896,13 +897,12 @@ int RediSearch_IndexInfo(RSIndex* rm, RSIdxInfo *info) {
   info->indexingFailures = sp->stats.indexError.error_count;
 
   if (sp->gc) {
-    // LLAPI always uses ForkGC
-    ForkGCStats gcStats = ((ForkGC *)sp->gc->gcCtx)->stats;
+    const GCStats *gcStats = GCContext_GetStats(sp->gc);
 
-    info->totalCollected = gcStats.totalCollected;
-    info->numCycles = gcStats.numCycles;
-    info->totalMSRun = gcStats.totalMSRun;
-    info->lastRunTimeMs = gcStats.lastRunTimeMs;
+    info->totalCollected = gcStats->totalCollected;
+    info->numCycles = gcStats->numCycles;
+    info->totalMSRun = gcStats->totalMSRun;
+    info->lastRunTimeMs = gcStats->lastRunTimeMs;
   }
 
   dictResumeRehashing(sp->keysDict);
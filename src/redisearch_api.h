@@ -92,6 +92,7 @@ MODULE_API_FUNC(int, RediSearch_GetCApiVersion)();
 
 #define GC_POLICY_NONE -1
 #define GC_POLICY_FORK 0
+#define GC_POLICY_THREAD 1
 
 struct RSIdxOptions {
   RSGetValueCallback gvcb;
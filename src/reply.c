@@ -13,6 +13,7 @@
 #include "rmutil/rm_assert.h"
 
 #include <math.h>
+#include <string.h>
 
 ///////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -111,13 +112,195 @@ static inline void json_add_close(RedisModule_Reply *reply, const char *s) {}
 
 //---------------------------------------------------------------------------------------------
 
+// A captured reply is a sequence of operations, each a tag byte followed by its operands:
+// a number, or a length-prefixed string (simple strings and errors also keep their NUL)
+enum {
+  CAPTURE_LONGLONG = 'L',
+  CAPTURE_DOUBLE = 'D',
+  CAPTURE_SIMPLE_STRING = 'S',
+  CAPTURE_STRING = 'B',
+  CAPTURE_NULL = 'N',
+  CAPTURE_ERROR = 'E',
+  CAPTURE_ARRAY = 'A',
+  CAPTURE_MAP = 'M',
+  CAPTURE_SET = 'T',
+  CAPTURE_SET_ARRAY_LENGTH = 'a',
+  CAPTURE_SET_MAP_LENGTH = 'm',
+  CAPTURE_SET_SET_LENGTH = 't',
+};
+
+static inline void _Capture(RedisModule_Reply *reply, char op, const void *data, size_t len) {
+  if (!reply->capture) {
+    return;
+  }
+  size_t pos = array_len(reply->capture);
+  reply->capture = array_grow(reply->capture, 1 + len);
+  reply->capture[pos] = op;
+  if (len) {
+    memcpy(reply->capture + pos + 1, data, len);
+  }
+}
+
+static inline void _CaptureString(RedisModule_Reply *reply, char op, const char *str, size_t len) {
+  if (!reply->capture) {
+    return;
+  }
+  size_t pos = array_len(reply->capture);
+  reply->capture = array_grow(reply->capture, 1 + sizeof(len) + len);
+  reply->capture[pos] = op;
+  memcpy(reply->capture + pos + 1, &len, sizeof(len));
+  memcpy(reply->capture + pos + 1 + sizeof(len), str, len);
+}
+
+static inline void _ReplyWithLongLong(RedisModule_Reply *reply, long long val) {
+  RedisModule_ReplyWithLongLong(reply->ctx, val);
+  _Capture(reply, CAPTURE_LONGLONG, &val, sizeof(val));
+}
+
+static inline void _ReplyWithDouble(RedisModule_Reply *reply, double val) {
+  RedisModule_ReplyWithDouble(reply->ctx, val);
+  _Capture(reply, CAPTURE_DOUBLE, &val, sizeof(val));
+}
+
+static inline void _ReplyWithSimpleString(RedisModule_Reply *reply, const char *val) {
+  RedisModule_ReplyWithSimpleString(reply->ctx, val);
+  _CaptureString(reply, CAPTURE_SIMPLE_STRING, val, strlen(val) + 1);
+}
+
+static inline void _ReplyWithStringBuffer(RedisModule_Reply *reply, const char *val, size_t len) {
+  RedisModule_ReplyWithStringBuffer(reply->ctx, val, len);
+  _CaptureString(reply, CAPTURE_STRING, val, len);
+}
+
+static inline void _ReplyWithCString(RedisModule_Reply *reply, const char *val) {
+  RedisModule_ReplyWithCString(reply->ctx, val);
+  _CaptureString(reply, CAPTURE_STRING, val, strlen(val));
+}
+
+static inline void _ReplyWithString(RedisModule_Reply *reply, RedisModuleString *val) {
+  RedisModule_ReplyWithString(reply->ctx, val);
+  if (reply->capture) {
+    size_t len;
+    const char *str = RedisModule_StringPtrLen(val, &len);
+    _CaptureString(reply, CAPTURE_STRING, str, len);
+  }
+}
+
+static inline void _ReplyWithNull(RedisModule_Reply *reply) {
+  RedisModule_ReplyWithNull(reply->ctx);
+  _Capture(reply, CAPTURE_NULL, NULL, 0);
+}
+
+static inline void _ReplyWithError(RedisModule_Reply *reply, const char *err) {
+  RedisModule_ReplyWithError(reply->ctx, err);
+  _CaptureString(reply, CAPTURE_ERROR, err, strlen(err) + 1);
+}
+
+static inline void _ReplyWithArray(RedisModule_Reply *reply, long len) {
+  RedisModule_ReplyWithArray(reply->ctx, len);
+  _Capture(reply, CAPTURE_ARRAY, &len, sizeof(len));
+}
+
+static inline void _ReplyWithMap(RedisModule_Reply *reply, long len) {
+  RedisModule_ReplyWithMap(reply->ctx, len);
+  _Capture(reply, CAPTURE_MAP, &len, sizeof(len));
+}
+
+static inline void _ReplyWithSet(RedisModule_Reply *reply, long len) {
+  RedisModule_ReplyWithSet(reply->ctx, len);
+  _Capture(reply, CAPTURE_SET, &len, sizeof(len));
+}
+
+static inline void _ReplySetArrayLength(RedisModule_Reply *reply, long len) {
+  RedisModule_ReplySetArrayLength(reply->ctx, len);
+  _Capture(reply, CAPTURE_SET_ARRAY_LENGTH, &len, sizeof(len));
+}
+
+static inline void _ReplySetMapLength(RedisModule_Reply *reply, long len) {
+  RedisModule_ReplySetMapLength(reply->ctx, len);
+  _Capture(reply, CAPTURE_SET_MAP_LENGTH, &len, sizeof(len));
+}
+
+static inline void _ReplySetSetLength(RedisModule_Reply *reply, long len) {
+  RedisModule_ReplySetSetLength(reply->ctx, len);
+  _Capture(reply, CAPTURE_SET_SET_LENGTH, &len, sizeof(len));
+}
+
+void RedisModule_Reply_StartCapture(RedisModule_Reply *reply) {
+  if (!reply->capture) {
+    reply->capture = array_new(char, 256);
+  }
+}
+
+arrayof(char) RedisModule_Reply_TakeCapture(RedisModule_Reply *reply) {
+  arrayof(char) capture = reply->capture;
+  reply->capture = NULL;
+  return capture;
+}
+
+void RedisModule_Reply_Replay(RedisModuleCtx *ctx, const char *capture, size_t len) {
+  const char *p = capture, *end = capture + len;
+  while (p < end) {
+    const char op = *p++;
+    switch (op) {
+    case CAPTURE_LONGLONG: {
+      long long val;
+      memcpy(&val, p, sizeof(val));
+      p += sizeof(val);
+      RedisModule_ReplyWithLongLong(ctx, val);
+      break;
+    }
+    case CAPTURE_DOUBLE: {
+      double val;
+      memcpy(&val, p, sizeof(val));
+      p += sizeof(val);
+      RedisModule_ReplyWithDouble(ctx, val);
+      break;
+    }
+    case CAPTURE_SIMPLE_STRING:
+    case CAPTURE_STRING:
+    case CAPTURE_ERROR: {
+      size_t n;
+      memcpy(&n, p, sizeof(n));
+      p += sizeof(n);
+      if (op == CAPTURE_SIMPLE_STRING) {
+        RedisModule_ReplyWithSimpleString(ctx, p);
+      } else if (op == CAPTURE_ERROR) {
+        RedisModule_ReplyWithError(ctx, p);
+      } else {
+        RedisModule_ReplyWithStringBuffer(ctx, p, n);
+      }
+      p += n;
+      break;
+    }
+    case CAPTURE_NULL:
+      RedisModule_ReplyWithNull(ctx);
+      break;
+    default: {
+      long n;
+      memcpy(&n, p, sizeof(n));
+      p += sizeof(n);
+      switch (op) {
+      case CAPTURE_ARRAY: RedisModule_ReplyWithArray(ctx, n); break;
+      case CAPTURE_MAP: RedisModule_ReplyWithMap(ctx, n); break;
+      case CAPTURE_SET: RedisModule_ReplyWithSet(ctx, n); break;
+      case CAPTURE_SET_ARRAY_LENGTH: RedisModule_ReplySetArrayLength(ctx, n); break;
+      case CAPTURE_SET_MAP_LENGTH: RedisModule_ReplySetMapLength(ctx, n); break;
+      case CAPTURE_SET_SET_LENGTH: RedisModule_ReplySetSetLength(ctx, n); break;
+      default: RS_LOG_ASSERT(0, "corrupt reply capture");
+      }
+    }
+    }
+  }
+}
+
+//---------------------------------------------------------------------------------------------
+
 RedisModule_Reply RedisModule_NewReply(RedisModuleCtx *ctx) {
+  RedisModule_Reply reply = { .ctx = ctx, .resp3 = _ReplyMap(ctx) && _ReplySet(ctx) };
 #ifdef REDISMODULE_REPLY_DEBUG
-  RedisModule_Reply reply = { ctx, _ReplyMap(ctx) && _ReplySet(ctx), 0, NULL, NULL };
   reply.json = array_new(char, 1);
   *reply.json = '\0';
-#else
-  RedisModule_Reply reply = { ctx, _ReplyMap(ctx) && _ReplySet(ctx), 0, NULL };
 #endif
   return reply;
 }
@@ -127,6 +310,10 @@ int RedisModule_EndReply(RedisModule_Reply *reply) {
   if (reply->stack) {
     array_free(reply->stack);
   }
+  if (reply->capture) {
+    array_free(reply->capture);
+    reply->capture = NULL;
+  }
 #ifdef REDISMODULE_REPLY_DEBUG
   if (reply->json) {
     array_free(reply->json);
@@ -173,35 +360,35 @@ static int _RedisModule_Reply_Pop(RedisModule_Reply *reply) {
 //---------------------------------------------------------------------------------------------
 
 int RedisModule_Reply_LongLong(RedisModule_Reply *reply, long long val) {
-  RedisModule_ReplyWithLongLong(reply->ctx, val);
+  _ReplyWithLongLong(reply, val);
   json_add(reply, false, "%ld", val);
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
 
 int RedisModule_Reply_Double(RedisModule_Reply *reply, double val) {
-  RedisModule_ReplyWithDouble(reply->ctx, val);
+  _ReplyWithDouble(reply, val);
   json_add(reply, false, "%f", val);
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
 
 int RedisModule_Reply_SimpleString(RedisModule_Reply *reply, const char *val) {
-  RedisModule_ReplyWithSimpleString(reply->ctx, val);
+  _ReplyWithSimpleString(reply, val);
   json_add(reply, false, "\"%s\"", val);
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
 
 int RedisModule_Reply_StringBuffer(RedisModule_Reply *reply, const char *val, size_t len) {
-  RedisModule_ReplyWithStringBuffer(reply->ctx, val, len);
+  _ReplyWithStringBuffer(reply, val, len);
   json_add(reply, false, "\"%.*s\"", len, val);
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
 
 int RedisModule_Reply_CString(RedisModule_Reply *reply, const char *val) {
-  RedisModule_ReplyWithCString(reply->ctx, val);
+  _ReplyWithCString(reply, val);
   json_add(reply, false, "\"%s\"", val);
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
@@ -212,7 +399,7 @@ int RedisModule_Reply_SimpleStringf(RedisModule_Reply *reply, const char *fmt, .
   va_start(args, fmt);
   char *p;
   rm_vasprintf(&p, fmt, args);
-  RedisModule_ReplyWithSimpleString(reply->ctx, p);
+  _ReplyWithSimpleString(reply, p);
   json_add(reply, false, "\"%s\"", p);
   rm_free(p);
   _RedisModule_Reply_Next(reply);
@@ -225,7 +412,7 @@ int RedisModule_Reply_Stringf(RedisModule_Reply *reply, const char *fmt, ...) {
   va_start(args, fmt);
   char *p;
   size_t len = rm_vasprintf(&p, fmt, args);
-  RedisModule_ReplyWithStringBuffer(reply->ctx, p, len);
+  _ReplyWithStringBuffer(reply, p, len);
   json_add(reply, false, "\"%.*s\"", len, p);
   rm_free(p);
   _RedisModule_Reply_Next(reply);
@@ -234,7 +421,7 @@ int RedisModule_Reply_Stringf(RedisModule_Reply *reply, const char *fmt, ...) {
 }
 
 int RedisModule_Reply_String(RedisModule_Reply *reply, const RedisModuleString *val) {
-  RedisModule_ReplyWithString(reply->ctx, (RedisModuleString*)val);
+  _ReplyWithString(reply, (RedisModuleString*)val);
 #ifdef REDISMODULE_REPLY_DEBUG
   size_t n;
   const char *p = RedisModule_StringPtrLen(val, &n);
@@ -245,14 +432,14 @@ int RedisModule_Reply_String(RedisModule_Reply *reply, const RedisModuleString *
 }
 
 int RedisModule_Reply_Null(RedisModule_Reply *reply) {
-  RedisModule_ReplyWithNull(reply->ctx);
+  _ReplyWithNull(reply);
   json_add(reply, false, "null");
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
 
 int RedisModule_Reply_Error(RedisModule_Reply *reply, const char *error) {
-  RedisModule_ReplyWithError(reply->ctx, error);
+  _ReplyWithError(reply, error);
   json_add(reply, false, "\"ERR: %s\"", error);
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
@@ -267,11 +454,11 @@ int RedisModule_Reply_Map(RedisModule_Reply *reply) {
 
   int type;
   if (reply->resp3) {
-    RedisModule_ReplyWithMap(reply->ctx, REDISMODULE_POSTPONED_LEN);
+    _ReplyWithMap(reply, REDISMODULE_POSTPONED_LEN);
     json_add(reply, true, "{ ");
     type = REDISMODULE_REPLY_MAP;
   } else {
-    RedisModule_ReplyWithArray(reply->ctx, REDISMODULE_POSTPONED_LEN);
+    _ReplyWithArray(reply, REDISMODULE_POSTPONED_LEN);
     json_add(reply, true, "[ ");
     type = REDISMODULE_REPLY_ARRAY;
   }
@@ -288,9 +475,9 @@ int RedisModule_Reply_MapEnd(RedisModule_Reply *reply) {
   }
   int count = _RedisModule_Reply_Pop(reply);
   if (reply->resp3) {
-    RedisModule_ReplySetMapLength(reply->ctx, count / 2);
+    _ReplySetMapLength(reply, count / 2);
   } else {
-    RedisModule_ReplySetArrayLength(reply->ctx, count);
+    _ReplySetArrayLength(reply, count);
   }
   return REDISMODULE_OK;
 }
@@ -298,7 +485,7 @@ int RedisModule_Reply_MapEnd(RedisModule_Reply *reply) {
 int RedisModule_Reply_Array(RedisModule_Reply *reply) {
   RS_LOG_ASSERT(!RedisModule_Reply_LocalIsKey(reply), "reply: should not write an array as a key");
 
-  RedisModule_ReplyWithArray(reply->ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
+  _ReplyWithArray(reply, REDISMODULE_POSTPONED_ARRAY_LEN);
   json_add(reply, true, "[ ");
   _RedisModule_Reply_Next(reply);
   _RedisModule_Reply_Push(reply, REDISMODULE_REPLY_ARRAY);
@@ -308,13 +495,13 @@ int RedisModule_Reply_Array(RedisModule_Reply *reply) {
 int RedisModule_Reply_ArrayEnd(RedisModule_Reply *reply) {
   json_add_close(reply, " ]");
   int count = _RedisModule_Reply_Pop(reply);
-  RedisModule_ReplySetArrayLength(reply->ctx, count);
+  _ReplySetArrayLength(reply, count);
   return REDISMODULE_OK;
 }
 
 int RedisModule_Reply_EmptyArray(RedisModule_Reply *reply) {
   json_add(reply, false, "[]");
-  RedisModule_ReplyWithArray(reply->ctx, 0);
+  _ReplyWithArray(reply, 0);
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
@@ -322,10 +509,10 @@ int RedisModule_Reply_EmptyArray(RedisModule_Reply *reply) {
 int RedisModule_Reply_EmptyMap(RedisModule_Reply *reply) {
   if (reply->resp3) {
     json_add(reply, false, "{}");
-    RedisModule_ReplyWithMap(reply->ctx, 0);
+    _ReplyWithMap(reply, 0);
   } else {
     json_add(reply, false, "[]");
-    RedisModule_ReplyWithArray(reply->ctx, 0);
+    _ReplyWithArray(reply, 0);
   }
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
@@ -334,11 +521,11 @@ int RedisModule_Reply_EmptyMap(RedisModule_Reply *reply) {
 int RedisModule_Reply_Set(RedisModule_Reply *reply) {
   int type;
   if (reply->resp3) {
-    RedisModule_ReplyWithSet(reply->ctx, REDISMODULE_POSTPONED_LEN);
+    _ReplyWithSet(reply, REDISMODULE_POSTPONED_LEN);
     json_add(reply, true, "{ ");
     type = REDISMODULE_REPLY_SET;
   } else {
-    RedisModule_ReplyWithArray(reply->ctx, REDISMODULE_POSTPONED_LEN);
+    _ReplyWithArray(reply, REDISMODULE_POSTPONED_LEN);
     json_add(reply, true, "[ ");
     type = REDISMODULE_REPLY_ARRAY;
   }
@@ -355,9 +542,9 @@ int RedisModule_Reply_SetEnd(RedisModule_Reply *reply) {
   }
   int count = _RedisModule_Reply_Pop(reply);
   if (reply->resp3) {
-    RedisModule_ReplySetSetLength(reply->ctx, count);
+    _ReplySetSetLength(reply, count);
   } else {
-    RedisModule_ReplySetArrayLength(reply->ctx, count);
+    _ReplySetArrayLength(reply, count);
   }
   return REDISMODULE_OK;
 }
@@ -365,18 +552,18 @@ int RedisModule_Reply_SetEnd(RedisModule_Reply *reply) {
 //---------------------------------------------------------------------------------------------
 
 int RedisModule_ReplyKV_LongLong(RedisModule_Reply *reply, const char *key, long long val) {
-  RedisModule_ReplyWithSimpleString(reply->ctx, key);
+  _ReplyWithSimpleString(reply, key);
   json_add(reply, false, "\"%s\"", key);
   _RedisModule_Reply_Next(reply);
-  RedisModule_ReplyWithLongLong(reply->ctx, val);
+  _ReplyWithLongLong(reply, val);
   json_add(reply, false, "%ld", val);
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
 
 int RedisModule_ReplyKV_Double(RedisModule_Reply *reply, const char *key, double val) {
-  RedisModule_ReplyWithSimpleString(reply->ctx, key);
-  RedisModule_ReplyWithDouble(reply->ctx, val);
+  _ReplyWithSimpleString(reply, key);
+  _ReplyWithDouble(reply, val);
   json_add(reply, false, "\"%s\"", key);
   _RedisModule_Reply_Next(reply);
   json_add(reply, false, "%f", val);
@@ -385,18 +572,18 @@ int RedisModule_ReplyKV_Double(RedisModule_Reply *reply, const char *key, double
 }
 
 int RedisModule_ReplyKV_SimpleString(RedisModule_Reply *reply, const char *key, const char *val) {
-  RedisModule_ReplyWithSimpleString(reply->ctx, key);
+  _ReplyWithSimpleString(reply, key);
   json_add(reply, false, "\"%s\"", key);
   _RedisModule_Reply_Next(reply);
-  RedisModule_ReplyWithSimpleString(reply->ctx, val);
+  _ReplyWithSimpleString(reply, val);
   json_add(reply, false, "\"%s\"", val);
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
 
 int RedisModule_ReplyKV_StringBuffer(RedisModule_Reply *reply, const char *key, const char *val, size_t len) {
-  RedisModule_ReplyWithSimpleString(reply->ctx, key);
-  RedisModule_ReplyWithStringBuffer(reply->ctx, val, len);
+  _ReplyWithSimpleString(reply, key);
+  _ReplyWithStringBuffer(reply, val, len);
   json_add(reply, false, "\"%s\"", key);
   _RedisModule_Reply_Next(reply);
   json_add(reply, false, "\"%.*s\"", len, val);
@@ -405,9 +592,9 @@ int RedisModule_ReplyKV_StringBuffer(RedisModule_Reply *reply, const char *key,
 }
 
 int RedisModule_ReplyKV_String(RedisModule_Reply *reply, const char *key, const RedisModuleString *val) {
-  RedisModule_ReplyWithSimpleString(reply->ctx, key);
+  _ReplyWithSimpleString(reply, key);
   json_add(reply, false, "\"%s\"", key);
-  RedisModule_ReplyWithString(reply->ctx, (RedisModuleString*)val);
+  _ReplyWithString(reply, (RedisModuleString*)val);
   _RedisModule_Reply_Next(reply);
 
 #ifdef REDISMODULE_REPLY_DEBUG
@@ -425,7 +612,7 @@ int RedisModule_ReplyKV_SimpleStringf(RedisModule_Reply *reply, const char *key,
   va_start(args, fmt);
   char *p;
   rm_vasprintf(&p, fmt, args);
-  RedisModule_ReplyWithSimpleString(reply->ctx, p);
+  _ReplyWithSimpleString(reply, p);
   json_add(reply, false, "\"%s\"", p);
   rm_free(p);
   _RedisModule_Reply_Next(reply);
@@ -434,17 +621,17 @@ int RedisModule_ReplyKV_SimpleStringf(RedisModule_Reply *reply, const char *key,
 }
 
 int RedisModule_ReplyKV_Null(RedisModule_Reply *reply, const char *key) {
-  RedisModule_ReplyWithSimpleString(reply->ctx, key);
+  _ReplyWithSimpleString(reply, key);
   json_add(reply, false, "\"%s\"", key);
   _RedisModule_Reply_Next(reply);
-  RedisModule_ReplyWithNull(reply->ctx);
+  _ReplyWithNull(reply);
   json_add(reply, false, "null");
   _RedisModule_Reply_Next(reply);
   return REDISMODULE_OK;
 }
 
 int RedisModule_ReplyKV_Array(RedisModule_Reply *reply, const char *key) {
-  RedisModule_ReplyWithSimpleString(reply->ctx, key);
+  _ReplyWithSimpleString(reply, key);
   json_add(reply, false, "\"%s\"", key);
   _RedisModule_Reply_Next(reply);
 
@@ -455,7 +642,7 @@ int RedisModule_ReplyKV_Array(RedisModule_Reply *reply, const char *key) {
 }
 
 int RedisModule_ReplyKV_Map(RedisModule_Reply *reply, const char *key) {
-  RedisModule_ReplyWithSimpleString(reply->ctx, key);
+  _ReplyWithSimpleString(reply, key);
   json_add(reply, false, "\"%s\"", key);
   _RedisModule_Reply_Next(reply);
 
@@ -465,7 +652,7 @@ int RedisModule_ReplyKV_Map(RedisModule_Reply *reply, const char *key) {
 }
 
 int RedisModule_ReplyKV_Set(RedisModule_Reply *reply, const char *key) {
-  RedisModule_ReplyWithSimpleString(reply->ctx, key);
+  _ReplyWithSimpleString(reply, key);
   json_add(reply, false, "\"%s\"", key);
   _RedisModule_Reply_Next(reply);
 
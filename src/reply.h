@@ -33,6 +33,7 @@ typedef struct RedisModule_Reply {
   bool resp3;
   int count;
   arrayof(struct RedisModule_Reply_StackEntry) stack;
+  arrayof(char) capture;  // Recording of the reply, see RedisModule_Reply_StartCapture
 #ifdef REDISMODULE_REPLY_DEBUG
   arrayof(char) json;
 #endif
@@ -46,6 +47,15 @@ int RedisModule_Reply_LocalCount(RedisModule_Reply *reply);
 RedisModule_Reply RedisModule_NewReply(RedisModuleCtx *ctx);
 int RedisModule_EndReply(RedisModule_Reply *reply);
 
+/* Record everything sent through `reply` from now on, so it can be sent again to another client
+ * with RedisModule_Reply_Replay */
+void RedisModule_Reply_StartCapture(RedisModule_Reply *reply);
+/* Stop recording and return the recording (an array owned by the caller), or NULL if the reply
+ * was not being recorded */
+arrayof(char) RedisModule_Reply_TakeCapture(RedisModule_Reply *reply);
+/* Send a reply recorded by RedisModule_Reply_StartCapture */
+void RedisModule_Reply_Replay(RedisModuleCtx *ctx, const char *capture, size_t len);
+
 int RedisModule_Reply_LongLong(RedisModule_Reply *reply, long long val);
 int RedisModule_Reply_Double(RedisModule_Reply *reply, double val);
 int RedisModule_Reply_SimpleString(RedisModule_Reply *reply, const char *val);
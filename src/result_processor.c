@@ -95,6 +95,34 @@ typedef struct {
   size_t timeoutLimiter;    // counter to limit number of calls to TimedOut_WithCounter()
 } RPIndexIterator;
 
+/* Returns true if the sorter downstream already holds enough results that are all better than the
+ * document's sortable value, so the document cannot make it into the sorted results */
+static inline bool rpidxBelowSortThreshold(const QueryProcessingCtx *qctx, const RSDocumentMetadata *dmd) {
+  if (!qctx->sortThreshold.active || !dmd->sortVector ||
+      RSSortingVector_Length(dmd->sortVector) <= qctx->sortThreshold.svidx) {
+    return false;
+  }
+  const RSValue *v = RSSortingVector_Get(dmd->sortVector, qctx->sortThreshold.svidx);
+  if (!v || v->t != RSValue_Number) {
+    return false;
+  }
+  return qctx->sortThreshold.ascending ? v->numval > qctx->sortThreshold.value
+                                       : v->numval < qctx->sortThreshold.value;
+}
+
+/* Returns true if the document is in a slot this shard no longer owns, while slots are trimmed */
+static inline bool rpidxIsTrimmed(const RSDocumentMetadata *dmd) {
+  if (!isTrimming || !RedisModule_ShardingGetKeySlot) {
+    return false;
+  }
+  RedisModuleString *key = RedisModule_CreateString(NULL, dmd->keyPtr, sdslen(dmd->keyPtr));
+  int slot = RedisModule_ShardingGetKeySlot(key);
+  RedisModule_FreeString(NULL, key);
+  int firstSlot, lastSlot;
+  RedisModule_ShardingGetSlotRange(&firstSlot, &lastSlot);
+  return firstSlot > slot || lastSlot < slot;
+}
+
 /* Next implementation */
 static int rpidxNext(ResultProcessor *base, SearchResult *res) {
   RPIndexIterator *self = (RPIndexIterator *)base;
@@ -142,20 +170,20 @@ static int rpidxNext(ResultProcessor *base, SearchResult *res) {
       continue;
     }
 
-    if (isTrimming && RedisModule_ShardingGetKeySlot) {
-      RedisModuleString *key = RedisModule_CreateString(NULL, dmd->keyPtr, sdslen(dmd->keyPtr));
-      int slot = RedisModule_ShardingGetKeySlot(key);
-      RedisModule_FreeString(NULL, key);
-      int firstSlot, lastSlot;
-      RedisModule_ShardingGetSlotRange(&firstSlot, &lastSlot);
-      if (firstSlot > slot || lastSlot < slot) {
-        DMD_Return(dmd);
-        continue;
-      }
+    if (rpidxIsTrimmed(dmd)) {
+      DMD_Return(dmd);
+      continue;
     }
 
     // Increment the total results barring deleted results
     base->parent->totalResults++;
+
+    // The result is counted, but there is no need to pass it downstream if it is sure to be
+    // rejected by the sorter
+    if (rpidxBelowSortThreshold(base->parent, dmd)) {
+      DMD_Return(dmd);
+      continue;
+    }
     break;
   }
 
@@ -168,6 +196,48 @@ static int rpidxNext(ResultProcessor *base, SearchResult *res) {
   return RS_RESULT_OK;
 }
 
+// The number of ids read from the root iterator at once when only counting the results
+#define RP_INDEX_BATCH_SIZE 256
+
+/* Count the valid results of the root iterator into `*count`, reading their ids in batches rather
+ * than building each result. Used by a counter right downstream, which has no use for the results */
+static int rpidxCount(ResultProcessor *base, size_t *count) {
+  RPIndexIterator *self = (RPIndexIterator *)base;
+  IndexIterator *it = self->iiter;
+  RedisSearchCtx *sctx = RP_SCTX(base);
+  if (sctx->flags == RS_CTX_UNSET) {
+    RedisSearchCtx_LockSpecRead(RP_SCTX(base));
+    ConcurrentSearchCtx_ReopenKeys(base->parent->conc);
+  }
+
+  t_docId ids[RP_INDEX_BATCH_SIZE];
+  DocTable *docs = &RP_SPEC(base)->docs;
+  while (1) {
+    size_t n;
+    int rc = IndexIterator_ReadBatch(it, ids, RP_INDEX_BATCH_SIZE, &n);
+    for (size_t i = 0; i < n; i++) {
+      if (TimedOut_WithCounter(&sctx->time.timeout, &self->timeoutLimiter) == TIMED_OUT) {
+        return UnlockSpec_and_ReturnRPResult(base, RS_RESULT_TIMEDOUT);
+      }
+      const RSDocumentMetadata *dmd = DocTable_Borrow(docs, ids[i]);
+      if (dmd && !(dmd->flags & Document_Deleted) &&
+          !DocTable_IsDocExpired(docs, dmd, &sctx->time.current) && !rpidxIsTrimmed(dmd)) {
+        base->parent->totalResults++;
+        (*count)++;
+      }
+      DMD_Return(dmd);
+    }
+    switch (rc) {
+      case INDEXREAD_OK:
+        continue;
+      case INDEXREAD_TIMEOUT:
+        return UnlockSpec_and_ReturnRPResult(base, RS_RESULT_TIMEDOUT);
+      default:
+        return UnlockSpec_and_ReturnRPResult(base, RS_RESULT_EOF);
+    }
+  }
+}
+
 static void rpidxFree(ResultProcessor *iter) {
   rm_free(iter);
 }
@@ -374,8 +444,93 @@ typedef struct {
 
   // Whether a timeout warning needs to be propagated down the downstream
   bool timedOut;
+
+  // Whether the worst sort key in the heap is published to the root processor as a threshold.
+  // Decided once, when the heap first fills up
+  bool thresholdChecked;
+  bool publishThreshold;
 } RPSorter;
 
+/* A sort key of a result. Numbers are kept inline, so comparing them does not dereference the
+ * row, the sorting vector of the document and the value */
+typedef struct {
+  const RSValue *value;  // NULL if the result has no value for the key
+  double num;            // the value, if it is a number
+  bool isNum;
+} RPSorterKey;
+
+/* A result in the sorter's heap, with its sort keys packed after it. The keys are looked up once
+ * when the result arrives, rather than on each of the comparisons in the heap */
+typedef struct {
+  SearchResult r;
+  RPSorterKey keys[];
+} SorterResult;
+
+static inline size_t rpsortNumKeys(const RPSorter *self) {
+  return MIN(self->fieldcmp.nkeys, SORTASCMAP_MAXFIELDS);
+}
+
+static SearchResult *rpsortNewResult(const RPSorter *self) {
+  return rm_calloc(1, sizeof(SorterResult) + rpsortNumKeys(self) * sizeof(RPSorterKey));
+}
+
+static void rpsortLoadKeys(const RPSorter *self, SearchResult *r) {
+  RPSorterKey *keys = ((SorterResult *)r)->keys;
+  for (size_t i = 0; i < rpsortNumKeys(self); i++) {
+    const RSValue *v = RLookup_GetItem(self->fieldcmp.keys[i], &r->rowdata);
+    keys[i].value = v;
+    keys[i].isNum = v && v->t == RSValue_Number;
+    keys[i].num = keys[i].isNum ? v->numval : 0;
+  }
+}
+
+/* The root processor can only filter by the first sort key if the value it reads is the one the
+ * sorter compares, and if dropping a result there does not change the total count. This holds when
+ * the sorter reads straight from the root processor (profiling aside), and for an index root, when
+ * the key comes from the sorting vector. Scorers may filter out results and metrics write to rows,
+ * so we do not look past them. A network root reads the key from the rows it builds, and only
+ * uses the threshold if the shards sorted their replies by the same keys */
+static bool rpsortCanPublishThreshold(const RPSorter *self) {
+  if (!self->fieldcmp.nkeys) {
+    return false;
+  }
+  for (const ResultProcessor *up = self->base.upstream; up; up = up->upstream) {
+    switch (up->type) {
+      case RP_INDEX:
+        return up->upstream == NULL && (self->fieldcmp.keys[0]->flags & RLOOKUP_F_SVSRC);
+      case RP_NETWORK:
+        return up->upstream == NULL;
+      case RP_PROFILE:
+        continue;
+      default:
+        return false;
+    }
+  }
+  return false;
+}
+
+/* Publish the first sort key of the worst result in the (full) heap. The heap only gets better, so
+ * the threshold only gets tighter */
+static void rpsortUpdateThreshold(RPSorter *self) {
+  if (!self->thresholdChecked) {
+    self->thresholdChecked = true;
+    self->publishThreshold = rpsortCanPublishThreshold(self);
+  }
+  if (!self->publishThreshold) {
+    return;
+  }
+  const SorterResult *minh = mmh_peek_min(self->pq);
+  if (!minh || !minh->keys[0].isNum) {
+    return;
+  }
+  QueryProcessingCtx *qctx = self->base.parent;
+  qctx->sortThreshold.active = true;
+  qctx->sortThreshold.ascending = SORTASCMAP_GETASC(self->fieldcmp.ascendMap, 0);
+  qctx->sortThreshold.svidx = self->fieldcmp.keys[0]->svidx;
+  qctx->sortThreshold.key = self->fieldcmp.keys[0];
+  qctx->sortThreshold.value = minh->keys[0].num;
+}
+
 /* Yield - pops the current top result from the heap */
 static int rpsortNext_Yield(ResultProcessor *rp, SearchResult *r) {
   RPSorter *self = (RPSorter *)rp;
@@ -422,6 +577,7 @@ static int rpsortNext_innerLoop(ResultProcessor *rp, SearchResult *r) {
     // whoops!
     return rc;
   }
+  rpsortLoadKeys(self, self->pooledResult);
 
   // If the queue is not full - we just push the result into it
   if (self->pq->count < self->pq->size) {
@@ -433,7 +589,10 @@ static int rpsortNext_innerLoop(ResultProcessor *rp, SearchResult *r) {
       rp->parent->minScore = self->pooledResult->score;
     }
     // we need to allocate a new result for the next iteration
-    self->pooledResult = rm_calloc(1, sizeof(*self->pooledResult));
+    self->pooledResult = rpsortNewResult(self);
+    if (self->pq->count == self->pq->size) {
+      rpsortUpdateThreshold(self);
+    }
   } else {
     // find the min result
     SearchResult *minh = mmh_peek_min(self->pq);
@@ -447,6 +606,7 @@ static int rpsortNext_innerLoop(ResultProcessor *rp, SearchResult *r) {
     if (self->cmp(self->pooledResult, minh, self->cmpCtx) > 0) {
       self->pooledResult->indexResult = NULL;
       self->pooledResult = mmh_exchange_min(self->pq, self->pooledResult);
+      rpsortUpdateThreshold(self);
     }
     // clear the result in preparation for the next iteration
     SearchResult_Clear(self->pooledResult);
@@ -488,11 +648,18 @@ static int cmpByFields(const void *e1, const void *e2, const void *udata) {
     qerr = self->base.parent->err;
   }
 
-  for (size_t i = 0; i < self->fieldcmp.nkeys && i < SORTASCMAP_MAXFIELDS; i++) {
-    const RSValue *v1 = RLookup_GetItem(self->fieldcmp.keys[i], &h1->rowdata);
-    const RSValue *v2 = RLookup_GetItem(self->fieldcmp.keys[i], &h2->rowdata);
+  const RPSorterKey *keys1 = ((const SorterResult *)h1)->keys;
+  const RPSorterKey *keys2 = ((const SorterResult *)h2)->keys;
+  for (size_t i = 0; i < rpsortNumKeys(self); i++) {
+    const RSValue *v1 = keys1[i].value;
+    const RSValue *v2 = keys2[i].value;
     // take the ascending bit for this property from the ascending bitmap
     ascending = SORTASCMAP_GETASC(self->fieldcmp.ascendMap, i);
+    if (keys1[i].isNum && keys2[i].isNum) {
+      int rc = keys1[i].num > keys2[i].num ? 1 : (keys1[i].num < keys2[i].num ? -1 : 0);
+      if (rc != 0) return ascending ? -rc : rc;
+      continue;
+    }
     if (!v1 || !v2) {
       // If at least one of these has no sort key, it gets high value regardless of asc/desc
       if (v1) {
@@ -530,7 +697,7 @@ ResultProcessor *RPSorter_NewByFields(size_t maxresults, const RLookupKey **keys
   ret->fieldcmp.nkeys = nkeys;
 
   ret->pq = mmh_init_with_size(maxresults, ret->cmp, ret->cmpCtx, srDtor);
-  ret->pooledResult = rm_calloc(1, sizeof(*ret->pooledResult));
+  ret->pooledResult = rpsortNewResult(ret);
   ret->base.Next = rpsortNext_Accum;
   ret->base.Free = rpsortFree;
   ret->base.type = RP_SORTER;
@@ -665,6 +832,14 @@ static int rploaderNext(ResultProcessor *base, SearchResult *r) {
 static void rploaderFreeInternal(ResultProcessor *base) {
   RPLoader *lc = (RPLoader *)base;
   QueryError_ClearError(&lc->status);
+  if (lc->loadopts.keyPaths) {
+    for (size_t i = 0; i < lc->loadopts.nkeys; i++) {
+      if (lc->loadopts.keyPaths[i]) {
+        RedisModule_FreeString(NULL, lc->loadopts.keyPaths[i]);
+      }
+    }
+    rm_free(lc->loadopts.keyPaths);
+  }
   rm_free(lc->loadopts.keys);
 }
 
@@ -684,6 +859,13 @@ static void rploaderNew_setLoadOpts(RPLoader *self, RedisSearchCtx *sctx, RLooku
   self->loadopts.nkeys = nkeys;
   if (nkeys) {
     self->loadopts.mode = RLOOKUP_LOAD_KEYLIST;
+    // Create the field names once, rather than per field per loaded document
+    self->loadopts.keyPaths = rm_calloc(nkeys, sizeof(*self->loadopts.keyPaths));
+    for (size_t i = 0; i < nkeys; i++) {
+      if (keys[i]->path) {
+        self->loadopts.keyPaths[i] = RedisModule_CreateString(NULL, keys[i]->path, strlen(keys[i]->path));
+      }
+    }
   } else {
     self->loadopts.mode = RLOOKUP_LOAD_ALLKEYS;
     lk->options |= RLOOKUP_OPT_ALL_LOADED; // TODO: turn on only for HASH specs
@@ -825,12 +1007,35 @@ static int rpSafeLoader_ResetAndReturnLastCode(RPSafeLoader *self, SearchResult
 
 /*********************************************************************************/
 
+// How many results ahead of the loaded one we prefetch the metadata and key name of.
+// The metadata was last touched when the result left the index, so it is likely cold by now.
+#define SAFE_LOADER_PREFETCH_DISTANCE 4
+
+static inline const SearchResult *PeekResult(const RPSafeLoader *self, size_t idx) {
+  return self->BufferBlocks[idx / DEFAULT_BUFFER_BLOCK_SIZE] + (idx % DEFAULT_BUFFER_BLOCK_SIZE);
+}
+
 static void rpSafeLoader_Load(RPSafeLoader *self) {
   SearchResult *curr_res;
 
+  // Warm up the metadata of the first results
+  for (size_t i = 0; i < MIN(2 * SAFE_LOADER_PREFETCH_DISTANCE, self->buffer_results_count); i++) {
+    __builtin_prefetch(PeekResult(self, i)->dmd);
+  }
+
   // iterate the buffer.
   // TODO: implement `GetNextResult` that gets the current block to save calculation time.
   while ((curr_res = GetNextResult(self))) {
+    // `curr_result_index` already points past `curr_res`. Prefetch the metadata of a result two
+    // distances ahead, and the key name of a result one distance ahead, whose metadata we
+    // prefetched earlier
+    size_t next = self->curr_result_index - 1 + SAFE_LOADER_PREFETCH_DISTANCE;
+    if (next + SAFE_LOADER_PREFETCH_DISTANCE < self->buffer_results_count) {
+      __builtin_prefetch(PeekResult(self, next + SAFE_LOADER_PREFETCH_DISTANCE)->dmd);
+    }
+    if (next < self->buffer_results_count) {
+      __builtin_prefetch(PeekResult(self, next)->dmd->keyPtr);
+    }
     rpLoader_loadDocument(&self->base_loader, curr_res);
   }
 
@@ -1149,6 +1354,11 @@ static int rpcountNext(ResultProcessor *base, SearchResult *res) {
   int rc;
   RPCounter *self = (RPCounter *)base;
 
+  // Nothing between the index and the counter needs the results, so only their ids are read
+  if (base->upstream->type == RP_INDEX) {
+    return rpidxCount(base->upstream, &self->count);
+  }
+
   while ((rc = base->upstream->Next(base->upstream, res)) == RS_RESULT_OK) {
     self->count += 1;
     SearchResult_Clear(res);
@@ -88,6 +88,17 @@ typedef struct {
   // scorers
   double minScore;
 
+  // A bound on the first sort key, published by the sorter once its heap is full. Results whose
+  // sortable value is strictly worse than `value` can no longer enter the heap, so the root
+  // processor drops them before they reach the rest of the chain.
+  struct {
+    bool active;
+    bool ascending;
+    uint16_t svidx;               // sorting vector index of the key, for an index root
+    const struct RLookupKey *key; // the key itself, for a network root
+    double value;
+  } sortThreshold;
+
   // the total results found in the query, incremented by the root processors
   // and decremented by others who might disqualify results
   uint32_t totalResults;
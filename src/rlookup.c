@@ -304,7 +304,14 @@ void RLookup_Init(RLookup *lk, IndexSpecCache *spcache) {
   lk->spcache = spcache;
 }
 
+// Rows are usually written a few keys at a time, with increasing indices. Allocate room for
+// several of them upfront rather than growing the row one reallocation per key
+#define RLOOKUP_ROW_INITIAL_CAP 8
+
 void RLookup_WriteOwnKey(const RLookupKey *key, RLookupRow *row, RSValue *v) {
+  if (!row->dyn) {
+    row->dyn = array_new(RSValue *, MAX(key->dstidx + 1, RLOOKUP_ROW_INITIAL_CAP));
+  }
   // Find the pointer to write to ...
   RSValue **vptr = array_ensure_at(&row->dyn, key->dstidx, RSValue *);
   if (*vptr) {
@@ -319,18 +326,20 @@ void RLookup_WriteKey(const RLookupKey *key, RLookupRow *row, RSValue *v) {
   RLookup_WriteOwnKey(key, row, RSValue_IncrRef(v));
 }
 
-void RLookup_WriteKeyByName(RLookup *lookup, const char *name, size_t len, RLookupRow *dst, RSValue *v) {
+const RLookupKey *RLookup_WriteKeyByName(RLookup *lookup, const char *name, size_t len, RLookupRow *dst, RSValue *v) {
   // Get the key first
   RLookupKey *k = RLookup_FindKey(lookup, name, len);
   if (!k) {
     k = RLookup_GetKey_WriteEx(lookup, name, len, RLOOKUP_F_NAMEALLOC);
   }
   RLookup_WriteKey(k, dst, v);
+  return k;
 }
 
-void RLookup_WriteOwnKeyByName(RLookup *lookup, const char *name, size_t len, RLookupRow *row, RSValue *value) {
-  RLookup_WriteKeyByName(lookup, name, len, row, value);
+const RLookupKey *RLookup_WriteOwnKeyByName(RLookup *lookup, const char *name, size_t len, RLookupRow *row, RSValue *value) {
+  const RLookupKey *k = RLookup_WriteKeyByName(lookup, name, len, row, value);
   RSValue_Decref(value);
+  return k;
 }
 
 void RLookupRow_Wipe(RLookupRow *r) {
@@ -628,7 +637,7 @@ static inline bool isValueAvailable(const RLookupKey *kk, const RLookupRow *dst,
 }
 
 static int getKeyCommonHash(const RLookupKey *kk, RLookupRow *dst, RLookupLoadOptions *options,
-                        RedisModuleKey **keyobj) {
+                        RedisModuleKey **keyobj, const RedisModuleString *path) {
   if (isValueAvailable(kk, dst, options)) {
     return REDISMODULE_OK;
   }
@@ -637,8 +646,8 @@ static int getKeyCommonHash(const RLookupKey *kk, RLookupRow *dst, RLookupLoadOp
   // In this case, the flag must be obtained via HGET
   if (!*keyobj) {
     RedisModuleCtx *ctx = options->sctx->redisCtx;
-    RedisModuleString *keyName =
-        RedisModule_CreateString(ctx, keyPtr, strlen(keyPtr));
+    size_t keyLen = options->dmd ? sdslen(options->dmd->keyPtr) : strlen(keyPtr);
+    RedisModuleString *keyName = RedisModule_CreateString(ctx, keyPtr, keyLen);
     *keyobj = RedisModule_OpenKey(ctx, keyName, DOCUMENT_OPEN_KEY_QUERY_FLAGS);
     RedisModule_FreeString(ctx, keyName);
     if (!*keyobj) {
@@ -655,7 +664,11 @@ static int getKeyCommonHash(const RLookupKey *kk, RLookupRow *dst, RLookupLoadOp
   RedisModuleString *val = NULL;
   RSValue *rsv = NULL;
 
-  RedisModule_HashGet(*keyobj, REDISMODULE_HASH_CFIELDS, kk->path, &val, NULL);
+  if (path) {
+    RedisModule_HashGet(*keyobj, REDISMODULE_HASH_NONE, path, &val, NULL);
+  } else {
+    RedisModule_HashGet(*keyobj, REDISMODULE_HASH_CFIELDS, kk->path, &val, NULL);
+  }
 
   if (val != NULL) {
     // `val` was created by `RedisModule_HashGet` and is owned by us.
@@ -677,7 +690,7 @@ static int getKeyCommonHash(const RLookupKey *kk, RLookupRow *dst, RLookupLoadOp
 
 
 static int getKeyCommonJSON(const RLookupKey *kk, RLookupRow *dst, RLookupLoadOptions *options,
-                        RedisJSON *keyobj) {
+                        RedisJSON *keyobj, const RedisModuleString *path) {
   if (!japi) {
     QueryError_SetCode(options->status, QUERY_EUNSUPPTYPE);
     RedisModule_Log(RSDummyContext, "warning", "cannot operate on a JSON index as RedisJSON is not loaded");
@@ -733,7 +746,7 @@ static int getKeyCommonJSON(const RLookupKey *kk, RLookupRow *dst, RLookupLoadOp
 }
 
 typedef int (*GetKeyFunc)(const RLookupKey *kk, RLookupRow *dst, RLookupLoadOptions *options,
-                          void **keyobj);
+                          void **keyobj, const RedisModuleString *path);
 
 
 static int loadIndividualKeys(RLookup *it, RLookupRow *dst, RLookupLoadOptions *options) {
@@ -750,7 +763,8 @@ static int loadIndividualKeys(RLookup *it, RLookupRow *dst, RLookupLoadOptions *
   if (options->nkeys) {
     for (size_t ii = 0; ii < options->nkeys; ++ii) {
       const RLookupKey *kk = options->keys[ii];
-      if (getKey(kk, dst, options, &key) != REDISMODULE_OK) {
+      const RedisModuleString *path = options->keyPaths ? options->keyPaths[ii] : NULL;
+      if (getKey(kk, dst, options, &key, path) != REDISMODULE_OK) {
         goto done;
       }
     }
@@ -766,7 +780,7 @@ static int loadIndividualKeys(RLookup *it, RLookupRow *dst, RLookupLoadOptions *
           continue;
         }
       }
-      if (getKey(kk, dst, options, &key) != REDISMODULE_OK) {
+      if (getKey(kk, dst, options, &key, NULL) != REDISMODULE_OK) {
         goto done;
       }
     }
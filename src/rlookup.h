@@ -278,13 +278,16 @@ void RLookupRow_Move(const RLookup *lk, RLookupRow *src, RLookupRow *dst);
  * key.
  *
  * The reference count of the value will be incremented.
+ *
+ * Returns the key the value was written to, so callers writing the same names repeatedly can
+ * write to it directly.
  */
-void RLookup_WriteKeyByName(RLookup *lookup, const char *name, size_t len, RLookupRow *row, RSValue *value);
+const RLookupKey *RLookup_WriteKeyByName(RLookup *lookup, const char *name, size_t len, RLookupRow *row, RSValue *value);
 
 /**
  * Like WriteKeyByName, but consumes a refcount
  */
-void RLookup_WriteOwnKeyByName(RLookup *lookup, const char *name, size_t len, RLookupRow *row, RSValue *value);
+const RLookupKey *RLookup_WriteOwnKeyByName(RLookup *lookup, const char *name, size_t len, RLookupRow *row, RSValue *value);
 
 /** Get a value from the row, provided the key.
  *
@@ -355,6 +358,13 @@ typedef struct {
   /** Number of keys in keys array */
   size_t nkeys;
 
+  /**
+   * Optional. The paths of `keys` as Redis strings, created once by the caller and reused for
+   * every loaded hash document, instead of having Redis build a field name per field per document.
+   * An entry may be NULL, in which case the C string path is used.
+   */
+  RedisModuleString **keyPaths;
+
   /**
    * The following options control the loading of fields, in case non-SORTABLE
    * fields are desired.
@@ -42,6 +42,7 @@
 #include "util/hash/hash.h"
 #include "reply_macros.h"
 #include "notifications.h"
+#include "query_cache.h"
 
 #define INITIAL_DOC_TABLE_SIZE 1000
 
@@ -1530,6 +1531,7 @@ StrongRef IndexSpec_Parse(const HiddenString *name, const char **argv, int argc,
       {AC_MKUNFLAG(SPEC_NOHL_STR, &spec->flags, Index_StoreByteOffsets)},
       {AC_MKUNFLAG(SPEC_NOFIELDS_STR, &spec->flags, Index_StoreFieldFlags)},
       {AC_MKUNFLAG(SPEC_NOFREQS_STR, &spec->flags, Index_StoreFreqs)},
+      {AC_MKBITFLAG(SPEC_PACKEDPOSTINGS_STR, &spec->flags, Index_StorePacked)},
       {AC_MKBITFLAG(SPEC_SCHEMA_EXPANDABLE_STR, &spec->flags, Index_WideSchema)},
       {AC_MKBITFLAG(SPEC_ASYNC_STR, &spec->flags, Index_Async)},
       {AC_MKBITFLAG(SPEC_SKIPINITIALSCAN_STR, &spec->flags, Index_SkipInitialScan)},
@@ -1551,6 +1553,14 @@ StrongRef IndexSpec_Parse(const HiddenString *name, const char **argv, int argc,
     }
   }
 
+  // Packed postings hold only doc ids and frequencies
+  if ((spec->flags & Index_StorePacked) &&
+      (spec->flags & (Index_StoreFieldFlags | Index_StoreTermOffsets))) {
+    QueryError_SetError(status, QUERY_EPARSEARGS,
+                        SPEC_PACKEDPOSTINGS_STR " requires " SPEC_NOOFFSETS_STR " and " SPEC_NOFIELDS_STR);
+    goto failure;
+  }
+
   if (timeout != -1) {
     spec->flags |= Index_Temporary;
   }
@@ -1741,6 +1751,10 @@ static void IndexSpec_FreeUnlinkedData(IndexSpec *spec) {
   if (spec->existingDocs) {
     InvertedIndex_Free(spec->existingDocs);
   }
+  // Free cached query replies
+  if (spec->queryCache) {
+    QueryCache_Free(spec->queryCache);
+  }
   // Free synonym data
   if (spec->smap) {
     SynonymMap_Free(spec->smap);
@@ -2042,6 +2056,7 @@ IndexSpec *NewIndexSpec(const HiddenString *name) {
   sp->getValue = NULL;
   sp->getValueCtx = NULL;
   sp->fieldIdToIndex = array_new(t_fieldIndex, 0);
+  sp->queryCache = QueryCache_New();
 
   sp->timeout = 0;
   sp->isTimerSet = false;
@@ -2515,6 +2530,35 @@ if (scanner->isDebug) { \
 #define IF_DEBUG_PAUSE_CHECK_BEFORE_OOM_RETRY(scanner, ctx) IF_DEBUG_PAUSE_CHECK(scanner, ctx, pauseBeforeOOMRetry, DEBUG_INDEX_SCANNER_CODE_PAUSED_BEFORE_OOM_RETRY)
 #define IF_DEBUG_PAUSE_CHECK_ON_OOM(scanner, ctx) IF_DEBUG_PAUSE_CHECK(scanner, ctx, pauseOnOOM, DEBUG_INDEX_SCANNER_CODE_PAUSED_ON_OOM)
 
+// How long the background scan may keep the GIL for consecutive scan steps
+#define BG_INDEX_SCAN_SLICE_NS (100 * 1000)
+
+// Run scan steps under the GIL until the time slice is used up, instead of releasing and
+// re-acquiring the GIL after every step. A step usually covers a single key, so the lock hand-off
+// used to dominate the scan, while the main thread still waits for at most one slice.
+// Returns false once the scan is complete, like RedisModule_Scan.
+static bool scanTimeSlice(RedisModuleCtx *ctx, RedisModuleScanCursor *cursor,
+                          RedisModuleScanCB scanner_func, IndexesScanner *scanner) {
+  struct timespec now, deadline;
+  clock_gettime(CLOCK_MONOTONIC_RAW, &deadline);
+  deadline.tv_nsec += BG_INDEX_SCAN_SLICE_NS;
+  if (deadline.tv_nsec >= 1000000000) {
+    deadline.tv_sec += 1;
+    deadline.tv_nsec -= 1000000000;
+  }
+  do {
+    if (!RedisModule_Scan(ctx, cursor, scanner_func, scanner)) {
+      return false;
+    }
+    // Let the caller handle OOM and cancellation right away
+    if (scanner->scanFailedOnOOM || scanner->cancelled) {
+      break;
+    }
+    clock_gettime(CLOCK_MONOTONIC_RAW, &now);
+  } while (!rs_timer_ge(&now, &deadline));
+  return true;
+}
+
 static void Indexes_ScanAndReindexTask(IndexesScanner *scanner) {
   RS_LOG_ASSERT(scanner, "invalid IndexesScanner");
 
@@ -2545,7 +2589,7 @@ static void Indexes_ScanAndReindexTask(IndexesScanner *scanner) {
     }
     RedisModule_ThreadSafeContextLock(ctx);
   }
-  while (RedisModule_Scan(ctx, cursor, scanner_func, scanner)) {
+  while (scanTimeSlice(ctx, cursor, scanner_func, scanner)) {
     RedisModule_ThreadSafeContextUnlock(ctx);
     counter++;
     if (counter % RSGlobalConfig.numBGIndexingIterationsBeforeSleep == 0) {
@@ -2903,6 +2947,7 @@ int IndexSpec_CreateFromRdb(RedisModuleCtx *ctx, RedisModuleIO *rdb, int encver,
   IndexSpec_MakeKeyless(sp);
   sp->fieldIdToIndex = array_new(t_fieldIndex, 0);
   sp->docs = DocTable_New(INITIAL_DOC_TABLE_SIZE);
+  sp->queryCache = QueryCache_New();
   sp->specName = specName;
   sp->obfuscatedName = IndexSpec_FormatObfuscatedName(sp->specName);
   sp->flags = (IndexFlags)LoadUnsigned_IOError(rdb, goto cleanup);
@@ -3027,6 +3072,7 @@ void *IndexSpec_LegacyRdbLoad(RedisModuleIO *rdb, int encver) {
   sp->numSortableFields = 0;
   sp->terms = NULL;
   sp->docs = DocTable_New(INITIAL_DOC_TABLE_SIZE);
+  sp->queryCache = QueryCache_New();
 
   sp->specName = NewHiddenString(legacyName, strlen(legacyName), true);
   sp->obfuscatedName = IndexSpec_FormatObfuscatedName(sp->specName);
@@ -3369,10 +3415,11 @@ void IndexSpec_DeleteDoc_Unsafe(IndexSpec *spec, RedisModuleCtx *ctx, RedisModul
 
   if (DocTable_DeleteR(&spec->docs, key)) {
     spec->stats.numDocuments--;
+    spec->revision++;
 
     // Increment the index's garbage collector's scanning frequency after document deletions
     if (spec->gc) {
-      GCContext_OnDelete(spec->gc);
+      GCContext_OnDelete(spec->gc, id);
     }
   }
 
@@ -3394,6 +3441,14 @@ void IndexSpec_DeleteDoc_Unsafe(IndexSpec *spec, RedisModuleCtx *ctx, RedisModul
   }
 }
 
+void IndexSpec_ClearQueryCache(IndexSpec *spec) {
+  // Running queries store their replies with the revision they started at
+  spec->revision++;
+  if (spec->queryCache) {
+    QueryCache_Clear(spec->queryCache);
+  }
+}
+
 int IndexSpec_DeleteDoc(IndexSpec *spec, RedisModuleCtx *ctx, RedisModuleString *key) {
   RedisSearchCtx sctx = SEARCH_CTX_STATIC(ctx, spec);
 
@@ -3515,6 +3570,22 @@ SpecOpIndexingCtx *Indexes_FindMatchingSchemaRules(RedisModuleCtx *ctx, RedisMod
   return res;
 }
 
+bool Indexes_MatchAnyPrefix(RedisModuleString *key) {
+  if (dictSize(specDict_g) == 0) {
+    return false;
+  }
+  size_t n;
+  const char *key_p = RedisModule_StringPtrLen(key, &n);
+  TrieMapResultBuf prefixes = TrieMap_FindPrefixes(SchemaPrefixes_g, key_p, n);
+  bool found = false;
+  for (int i = 0; i < TrieMapResultBuf_Len(&prefixes) && !found; ++i) {
+    SchemaPrefixNode *node = TrieMapResultBuf_GetByIndex(&prefixes, i);
+    found = array_len(node->index_specs) > 0;
+  }
+  TrieMapResultBuf_Free(prefixes);
+  return found;
+}
+
 static bool hashFieldChanged(IndexSpec *spec, RedisModuleString **hashFields) {
   if (hashFields == NULL) {
     return true;
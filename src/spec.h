@@ -51,6 +51,7 @@ struct IndexesScanner;
 #define SPEC_NOFIELDS_STR "NOFIELDS"
 #define SPEC_NOFREQS_STR "NOFREQS"
 #define SPEC_NOHL_STR "NOHL"
+#define SPEC_PACKEDPOSTINGS_STR "PACKEDPOSTINGS"
 #define SPEC_SCHEMA_STR "SCHEMA"
 #define SPEC_SCHEMA_EXPANDABLE_STR "MAXTEXTFIELDS"
 #define SPEC_TEMPORARY_STR "TEMPORARY"
@@ -190,6 +191,10 @@ typedef enum {
 
   Index_HasNonEmpty = 0x80000,  // Index has at least one field that does not indexes empty values
 
+  // Store doc ids (and frequencies) of text and tag postings in packed groups that are decoded a
+  // whole block at a time. Only valid together with NOOFFSETS and NOFIELDS
+  Index_StorePacked = 0x100000,
+
 } IndexFlags;
 
 // redis version (its here because most file include it with no problem,
@@ -356,6 +361,11 @@ typedef struct IndexSpec {
   // Contains all the existing documents (for wildcard search)
   InvertedIndex *existingDocs;
 
+  // Bumped whenever the indexed documents change. Guarded by the spec write lock
+  uint64_t revision;
+  // Replies of previous queries, valid for the revision they were computed at
+  struct QueryCache *queryCache;
+
 } IndexSpec;
 
 typedef enum SpecOp { SpecOp_Add, SpecOp_Del } SpecOp;
@@ -524,6 +534,10 @@ int IndexSpec_DeleteDoc(IndexSpec *spec, RedisModuleCtx *ctx, RedisModuleString
 // This function does not lock the spec. use it if you know the spec is locked for writing
 void IndexSpec_DeleteDoc_Unsafe(IndexSpec *spec, RedisModuleCtx *ctx, RedisModuleString *key, t_docId id);
 
+// Drop the cached query replies of the index, including those of queries still running.
+// Assumes the spec is locked for writing
+void IndexSpec_ClearQueryCache(IndexSpec *spec);
+
 /**
  * Indicate that the index spec should use an internal dictionary,rather than
  * the Redis keyspace
@@ -701,6 +715,8 @@ char *IndexSpec_FormatObfuscatedName(const HiddenString *specName);
 
 void Indexes_Init(RedisModuleCtx *ctx);
 void Indexes_Free(dict *d);
+/* Check whether the key name matches the prefix of any index, without opening the key */
+bool Indexes_MatchAnyPrefix(RedisModuleString *key);
 void Indexes_UpdateMatchingWithSchemaRules(RedisModuleCtx *ctx, RedisModuleString *key, DocumentType type,
                                            RedisModuleString **hashFields);
 void Indexes_DeleteMatchingWithSchemaRules(RedisModuleCtx *ctx, RedisModuleString *key,
@@ -70,6 +70,13 @@ int StopWordList_Contains(const StopWordList *sl, const char *term, size_t len)
   return ret;
 }
 
+int StopWordList_ContainsNormalized(const StopWordList *sl, const char *term, size_t len) {
+  if (sl == __empty_stopwords || !sl || !term) {
+    return 0;
+  }
+  return TrieMap_Find(sl->m, (char *)term, len) != TRIEMAP_NOTFOUND;
+}
+
 StopWordList *NewStopWordListCStr(const char **strs, size_t len) {
   if (len == 0 && __empty_stopwords) {
     return __empty_stopwords;
@@ -32,6 +32,10 @@ struct StopWordList;
 /* Check if a stopword list contains a term. The term must be already lowercased */
 int StopWordList_Contains(const struct StopWordList *sl, const char *term, size_t len);
 
+/* Check if a stopword list contains a term that was already normalized by the tokenizer, so
+ * it does not need to be copied and lowercased again */
+int StopWordList_ContainsNormalized(const struct StopWordList *sl, const char *term, size_t len);
+
 struct StopWordList *DefaultStopWordList();
 void StopWordList_FreeGlobals(void);
 
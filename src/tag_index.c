@@ -31,6 +31,7 @@ TagIndex *NewTagIndex() {
   idx->values = NewTrieMap();
   idx->uniqueId = tagUniqueId++;
   idx->suffix = NULL;
+  idx->indexFlags = Index_DocIdsOnly;
   return idx;
 }
 
@@ -189,7 +190,7 @@ struct InvertedIndex *TagIndex_OpenIndex(TagIndex *idx, const char *value,
   InvertedIndex *iv = TrieMap_Find(idx->values, value, len);
   if (iv == TRIEMAP_NOTFOUND) {
     if (create_if_missing) {
-      iv = NewInvertedIndex(Index_DocIdsOnly, 1, sz);
+      iv = NewInvertedIndex(idx->indexFlags, 1, sz);
       TrieMap_Add(idx->values, value, len, iv, NULL);
     }
   }
@@ -201,7 +202,7 @@ struct InvertedIndex *TagIndex_OpenIndex(TagIndex *idx, const char *value,
 // the inverted index (if a new inverted index was created)
 static inline size_t tagIndex_Put(TagIndex *idx, const char *value, size_t len, t_docId docId) {
   size_t sz;
-  IndexEncoder enc = InvertedIndex_GetEncoder(Index_DocIdsOnly);
+  IndexEncoder enc = InvertedIndex_GetEncoder(idx->indexFlags);
   RSIndexResult rec = {.type = RSResultType_Virtual, .docId = docId, .offsetsSz = 0, .freq = 0};
   InvertedIndex *iv = TagIndex_OpenIndex(idx, value, len, CREATE_INDEX, &sz);
   return InvertedIndex_WriteEntryGeneric(iv, enc, docId, &rec) + sz;
@@ -313,7 +314,9 @@ TagIndex *TagIndex_Open(const IndexSpec *spec, RedisModuleString *key, bool crea
     return NULL;
   }
   kdv = rm_calloc(1, sizeof(*kdv));
-  kdv->p = NewTagIndex();
+  TagIndex *idx = NewTagIndex();
+  idx->indexFlags |= spec->flags & Index_StorePacked;
+  kdv->p = idx;
   kdv->dtor = TagIndex_Free;
   dictAdd(spec->keysDict, key, kdv);
   return kdv->p;
@@ -106,6 +106,7 @@ typedef struct {
   uint32_t uniqueId;
   TrieMap *values;
   TrieMap *suffix;
+  IndexFlags indexFlags;  // The flags of the values' inverted indexes (doc ids only, maybe packed)
 } TagIndex;
 
 #define TAG_INDEX_KEY_FMT "tag:%s/%s"
@@ -0,0 +1,694 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#include "thread_gc.h"
+#include "util/arr.h"
+#include "util/dict.h"
+#include "search_ctx.h"
+#include "inverted_index.h"
+#include "redis_index.h"
+#include "numeric_index.h"
+#include "tag_index.h"
+#include "time_sample.h"
+#include "hll/hll.h"
+#include "module.h"
+#include "suffix.h"
+#include "rmutil/rm_assert.h"
+#include "info/global_stats.h"
+#include "obfuscation/obfuscation_api.h"
+#include "obfuscation/hidden.h"
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+
+typedef enum {
+  TGC_PHASE_TERMS,
+  TGC_PHASE_FIELDS,
+  TGC_PHASE_MISSING_FIELDS,
+  TGC_PHASE_EXISTING_DOCS,
+  TGC_PHASE_DONE,
+} TGCPhase;
+
+/* The state of a cycle, which is taken a step per periodic call. The spec is only referenced while
+ * a step holds its lock */
+typedef struct TGCCycle {
+  ThreadGC *gc;
+  StrongRef spec_ref;
+  RedisSearchCtx sctx;
+  struct timespec stepStart;
+  // How long the last step held the lock, in microseconds
+  long long heldUs;
+  // Time spent in the cycle's periodic calls, in nanoseconds
+  long long runNs;
+  size_t numDocsToClean;
+
+  // Sorted ids of the documents deleted before the cycle started
+  arrayof(t_docId) deletedIds;
+  bool repairAll;
+  // Whether some repairs were given up, in which case the next cycle repairs everything
+  bool missedRepairs;
+
+  // Blocks left to visit before the current step yields the lock
+  size_t budget;
+  // Keys of the terms emptied by the current step, removed once the step is done scanning
+  arrayof(RedisModuleString *) emptyTerms;
+  // Values emptied by the current step, removed once the step is done scanning. Either tag values
+  // (owned copies), or names of missing-field indexes (owned by their dictionary)
+  arrayof(void *) emptyValues;
+  arrayof(tm_len_t) emptyLens;
+
+  TGCPhase phase;
+  // Cursor of the keys dictionary scan, and then of the missing-field dictionary scan, which stay
+  // valid while the lock is released between steps
+  unsigned long cursor;
+  // Position of the field being repaired, and whether its numeric ranges are done
+  int fieldIdx;
+  bool numericDone;
+  // Progress over the field's numeric ranges. The tree iterator is kept across steps as long as the
+  // tree's structure does not change
+  NumericRangeTreeIterator *iter;
+  NumericRangeTree *rt;
+  uint32_t revisionId;
+  struct HLL card;
+  // The last tag value visited in the field, from which the next step resumes. NULL until the
+  // field's first step
+  char *tagCursor;
+  tm_len_t tagCursorLen;
+  // Whether the current step spent its budget before it got to the end of the field's values
+  bool tagMore;
+} TGCCycle;
+
+typedef struct {
+  size_t docsCollected;
+  size_t entriesCollected;
+  size_t bytesCollected;
+  size_t bytesAdded;
+} TGCRepairInfo;
+
+static void TGC_updateStats(TGCCycle *c, const TGCRepairInfo *info) {
+  IndexSpec *spec = c->sctx.spec;
+  spec->stats.numRecords -= info->entriesCollected;
+  spec->stats.invertedSize += info->bytesAdded;
+  spec->stats.invertedSize -= info->bytesCollected;
+  c->gc->stats.totalCollected += info->bytesCollected;
+  c->gc->stats.totalCollected -= info->bytesAdded;
+}
+
+/* Start a step: take the spec write lock. Returns false if the index was dropped */
+static bool TGC_lockSpec(TGCCycle *c) {
+  c->spec_ref = IndexSpecRef_Promote(c->gc->index);
+  IndexSpec *spec = StrongRef_Get(c->spec_ref);
+  if (!spec) {
+    return false;
+  }
+  c->sctx = SEARCH_CTX_STATIC(c->gc->ctx, spec);
+  RedisSearchCtx_LockSpecWrite(&c->sctx);
+  clock_gettime(CLOCK_MONOTONIC, &c->stepStart);
+  c->budget = RSGlobalConfig.gcConfigParams.gcScanSize;
+  return true;
+}
+
+/* End a step, and record how long it held the lock. The next step is scheduled no sooner, so the
+ * writers get at least half of the time */
+static void TGC_unlockSpec(TGCCycle *c) {
+  RedisSearchCtx_UnlockSpec(&c->sctx);
+  IndexSpecRef_Release(c->spec_ref);
+
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  c->heldUs = (now.tv_sec - c->stepStart.tv_sec) * 1000000LL +
+              (now.tv_nsec - c->stepStart.tv_nsec) / 1000;
+}
+
+static void TGC_consumeBudget(TGCCycle *c, size_t n) {
+  c->budget = c->budget > n ? c->budget - n : 0;
+}
+
+/* Whether a document deleted before the cycle started may have entries in [first, last] */
+static bool TGC_hasDeletedInRange(const TGCCycle *c, t_docId first, t_docId last) {
+  return c->repairAll || GC_HasDeletedInRange(c->deletedIds, first, last);
+}
+
+/**
+ * Repair the blocks of `idx` that may hold deleted documents, in place. Blocks left empty are
+ * freed, and readers notice the change through the index's gcMarker.
+ * As with the fork GC, a RepairCallback must see every remaining entry, so it makes the whole index
+ * be decoded once it holds any deleted document.
+ * Returns true if anything was collected, and adds the collected amounts to `info`.
+ */
+static bool TGC_repairInvidx(TGCCycle *c, InvertedIndex *idx, IndexRepairParams *params,
+                             TGCRepairInfo *info) {
+  TGC_consumeBudget(c, 1);
+  if (!idx->size ||
+      !TGC_hasDeletedInRange(c, idx->blocks[0].firstId, idx->blocks[idx->size - 1].lastId)) {
+    return false;
+  }
+  IndexRepairParams params_s = {0};
+  if (!params) {
+    params = &params_s;
+  }
+
+  size_t ndocs = 0, nremoved = 0, nkept = 0;
+  for (size_t i = 0; i < idx->size; ++i) {
+    IndexBlock *blk = idx->blocks + i;
+    // Blocks with a wide variation are not repaired, see FGC_childRepairInvidx
+    if (blk->lastId - blk->firstId > UINT32_MAX ||
+        (!params->RepairCallback && !TGC_hasDeletedInRange(c, blk->firstId, blk->lastId))) {
+      idx->blocks[nkept++] = *blk;
+      continue;
+    }
+    TGC_consumeBudget(c, 1);
+
+    params->bytesBeforFix = 0;
+    params->bytesAfterFix = 0;
+    params->entriesCollected = 0;
+    size_t nrepaired = IndexBlock_Repair(blk, &c->sctx.spec->docs, idx->flags, params);
+    if (nrepaired) {
+      ndocs += nrepaired;
+      info->entriesCollected += params->entriesCollected;
+      if (params->bytesBeforFix > params->bytesAfterFix) {
+        info->bytesCollected += params->bytesBeforFix - params->bytesAfterFix;
+      }
+      if (blk->numEntries == 0) {
+        info->bytesCollected += sizeof(IndexBlock);
+        indexBlock_Free(blk);
+        ++nremoved;
+        continue;
+      }
+    }
+    idx->blocks[nkept++] = *blk;
+  }
+
+  if (!ndocs) {
+    return false;
+  }
+
+  if (nremoved) {
+    TotalIIBlocks -= nremoved;
+    idx->size = nkept;
+    if (nkept) {
+      idx->blocks = rm_realloc(idx->blocks, nkept * sizeof(*idx->blocks));
+    } else {
+      InvertedIndex_AddBlock(idx, 0, &info->bytesAdded);
+    }
+  }
+  info->docsCollected += ndocs;
+  idx->numDocs -= ndocs;
+  idx->gcMarker++;
+  idx->lastId = idx->blocks[idx->size - 1].lastId;
+  return true;
+}
+
+/* dictScan callback over the keys dictionary. Only the term indexes are repaired here; tags and
+ * numeric fields are handled per field */
+static void TGC_scanTerm(void *privdata, const dictEntry *de) {
+  TGCCycle *c = privdata;
+  KeysDictValue *kdv = dictGetVal(de);
+  if (kdv->dtor != InvertedIndex_Free) {
+    return;
+  }
+  InvertedIndex *idx = kdv->p;
+  TGCRepairInfo info = {0};
+  if (!TGC_repairInvidx(c, idx, NULL, &info)) {
+    return;
+  }
+  TGC_updateStats(c, &info);
+  if (idx->numDocs == 0) {
+    array_ensure_append_1(c->emptyTerms, dictGetKey(de));
+  }
+}
+
+/* Remove the terms emptied by the current step, as the fork GC does when applying an empty index */
+static void TGC_removeEmptyTerms(TGCCycle *c) {
+  IndexSpec *spec = c->sctx.spec;
+  size_t nameLen;
+  HiddenString_GetUnsafe(spec->specName, &nameLen);
+  // Term keys are formatted as TERM_KEY_FORMAT
+  const size_t prefixLen = strlen(TERM_KEY_PREFIX) + nameLen + 1;
+
+  for (size_t i = 0; i < array_len(c->emptyTerms); ++i) {
+    RedisModuleString *termKey = c->emptyTerms[i];
+    size_t keyLen;
+    const char *key = RedisModule_StringPtrLen(termKey, &keyLen);
+    const char *term = key + prefixLen;
+    const size_t len = keyLen - prefixLen;
+
+    if (!Trie_Delete(spec->terms, term, len)) {
+      const char* name = IndexSpec_FormatName(spec, RSGlobalConfig.hideUserDataFromLog);
+      RedisModule_Log(c->sctx.redisCtx, "warning", "RedisSearch thread GC: deleting a term '%.*s' from"
+                      " trie in index '%s' failed", (int)len,
+                      RSGlobalConfig.hideUserDataFromLog ? Obfuscate_Text(term) : term, name);
+    }
+    spec->stats.numTerms--;
+    spec->stats.termsSize -= len;
+    if (spec->suffix) {
+      deleteSuffixTrie(spec->suffix, term, len);
+    }
+
+    // The key is freed with the entry, so it is removed last
+    KeysDictValue *kdv = dictFetchValue(spec->keysDict, termKey);
+    TGCRepairInfo info = {.bytesCollected = InvertedIndex_MemUsage(kdv->p)};
+    if (dictDelete(spec->keysDict, termKey) == DICT_OK) {
+      TGC_updateStats(c, &info);
+    }
+  }
+  array_clear(c->emptyTerms);
+}
+
+/* Scan the term indexes until the budget is spent */
+static void TGC_stepTerms(TGCCycle *c) {
+  if (c->sctx.spec->keysDict) {
+    do {
+      c->cursor = dictScan(c->sctx.spec->keysDict, c->cursor, TGC_scanTerm, NULL, c);
+    } while (c->cursor && c->budget);
+    TGC_removeEmptyTerms(c);
+  } else {
+    c->cursor = 0;
+  }
+  if (!c->cursor) {
+    c->phase = TGC_PHASE_FIELDS;
+  }
+}
+
+static void countRemain(const RSIndexResult *r, const IndexBlock *blk, void *arg) {
+  hll_add(arg, &r->data.num.value, sizeof(r->data.num.value));
+}
+
+static void TGC_endNumericField(TGCCycle *c) {
+  if (c->iter) {
+    NumericRangeTreeIterator_Free(c->iter);
+  }
+  c->iter = NULL;
+  c->rt = NULL;
+}
+
+/* Repair the numeric ranges of the current field until the budget is spent. If the tree's structure
+ * changes between steps, the rest of the field is left to the next cycle. Returns true once the
+ * field is done */
+static bool TGC_stepNumericField(TGCCycle *c) {
+  IndexSpec *spec = c->sctx.spec;
+  RedisModuleString *keyName = IndexSpec_GetFormattedKey(spec, spec->fields + c->fieldIdx,
+                                                         INDEXFLD_T_NUMERIC);
+  NumericRangeTree *cur = openNumericKeysDict(spec, keyName, DONT_CREATE_INDEX);
+  if (!c->iter) {
+    if (!cur) {
+      return true;
+    }
+    c->rt = cur;
+    c->iter = NumericRangeTreeIterator_New(cur);
+  } else if (cur != c->rt || c->rt->revisionId != c->revisionId) {
+    c->gc->stats.gcNumericNodesMissed++;
+    c->missedRepairs = true;
+    TGC_endNumericField(c);
+    return true;
+  }
+
+  NumericRangeTree *rt = c->rt;
+  IndexRepairParams params = {.RepairCallback = countRemain, .arg = &c->card};
+  NumericRangeNode *node;
+  while (c->budget && (node = NumericRangeTreeIterator_Next(c->iter))) {
+    if (!node->range) {
+      continue;
+    }
+    NumericRange *range = node->range;
+    TGCRepairInfo info = {0};
+    hll_clear(&c->card);
+    if (!TGC_repairInvidx(c, range->entries, &params, &info)) {
+      continue;
+    }
+    hll_set_registers(&range->hll, c->card.registers, NR_REG_SIZE);
+    // The value ordered copy is stale now, and collected along with the repaired blocks
+    info.bytesCollected += NumericRange_DropByValue(range);
+    range->entries->numEntries -= info.entriesCollected;
+    range->invertedIndexSize += info.bytesAdded;
+    range->invertedIndexSize -= info.bytesCollected;
+    rt->numEntries -= info.entriesCollected;
+    rt->invertedIndexesSize += info.bytesAdded;
+    rt->invertedIndexesSize -= info.bytesCollected;
+    if (range->entries->numDocs == 0) {
+      rt->emptyLeaves++;
+    }
+    TGC_updateStats(c, &info);
+  }
+  if (!c->budget) {
+    c->revisionId = rt->revisionId;
+    return false;
+  }
+
+  // The iterator is exhausted
+  if (RSGlobalConfig.gcConfigParams.forkGc.forkGCCleanNumericEmptyNodes &&
+      rt->emptyLeaves >= rt->numLeaves / 2) {
+    NRN_AddRv rv = NumericRangeTree_TrimEmptyLeaves(rt);
+    // rv.sz is the number of bytes added. Since we are cleaning empty leaves, it is negative
+    TGCRepairInfo info = {.bytesCollected = -rv.sz};
+    TGC_updateStats(c, &info);
+  }
+  TGC_endNumericField(c);
+  return true;
+}
+
+static void TGC_endTagField(TGCCycle *c) {
+  rm_free(c->tagCursor);
+  c->tagCursor = NULL;
+  c->tagCursorLen = 0;
+}
+
+/* TrieMap_IterateRange callback over the values of a tag field, in lexicographic order. The range
+ * walk cannot be stopped, so once the budget is spent the rest of the values are only noted */
+static void TGC_scanTagValue(const char *value, size_t len, void *p, void *privdata) {
+  TGCCycle *c = privdata;
+  if (!c->budget) {
+    c->tagMore = true;
+    return;
+  }
+  InvertedIndex *idx = p;
+  rm_free(c->tagCursor);
+  c->tagCursor = rm_strndup(value, len);
+  c->tagCursorLen = len;
+
+  TGCRepairInfo info = {0};
+  if (!TGC_repairInvidx(c, idx, NULL, &info)) {
+    return;
+  }
+  if (idx->numDocs == 0) {
+    // Removing values would invalidate the walk, so they are removed once it is done
+    info.bytesCollected += InvertedIndex_MemUsage(idx);
+    char *copy = rm_strndup(value, len);
+    array_ensure_append_1(c->emptyValues, copy);
+    array_ensure_append_1(c->emptyLens, len);
+  }
+  TGC_updateStats(c, &info);
+}
+
+/* Repair the values of the current tag field until the budget is spent. The values trie cannot be
+ * iterated across steps, so each step walks it from the last value visited. Returns true once the
+ * field is done */
+static bool TGC_stepTagField(TGCCycle *c) {
+  IndexSpec *spec = c->sctx.spec;
+  RedisModuleString *keyName = IndexSpec_GetFormattedKey(spec, spec->fields + c->fieldIdx,
+                                                         INDEXFLD_T_TAG);
+  TagIndex *tagIdx = TagIndex_Open(spec, keyName, DONT_CREATE_INDEX);
+  if (!tagIdx) {
+    TGC_endTagField(c);
+    return true;
+  }
+
+  c->tagMore = false;
+  if (c->tagCursor) {
+    TrieMap_IterateRange(tagIdx->values, c->tagCursor, c->tagCursorLen, false, NULL, -1, false,
+                         TGC_scanTagValue, c);
+  } else {
+    TrieMap_IterateRange(tagIdx->values, NULL, -1, false, NULL, -1, false, TGC_scanTagValue, c);
+  }
+
+  for (size_t i = 0; i < array_len(c->emptyValues); ++i) {
+    TrieMap_Delete(tagIdx->values, c->emptyValues[i], c->emptyLens[i], InvertedIndex_Free);
+    if (tagIdx->suffix) {
+      deleteSuffixTrieMap(tagIdx->suffix, c->emptyValues[i], c->emptyLens[i]);
+    }
+    rm_free(c->emptyValues[i]);
+  }
+  array_clear(c->emptyValues);
+  array_clear(c->emptyLens);
+
+  if (c->tagMore) {
+    return false;
+  }
+  TGC_endTagField(c);
+  return true;
+}
+
+/* Repair the numeric and tag fields until the budget is spent. Fields are looked up by position on
+ * every step, as altering the schema may move them */
+static void TGC_stepFields(TGCCycle *c) {
+  IndexSpec *spec = c->sctx.spec;
+  while (c->budget) {
+    if (c->fieldIdx >= spec->numFields) {
+      c->phase = TGC_PHASE_MISSING_FIELDS;
+      return;
+    }
+    const FieldType types = spec->fields[c->fieldIdx].types;
+    if (!c->numericDone && (types & (INDEXFLD_T_NUMERIC | INDEXFLD_T_GEO))) {
+      if (!TGC_stepNumericField(c)) {
+        return;
+      }
+    }
+    c->numericDone = true;
+    if (types & INDEXFLD_T_TAG) {
+      if (!TGC_stepTagField(c)) {
+        return;
+      }
+    }
+    c->fieldIdx++;
+    c->numericDone = false;
+  }
+}
+
+/* dictScan callback over the missing-field indexes */
+static void TGC_scanMissingField(void *privdata, const dictEntry *de) {
+  TGCCycle *c = privdata;
+  InvertedIndex *idx = dictGetVal(de);
+  TGCRepairInfo info = {0};
+  if (!idx || !TGC_repairInvidx(c, idx, NULL, &info)) {
+    return;
+  }
+  if (idx->numDocs == 0) {
+    info.bytesCollected += InvertedIndex_MemUsage(idx);
+    array_ensure_append_1(c->emptyValues, dictGetKey(de));
+  }
+  TGC_updateStats(c, &info);
+}
+
+/* Scan the missing-field indexes until the budget is spent */
+static void TGC_stepMissingFields(TGCCycle *c) {
+  IndexSpec *spec = c->sctx.spec;
+  if (spec->missingFieldDict) {
+    do {
+      c->cursor = dictScan(spec->missingFieldDict, c->cursor, TGC_scanMissingField, NULL, c);
+    } while (c->cursor && c->budget);
+    // The names are freed with their entries
+    for (size_t i = 0; i < array_len(c->emptyValues); ++i) {
+      dictDelete(spec->missingFieldDict, c->emptyValues[i]);
+    }
+    array_clear(c->emptyValues);
+  } else {
+    c->cursor = 0;
+  }
+  if (!c->cursor) {
+    c->phase = TGC_PHASE_EXISTING_DOCS;
+  }
+}
+
+/* Repair the existing-documents index, which is a single inverted index */
+static void TGC_stepExistingDocs(TGCCycle *c) {
+  IndexSpec *spec = c->sctx.spec;
+  if (spec->existingDocs) {
+    TGCRepairInfo info = {0};
+    if (TGC_repairInvidx(c, spec->existingDocs, NULL, &info)) {
+      TGC_updateStats(c, &info);
+    }
+  }
+  c->phase = TGC_PHASE_DONE;
+}
+
+/* Take a step of the cycle: repair under the spec write lock until the budget is spent or the
+ * cycle is done. Returns false if the index was dropped */
+static bool TGC_step(TGCCycle *c) {
+  if (!TGC_lockSpec(c)) {
+    return false;
+  }
+  while (c->budget && c->phase != TGC_PHASE_DONE) {
+    switch (c->phase) {
+      case TGC_PHASE_TERMS:
+        TGC_stepTerms(c);
+        break;
+      case TGC_PHASE_FIELDS:
+        TGC_stepFields(c);
+        break;
+      case TGC_PHASE_MISSING_FIELDS:
+        TGC_stepMissingFields(c);
+        break;
+      case TGC_PHASE_EXISTING_DOCS:
+        TGC_stepExistingDocs(c);
+        break;
+      case TGC_PHASE_DONE:
+        break;
+    }
+  }
+  TGC_unlockSpec(c);
+  return true;
+}
+
+static void TGC_freeCycle(TGCCycle *c) {
+  TGC_endNumericField(c);
+  TGC_endTagField(c);
+  hll_destroy(&c->card);
+  array_free(c->deletedIds);
+  array_free(c->emptyTerms);
+  array_free(c->emptyValues);
+  array_free(c->emptyLens);
+  rm_free(c);
+}
+
+/* Start a cycle, taking over the deletions tracked since the last one */
+static TGCCycle *TGC_startCycle(ThreadGC *gc) {
+  TGCCycle *c = rm_calloc(1, sizeof(*c));
+  c->gc = gc;
+  c->phase = TGC_PHASE_TERMS;
+  hll_init(&c->card, NR_BIT_PRECISION);
+
+  // Deletions are counted under the GIL
+  RedisModule_ThreadSafeContextLock(gc->ctx);
+  c->deletedIds = gc->deletedIds;
+  c->repairAll = gc->repairAll;
+  c->numDocsToClean = gc->deletedDocsFromLastRun;
+  gc->deletedDocsFromLastRun = 0;
+  gc->deletedIds = NULL;
+  gc->repairAll = false;
+  RedisModule_ThreadSafeContextUnlock(gc->ctx);
+
+  if (!c->repairAll) {
+    GC_SortDeletedIds(c->deletedIds);
+  }
+  return c;
+}
+
+/* Each call takes a single step of the current cycle, starting one if the threshold was reached.
+ * Until the cycle is done, the next call is scheduled once the writers had as long as the step
+ * held the lock (see getIntervalCb) */
+static int periodicCb(void *privdata) {
+  ThreadGC *gc = privdata;
+  RedisModuleCtx *ctx = gc->ctx;
+
+  if (!gc->cycle) {
+    StrongRef early_check = IndexSpecRef_Promote(gc->index);
+    if (!StrongRef_Get(early_check)) {
+      // Index was deleted
+      return 0;
+    }
+    IndexSpecRef_Release(early_check);
+
+    if (gc->deletedDocsFromLastRun < RSGlobalConfig.gcConfigParams.forkGc.forkGcCleanThreshold) {
+      return 1;
+    }
+    gc->cycle = TGC_startCycle(gc);
+  }
+
+  TGCCycle *c = gc->cycle;
+  TimeSample ts;
+  TimeSampler_Start(&ts);
+  int gcrv = TGC_step(c);
+  TimeSampler_End(&ts);
+  c->runNs += TimeSampler_DurationNS(&ts);
+  if (gcrv && c->phase != TGC_PHASE_DONE) {
+    return 1;
+  }
+
+  gc->cycle = NULL;
+  if (c->missedRepairs) {
+    RedisModule_ThreadSafeContextLock(ctx);
+    gc->repairAll = true;
+    RedisModule_ThreadSafeContextUnlock(ctx);
+  }
+
+  if (gcrv) {
+    TimeSampler_Start(&ts);
+    gcrv = VecSim_CallTieredIndexesGC(gc->index);
+    TimeSampler_End(&ts);
+    c->runNs += TimeSampler_DurationNS(&ts);
+  }
+
+  IndexsGlobalStats_UpdateLogicallyDeleted(-c->numDocsToClean);
+  long long msRun = c->runNs / 1000000;
+
+  gc->stats.numCycles++;
+  gc->stats.totalMSRun += msRun;
+  gc->stats.lastRunTimeMs = msRun;
+
+  TGC_freeCycle(c);
+  return gcrv;
+}
+
+static void onTerminateCb(void *privdata) {
+  ThreadGC *gc = privdata;
+  IndexsGlobalStats_UpdateLogicallyDeleted(-gc->deletedDocsFromLastRun);
+  if (gc->cycle) {
+    IndexsGlobalStats_UpdateLogicallyDeleted(-gc->cycle->numDocsToClean);
+    TGC_freeCycle(gc->cycle);
+  }
+  array_free(gc->deletedIds);
+  WeakRef_Release(gc->index);
+  RedisModule_FreeThreadSafeContext(gc->ctx);
+  rm_free(gc);
+}
+
+static void statsCb(RedisModule_Reply *reply, void *gcCtx) {
+  ThreadGC *gc = gcCtx;
+  if (!gc) return;
+  GCStats_Render(&gc->stats, reply);
+}
+
+#ifdef FTINFO_FOR_INFO_MODULES
+static void statsForInfoCb(RedisModuleInfoCtx *ctx, void *gcCtx) {
+  ThreadGC *gc = gcCtx;
+  GCStats_RenderForInfo(&gc->stats, ctx);
+}
+#endif
+
+static const GCStats *getStatsCb(void *ctx) {
+  ThreadGC *gc = ctx;
+  return &gc->stats;
+}
+
+static void deleteCb(void *ctx, t_docId docId) {
+  ThreadGC *gc = ctx;
+  ++gc->deletedDocsFromLastRun;
+  GC_TrackDeletedId(&gc->deletedIds, &gc->repairAll, docId);
+  IndexsGlobalStats_UpdateLogicallyDeleted(1);
+}
+
+static struct timespec getIntervalCb(void *ctx) {
+  ThreadGC *gc = ctx;
+  if (!gc->cycle) {
+    return gc->retryInterval;
+  }
+  // The next step of the cycle in progress. Timers have a millisecond resolution
+  const long long ms = gc->cycle->heldUs / 1000 + 1;
+  return (struct timespec){.tv_sec = ms / 1000, .tv_nsec = (ms % 1000) * 1000000};
+}
+
+static bool inCycleCb(void *ctx) {
+  ThreadGC *gc = ctx;
+  return gc->cycle != NULL;
+}
+
+ThreadGC *TGC_New(StrongRef spec_ref, GCCallbacks *callbacks) {
+  ThreadGC *tgc = rm_calloc(1, sizeof(*tgc));
+  *tgc = (ThreadGC){
+      .index = StrongRef_Demote(spec_ref),
+      .deletedDocsFromLastRun = 0,
+      // Nothing is known about the documents removed before the first cycle
+      .repairAll = true,
+  };
+  tgc->retryInterval.tv_sec = RSGlobalConfig.gcConfigParams.forkGc.forkGcRunIntervalSec;
+  tgc->retryInterval.tv_nsec = 0;
+  tgc->ctx = RedisModule_GetDetachedThreadSafeContext(RSDummyContext);
+
+  callbacks->onTerm = onTerminateCb;
+  callbacks->periodicCallback = periodicCb;
+  callbacks->renderStats = statsCb;
+  #ifdef FTINFO_FOR_INFO_MODULES
+  callbacks->renderStatsForInfo = statsForInfoCb;
+  #endif
+  callbacks->getInterval = getIntervalCb;
+  callbacks->onDelete = deleteCb;
+  callbacks->getStats = getStatsCb;
+  callbacks->inCycle = inCycleCb;
+
+  return tgc;
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+
+#ifndef SRC_THREAD_GC_H_
+#define SRC_THREAD_GC_H_
+
+#include "redismodule.h"
+#include "gc.h"
+#include "redisearch.h"
+#include "util/arr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* In-process garbage collector (GC_POLICY THREAD). Instead of forking, the GC thread repairs the
+ * inverted indexes itself, in short steps taken under the spec write lock. Readers revalidate on
+ * the index's gcMarker exactly as they do after the fork GC applies its changes. Each step is a
+ * separate GC task, scheduled once the writers had as long as the previous step held the lock, so
+ * they get at least half of the time and the GC thread is free for other indexes in between */
+typedef struct ThreadGC {
+  // owner of the gc
+  WeakRef index;
+
+  RedisModuleCtx *ctx;
+
+  // statistics for reporting
+  GCStats stats;
+
+  struct timespec retryInterval;
+  volatile size_t deletedDocsFromLastRun;
+  // ids of the documents deleted since the last cycle, see ForkGC
+  arrayof(t_docId) deletedIds;
+  bool repairAll;
+  // The cycle in progress, if any
+  struct TGCCycle *cycle;
+} ThreadGC;
+
+ThreadGC *TGC_New(StrongRef spec_ref, GCCallbacks *callbacks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SRC_THREAD_GC_H_ */
@@ -115,7 +115,7 @@ uint32_t simpleTokenizer_Next(RSTokenizer *base, Token *t) {
     }
 
     // skip stopwords
-    if (!ctx->empty_input && StopWordList_Contains(ctx->stopwords, normalized, normLen)) {
+    if (!ctx->empty_input && StopWordList_ContainsNormalized(ctx->stopwords, normalized, normLen)) {
       if (allocated) {
         rm_free(normalized);
       }
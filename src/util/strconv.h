@@ -125,6 +125,23 @@ static char* unicode_tolower(char *encoded, size_t *inout_len) {
 
   size_t in_len = *inout_len;
 
+  // Fast path for ASCII, which most tokens are: lowercase in place without decoding the string.
+  // Stop at the first byte that needs the full conversion; lowercasing is idempotent, so the
+  // already converted prefix is left as is by the code below
+  size_t ascii_len = 0;
+  for (; ascii_len < in_len; ++ascii_len) {
+    unsigned char c = (unsigned char)encoded[ascii_len];
+    if (c >= 0x80 || c == '\0') {
+      break;
+    }
+    if (c >= 'A' && c <= 'Z') {
+      encoded[ascii_len] = c + ('a' - 'A');
+    }
+  }
+  if (ascii_len == in_len) {
+    return NULL;
+  }
+
   uint32_t u_stack_buffer[SSO_MAX_LENGTH];
   uint32_t *u_buffer = u_stack_buffer;
   char *longer_dst = NULL;
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+#include <sys/param.h>
+#include "tdigest.h"
+#include "rmalloc.h"
+
+// The compression parameter (delta). A compressed digest holds about half as many centroids
+#define TD_COMPRESSION 200
+
+typedef struct {
+  double mean;
+  double weight;
+} TDCentroid;
+
+struct TDigest {
+  TDCentroid *centroids;
+  size_t len;
+  size_t cap;
+  bool sorted;
+  bool reverse;  // The direction of the next compression
+  double count;
+  double min, max;
+};
+
+/** Serialized header, followed by the centroids */
+typedef struct __attribute__((packed)) {
+  double min;
+  double max;
+} TDSerializedHeader;
+
+static int centroidCmp(const void *a, const void *b) {
+  double ma = ((const TDCentroid *)a)->mean, mb = ((const TDCentroid *)b)->mean;
+  return ma < mb ? -1 : ma > mb ? 1 : 0;
+}
+
+// The quantile up to which a centroid starting at quantile `q` may grow, by the k1 scale function
+// k(q) = delta / (2 * pi) * asin(2q - 1). A centroid spans at most 1 in k
+static double TD_QuantileLimit(double q) {
+  double k = TD_COMPRESSION / (2 * M_PI) * asin(2 * q - 1) + 1;
+  return (sin(MIN(k * 2 * M_PI / TD_COMPRESSION, M_PI / 2)) + 1) / 2;
+}
+
+static void TD_Sort(TDigest *td) {
+  if (!td->sorted) {
+    qsort(td->centroids, td->len, sizeof(*td->centroids), centroidCmp);
+    td->sorted = true;
+  }
+}
+
+// Merge adjacent centroids, as long as they fit in the size the scale function allows. The passes
+// alternate their direction, so the centroids are not biased towards either end
+static void TD_Compress(TDigest *td) {
+  if (td->len < 2) {
+    return;
+  }
+  TD_Sort(td);
+  bool reverse = td->reverse;
+  td->reverse = !reverse;
+  size_t out = 0;
+  double before = 0;
+  double limit = td->count * TD_QuantileLimit(0);
+  for (size_t i = 1; i < td->len; i++) {
+    TDCentroid *cur = td->centroids + (reverse ? td->len - 1 - out : out);
+    const TDCentroid *next = td->centroids + (reverse ? td->len - 1 - i : i);
+    double weight = cur->weight + next->weight;
+    if (before + weight <= limit) {
+      cur->mean += (next->mean - cur->mean) * next->weight / weight;
+      cur->weight = weight;
+    } else {
+      before += cur->weight;
+      limit = td->count * TD_QuantileLimit(before / td->count);
+      out++;
+      td->centroids[reverse ? td->len - 1 - out : out] = *next;
+    }
+  }
+  if (reverse) {
+    memmove(td->centroids, td->centroids + td->len - 1 - out, (out + 1) * sizeof(*td->centroids));
+  }
+  td->len = out + 1;
+}
+
+TDigest *NewTDigest(size_t capacity) {
+  TDigest *td = rm_calloc(1, sizeof(*td));
+  // A compressed digest must leave room for new values
+  td->cap = MAX(capacity, 2 * TD_COMPRESSION);
+  td->centroids = rm_malloc(td->cap * sizeof(*td->centroids));
+  td->sorted = true;
+  td->min = INFINITY;
+  td->max = -INFINITY;
+  return td;
+}
+
+void TD_Free(TDigest *td) {
+  rm_free(td->centroids);
+  rm_free(td);
+}
+
+void TD_Add(TDigest *td, double value, double weight) {
+  if (isnan(value) || !(weight > 0)) {
+    return;
+  }
+  if (td->len == td->cap) {
+    TD_Compress(td);
+  }
+  td->sorted = td->sorted && (!td->len || td->centroids[td->len - 1].mean <= value);
+  td->centroids[td->len++] = (TDCentroid){.mean = value, .weight = weight};
+  td->count += weight;
+  td->min = MIN(td->min, value);
+  td->max = MAX(td->max, value);
+}
+
+static inline double interpolate(double x0, double v0, double x1, double v1, double x) {
+  return x1 > x0 ? v0 + (v1 - v0) * (x - x0) / (x1 - x0) : v1;
+}
+
+double TD_Query(TDigest *td, double q) {
+  if (!td->len) {
+    return NAN;
+  }
+  TD_Sort(td);
+  // The middle of the requested rank. The mass of a centroid is centered at the middle of its
+  // ranks, so a single value centroid is returned as is
+  double x = MAX(ceil(q * td->count), 1) - 0.5;
+  // The first and last ranks are known exactly
+  if (x < 1) {
+    return td->min;
+  } else if (x > td->count - 1) {
+    return td->max;
+  }
+  double prevCenter = 0, prevMean = td->min;
+  double before = 0;
+  for (size_t i = 0; i < td->len; i++) {
+    const TDCentroid *c = td->centroids + i;
+    double center = before + c->weight / 2;
+    if (x == center) {
+      return c->mean;
+    } else if (x < center) {
+      return interpolate(prevCenter, prevMean, center, c->mean, x);
+    }
+    prevCenter = center;
+    prevMean = c->mean;
+    before += c->weight;
+  }
+  return interpolate(prevCenter, prevMean, td->count, td->max, x);
+}
+
+double TD_GetCount(const TDigest *td) {
+  return td->count;
+}
+
+char *TD_Serialize(TDigest *td, size_t *len) {
+  TDSerializedHeader hdr = {.min = td->min, .max = td->max};
+  *len = sizeof(hdr) + td->len * sizeof(*td->centroids);
+  char *buf = rm_malloc(*len);
+  memcpy(buf, &hdr, sizeof(hdr));
+  memcpy(buf + sizeof(hdr), td->centroids, td->len * sizeof(*td->centroids));
+  return buf;
+}
+
+int TD_MergeSerialized(TDigest *td, const char *buf, size_t len) {
+  if (len < sizeof(TDSerializedHeader) || (len - sizeof(TDSerializedHeader)) % sizeof(TDCentroid)) {
+    return 0;
+  }
+  TDSerializedHeader hdr;
+  memcpy(&hdr, buf, sizeof(hdr));
+  size_t n = (len - sizeof(hdr)) / sizeof(TDCentroid);
+  for (size_t i = 0; i < n; i++) {
+    TDCentroid c;
+    memcpy(&c, buf + sizeof(hdr) + i * sizeof(c), sizeof(c));
+    TD_Add(td, c.mean, c.weight);
+  }
+  // The extremes of the other digest may have been merged into its centroids
+  if (n) {
+    td->min = MIN(td->min, hdr.min);
+    td->max = MAX(td->max, hdr.max);
+  }
+  return 1;
+}
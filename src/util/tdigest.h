@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#ifndef TDIGEST_H
+#define TDIGEST_H
+
+#include <stdlib.h>
+
+/* A mergeable quantile sketch (merging t-digest, Dunning & Ertl). Values are kept as centroids of
+ * (mean, weight), which are merged once `capacity` of them are held, keeping the centroids small at
+ * the tails. Until then, every value is a centroid of its own and queries are exact.
+ * A digest is serialized to a binary string, which another digest merges, so the shards of a
+ * cluster can each send a bounded state that the coordinator combines */
+typedef struct TDigest TDigest;
+
+TDigest *NewTDigest(size_t capacity);
+void TD_Free(TDigest *td);
+
+/* Add a value, or a centroid of `weight` values */
+void TD_Add(TDigest *td, double value, double weight);
+
+/* The value at the rank ceil(q * count), interpolated between centroids. NAN if the digest is
+ * empty */
+double TD_Query(TDigest *td, double q);
+
+double TD_GetCount(const TDigest *td);
+
+/* Serialize the digest into a new buffer allocated with rm_malloc, of at most `capacity` centroids */
+char *TD_Serialize(TDigest *td, size_t *len);
+
+/* Merge a digest serialized by TD_Serialize. Returns 0 if the buffer is not a serialized digest */
+int TD_MergeSerialized(TDigest *td, const char *buf, size_t len);
+
+#endif
@@ -30,6 +30,12 @@ static size_t RSValue_NumToString(double dd, char *buf) {
 
 pthread_key_t mempoolKey_g;
 
+// How many released values each thread keeps for reuse. A chunk of results (e.g. a page of 1000
+// rows) releases all of its values at once, so the pool should hold the values of a few fields of
+// a whole chunk. Otherwise most of them go back to the allocator, only to be reallocated for the
+// next chunk
+#define VALUE_POOL_MAX_CAP (16 * 1024)
+
 static void *_valueAlloc() {
   return rm_malloc(sizeof(RSValue));
 }
@@ -42,7 +48,7 @@ static inline mempool_t *getPool() {
   mempool_t *tp = pthread_getspecific(mempoolKey_g);
   if (tp == NULL) {
     const mempool_options opts = {
-        .initialCap = 0, .maxCap = 1000, .alloc = _valueAlloc, .free = rm_free};
+        .initialCap = 0, .maxCap = VALUE_POOL_MAX_CAP, .alloc = _valueAlloc, .free = rm_free};
     tp = mempool_new(&opts);
     pthread_setspecific(mempoolKey_g, tp);
   }
@@ -693,21 +699,30 @@ int RSValue_SendReply(RedisModule_Reply *reply, const RSValue *v, SendReplyFlags
 
     case RSValue_Number: {
       if (!(flags & SENDREPLY_FLAG_EXPAND)) {
+        if (flags & SENDREPLY_FLAG_TYPED) {
+          const double d = v->numval;
+          if (fabs(d) < 0x1p63 && (long long)d == d && !(d == 0 && signbit(d))) {
+            // Integers are sent as such in both protocols, so they are neither formatted here nor
+            // parsed as floating point numbers by MRReply_ToValue() on the other end. -0 is not,
+            // so the other end keeps its sign
+            return RedisModule_Reply_LongLong(reply, (long long)d);
+          } else if (reply->resp3) {
+            return RedisModule_Reply_Double(reply, d);
+          } else if (d == 0) {
+            // RSValue_NumToString() formats -0 as 0
+            return RedisModule_Reply_Error(reply, "-0");
+          }
+        }
+
         char buf[128];
         size_t len = RSValue_NumToString(v->numval, buf);
-
         if (flags & SENDREPLY_FLAG_TYPED) {
-          if (reply->resp3) {
-            return RedisModule_Reply_Double(reply, v->numval);
-          } else {
-             // In RESP2, RM_ReplyWithDouble() does not tag the response as
-             // double, it's just a plain string. So we send it as simple string
-             // that is converted to double by MRReply_ToValue().
-            return RedisModule_Reply_Error(reply, buf);
-          }
-        } else {
-          return RedisModule_Reply_StringBuffer(reply, buf, len);
+          // In RESP2, RM_ReplyWithDouble() does not tag the response as
+          // double, it's just a plain string. So we send it as simple string
+          // that is converted to double by MRReply_ToValue().
+          return RedisModule_Reply_Error(reply, buf);
         }
+        return RedisModule_Reply_StringBuffer(reply, buf, len);
       } else {
         long long ll = v->numval;
         if (ll == v->numval) {
@@ -100,6 +100,9 @@ size_t NumericRangeGetMemory(const NumericRangeNode *Node) {
         IndexBlock *blk = idx->blocks + i;
         curr_node_memory += blk->buf.cap;
     }
+    if (Node->range->byValue) {
+        curr_node_memory += NumericRangeByValue_Size(Node->range->byValue->len);
+    }
 
     return curr_node_memory;
 
@@ -43,6 +43,7 @@ private:
         base->NumEstimated = MockOldIterator_NumEstimated;
         base->Free = MockOldIterator_Free;
         base->Read = MockOldIterator_Read;
+        base->ReadBatch = NULL;
         base->SkipTo = MockOldIterator_SkipTo;
         base->Rewind = MockOldIterator_Rewind;
     }
@@ -628,6 +628,46 @@ TEST_F(FGCTestTag, testRemoveMiddleBlock) {
   ASSERT_NE(ss.end(), ss.find(numToDocStr(lastLastBlockId)));
 }
 
+/**
+ * After the first cycle, the GC only repairs the blocks that may hold documents deleted since the
+ * previous cycle.
+ */
+TEST_F(FGCTestTag, testRepairTrackedDeletions) {
+  unsigned curId = 0;
+  RedisSearchCtx sctx = SEARCH_CTX_STATIC(ctx, get_spec(ism));
+  sctx.spec->monitorDocumentExpiration = false;
+  InvertedIndex *iv = getTagInvidx(&sctx, "f1", "hello");
+
+  while (iv->size < 3) {
+    RS::addDocument(ctx, ism, numToDocStr(++curId).c_str(), "f1", "hello");
+  }
+  const size_t midEntries = iv->blocks[1].numEntries;
+
+  // The first cycle repairs every block
+  ASSERT_TRUE(fgc->repairAll);
+  FGC_WaitBeforeFork(fgc);
+  FGC_ForkAndWaitBeforeApply(fgc);
+  FGC_Apply(fgc);
+  ASSERT_FALSE(fgc->repairAll);
+
+  FGC_WaitBeforeFork(fgc);
+  const t_docId deletedId = iv->blocks[1].firstId;
+  ASSERT_TRUE(RS::deleteDocument(ctx, ism, numToDocStr(deletedId).c_str()));
+  ASSERT_EQ(1, array_len(fgc->deletedIds));
+  ASSERT_EQ(deletedId, fgc->deletedIds[0]);
+  const char *firstBuf = iv->blocks[0].buf.data;
+
+  FGC_ForkAndWaitBeforeApply(fgc);
+  FGC_Apply(fgc);
+
+  ASSERT_EQ(0, array_len(fgc->deletedIds));
+  ASSERT_FALSE(fgc->repairAll);
+  ASSERT_EQ(3, iv->size);
+  ASSERT_EQ(firstBuf, iv->blocks[0].buf.data);
+  ASSERT_EQ(midEntries - 1, iv->blocks[1].numEntries);
+  ASSERT_EQ(curId - 1, RS::search(ism, "@f1:{hello}").size());
+}
+
 TEST_F(FGCTestTag, testDeleteDuringGCCleanup) {
   // Setup.
   unsigned curId = 0;
@@ -762,3 +802,46 @@ TEST_F(FGCTestNumeric, testNumericBlocksSinceFork) {
   cur_cardinality -= 2;
   EXPECT_EQ(cur_cardinality, NumericRange_GetCardinality(rt->root->range));
 }
+
+/**
+ * Blocks left underfilled after the deletions are merged, while full blocks and the last block
+ * are left as is.
+ */
+TEST_F(FGCTestNumeric, testMergeUnderfilledBlocks) {
+  const auto startValue = TotalIIBlocks;
+  constexpr size_t docs_per_block = INDEX_BLOCK_SIZE;
+  // Add 3 full blocks + 1 block with a single entry, all with the same value
+  size_t num_docs = 3 * docs_per_block + 1;
+  for (size_t i = 1; i <= num_docs; i++) {
+    this->addDocumentWrapper(numToDocStr(i).c_str(), numeric_field_name, "1");
+  }
+  NumericRangeTree *rt = getNumericTree(get_spec(ism), numeric_field_name);
+  InvertedIndex *iv = rt->root->range->entries;
+  ASSERT_EQ(4, iv->size);
+  ASSERT_EQ(4, TotalIIBlocks - startValue);
+
+  FGC_WaitBeforeFork(fgc);
+
+  // Delete most of the documents of the first two blocks
+  size_t valid_docs = num_docs;
+  for (size_t i = 1; i <= 2 * docs_per_block; i++) {
+    if (i % 10) {
+      ASSERT_TRUE(RS::deleteDocument(ctx, ism, numToDocStr(i).c_str()));
+      --valid_docs;
+    }
+  }
+
+  FGC_ForkAndWaitBeforeApply(fgc);
+  FGC_Apply(fgc);
+
+  // The remaining entries of the first two blocks fit in a single block
+  ASSERT_EQ(3, iv->size);
+  ASSERT_EQ(3, TotalIIBlocks - startValue);
+  ASSERT_EQ(2 * docs_per_block / 10, iv->blocks[0].numEntries);
+  ASSERT_EQ(10, iv->blocks[0].firstId);
+  ASSERT_EQ(2 * docs_per_block, iv->blocks[0].lastId);
+  ASSERT_EQ(docs_per_block, iv->blocks[1].numEntries);
+  ASSERT_EQ(1, iv->blocks[2].numEntries);
+  ASSERT_EQ(valid_docs, iv->numDocs);
+  ASSERT_EQ(valid_docs, RS::search(ism, "@n:[1 1]").size());
+}
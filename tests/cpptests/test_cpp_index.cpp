@@ -15,8 +15,10 @@ extern "C" {
 #include "src/index.h"
 #include "src/forward_index.h"
 #include "src/index_result.h"
+#include "src/inverted_index/group_varint.h"
 #include "src/query_parser/tokenizer.h"
 #include "src/spec.h"
+#include "src/redis_index.h"
 #include "src/tokenize.h"
 #include "varint.h"
 #include "src/hybrid_reader.h"
@@ -37,6 +39,8 @@ extern "C" {
 #include <time.h>
 #include <float.h>
 #include <vector>
+#include <set>
+#include <algorithm>
 #include <cstdint>
 #include <random>
 #include <chrono>
@@ -184,6 +188,18 @@ TEST_P(IndexFlagsTest, testRWFlags) {
                                     exp_ividx_memsize - exp_t_fieldMask_memsize;
   ASSERT_EQ(exp_idx_no_block_memsize, idx_no_block_memsize);
 
+  // Details of the memory occupied by IndexBlock in bytes (64-bit system):
+  // t_docId firstId            8
+  // t_docId lastId             8
+  // Buffer buf                24
+  // uint16_t numEntries        2
+  // uint8_t flags              1
+  // uint8_t maxFreq            1
+  // uint16_t capacity          2
+  // uint16_t minDocLen         2
+  // ----------------------------
+  // Total                     48
+  // Large blocks keep their skip checkpoints at the start of their buffer
   size_t block_memsize = sizeof(IndexBlock);
   size_t exp_block_memsize = 48;
   ASSERT_EQ(exp_block_memsize, block_memsize);
@@ -205,6 +221,7 @@ TEST_P(IndexFlagsTest, testRWFlags) {
     h.docId = i;
     h.fieldMask = 1;
     h.freq = (1 + i % 100) / (float)101;
+    h.docLen = 0;
 
     h.vw = NewVarintVectorWriter(8);
     for (int n = 0; n < i % 4; n++) {
@@ -794,6 +811,87 @@ TEST_F(IndexTest, testIntersection) {
   InvertedIndex_Free(w2);
 }
 
+TEST_F(IndexTest, testIntersectionReorder) {
+  // `a` has the fewest docs, so it drives the intersection. `b` has fewer docs than `c`, but rejects
+  // fewer of the candidates of `a`, so `c` is moved before it as the intersection runs
+  const t_docId N = 200000, bEnd = N * 65 / 100;
+  size_t index_memsize;
+  IndexEncoder enc = InvertedIndex_GetEncoder(Index_DocIdsOnly);
+  InvertedIndex *a = NewInvertedIndex(Index_DocIdsOnly, 1, &index_memsize);
+  InvertedIndex *b = NewInvertedIndex(Index_DocIdsOnly, 1, &index_memsize);
+  InvertedIndex *c = NewInvertedIndex(Index_DocIdsOnly, 1, &index_memsize);
+  for (t_docId id = 1; id <= N; id++) {
+    RSIndexResult rec = {};
+    rec.docId = id;
+    if (id % 2 == 0) InvertedIndex_WriteEntryGeneric(a, enc, id, &rec);
+    if (id % 100 && id <= bEnd) InvertedIndex_WriteEntryGeneric(b, enc, id, &rec);
+    if (id % 2 == 1 || id % 6 == 0) InvertedIndex_WriteEntryGeneric(c, enc, id, &rec);
+  }
+  ASSERT_LT(a->numDocs, b->numDocs);
+  ASSERT_LT(b->numDocs, c->numDocs);
+
+  IndexIterator **irs = (IndexIterator **)rm_calloc(3, sizeof(IndexIterator *));
+  irs[0] = NewReadIterator(NewTermIndexReader(c));
+  irs[1] = NewReadIterator(NewTermIndexReader(b));
+  irs[2] = NewReadIterator(NewTermIndexReader(a));
+  IndexIterator *ii = NewIntersectIterator(irs, 3, NULL, RS_FIELDMASK_ALL, -1, 0, 1);
+
+  for (int rewind = 0; rewind < 2; rewind++) {
+    RSIndexResult *h = NULL;
+    t_docId expected = 0;
+    while (ii->Read(ii->ctx, &h) == INDEXREAD_OK) {
+      do {
+        expected += 6;
+      } while (expected % 100 == 0);
+      ASSERT_EQ(expected, h->docId);
+      ASSERT_EQ(3, h->data.agg.numChildren);
+    }
+    ASSERT_GT(expected, bEnd - 12);
+    ii->Rewind(ii->ctx);
+  }
+
+  // Skipping is not affected by the order of the children either
+  RSIndexResult *h = NULL;
+  ASSERT_EQ(INDEXREAD_NOTFOUND, ii->SkipTo(ii->ctx, 601, &h));
+  ASSERT_EQ(606, h->docId);
+  ASSERT_EQ(INDEXREAD_OK, ii->SkipTo(ii->ctx, 1206, &h));
+  ASSERT_EQ(INDEXREAD_EOF, ii->SkipTo(ii->ctx, bEnd + 1, &h));
+
+  ii->Free(ii);
+  InvertedIndex_Free(a);
+  InvertedIndex_Free(b);
+  InvertedIndex_Free(c);
+}
+
+TEST_F(IndexTest, testNumericEstimateMatches) {
+  size_t index_memsize;
+  InvertedIndex *idx = NewInvertedIndex(Index_StoreNumeric, 1, &index_memsize);
+  for (int i = 1; i <= 1000; i++) {
+    InvertedIndex_WriteNumericEntry(idx, i, i - 1);
+  }
+  FieldMaskOrIndex fieldMaskOrIndex = {.isFieldMask = false, .value = {.index = RS_INVALID_FIELD_INDEX}};
+  FieldFilterContext filterCtx = {.field = fieldMaskOrIndex, .predicate = FIELD_EXPIRATION_DEFAULT};
+
+  // The filter covers a tenth of the range
+  NumericFilter *flt = NewNumericFilter(0, 99, 1, 1, true, NULL);
+  IndexReader *ir = NewNumericReader(NULL, idx, flt, 0, 999, true, &filterCtx);
+  ASSERT_EQ(100, IR_EstimateMatches(ir));
+  IR_Free(ir);
+
+  // No filter, or a filter outside of the range
+  ir = NewNumericReader(NULL, idx, NULL, 0, 999, true, &filterCtx);
+  ASSERT_EQ(1000, IR_EstimateMatches(ir));
+  IR_Free(ir);
+  NumericFilter_Free(flt);
+  flt = NewNumericFilter(2000, 3000, 1, 1, true, NULL);
+  ir = NewNumericReader(NULL, idx, flt, 0, 999, true, &filterCtx);
+  ASSERT_EQ(1, IR_EstimateMatches(ir));
+  IR_Free(ir);
+
+  NumericFilter_Free(flt);
+  InvertedIndex_Free(idx);
+}
+
 TEST_F(IndexTest, testHybridVector) {
 
   size_t n = 100;
@@ -1383,6 +1481,7 @@ TEST_F(IndexTest, testIndexFlags) {
   h.docId = 1234;
   h.fieldMask = 0x01;
   h.freq = 1;
+  h.docLen = 0;
   h.vw = NewVarintVectorWriter(8);
   for (int n = 0; n < 10; n++) {
     VVW_Write(h.vw, n);
@@ -1484,7 +1583,7 @@ TEST_F(IndexTest, testDocTable) {
   ASSERT_EQ(N + 1, dt.size);
   ASSERT_EQ(N, dt.maxDocId);
 #ifdef __x86_64__
-  ASSERT_EQ(10180 + doc_table_size, (int)dt.memsize);
+  ASSERT_EQ(11140 + doc_table_size, (int)dt.memsize);
 #endif
   for (int i = 0; i < N; i++) {
     snprintf(buf, sizeof(buf), "doc_%d", i);
@@ -1520,7 +1619,7 @@ TEST_F(IndexTest, testDocTable) {
   RSDocumentMetadata *dmd = DocTable_Put(&dt, "Hello", 5, 1.0, Document_DefaultFlags, NULL, 0, DocumentType_Hash);
   t_docId strDocId = dmd->id;
   ASSERT_TRUE(0 != strDocId);
-  ASSERT_EQ(71 + doc_table_size, (int)dt.memsize);
+  ASSERT_EQ(55 + doc_table_size, (int)dt.memsize);
 
   // Test that binary keys also work here
   static const char binBuf[] = {"Hello\x00World"};
@@ -1529,7 +1628,7 @@ TEST_F(IndexTest, testDocTable) {
   DMD_Return(dmd);
   dmd = DocTable_Put(&dt, binBuf, binBufLen, 1.0, Document_DefaultFlags, NULL, 0, DocumentType_Hash);
   ASSERT_TRUE(dmd);
-  ASSERT_EQ(148 + doc_table_size, (int)dt.memsize);
+  ASSERT_EQ(116 + doc_table_size, (int)dt.memsize);
   ASSERT_NE(dmd->id, strDocId);
   ASSERT_EQ(dmd->id, DocIdMap_Get(&dt.dim, binBuf, binBufLen));
   ASSERT_EQ(strDocId, DocIdMap_Get(&dt.dim, "Hello", 5));
@@ -1537,6 +1636,86 @@ TEST_F(IndexTest, testDocTable) {
   DocTable_Free(&dt);
 }
 
+// A table with more documents than buckets keeps sorted chains of them. Once most documents are
+// deleted, the table takes the same memory as one that only ever held the remaining ones
+TEST_F(IndexTest, testDocTableSparseIds) {
+  char buf[16];
+  DocTable dt = NewDocTable(10, 10);
+  const int N = 1000;
+  for (int i = 0; i < N; i++) {
+    size_t nkey = snprintf(buf, sizeof(buf), "doc_%d", i);
+    DMD_Return(DocTable_Put(&dt, buf, nkey, 1.0, Document_DefaultFlags, NULL, 0, DocumentType_Hash));
+  }
+  ASSERT_EQ(10, dt.cap);
+  for (int i = 0; i < N; i++) {
+    if (i % 100 != 7) {
+      size_t nkey = snprintf(buf, sizeof(buf), "doc_%d", i);
+      ASSERT_EQ(1, DocTable_Delete(&dt, buf, nkey));
+    }
+  }
+
+  DocTable expected = NewDocTable(10, 10);
+  for (int i = 7; i < N; i += 100) {
+    size_t nkey = snprintf(buf, sizeof(buf), "doc_%d", i);
+    DMD_Return(DocTable_Put(&expected, buf, nkey, 1.0, Document_DefaultFlags, NULL, 0, DocumentType_Hash));
+  }
+  ASSERT_EQ(expected.memsize, dt.memsize);
+  ASSERT_EQ(expected.size, dt.size);
+
+  for (t_docId id = 1; id <= N; id++) {
+    const RSDocumentMetadata *dmd = DocTable_Borrow(&dt, id);
+    ASSERT_EQ(id % 100 == 8, DocTable_Exists(&dt, id));
+    if (id % 100 == 8) {
+      ASSERT_TRUE(dmd);
+      ASSERT_EQ(id, dmd->id);
+      ASSERT_EQ(std::string("doc_") + std::to_string(id - 1), dmd->keyPtr);
+      DMD_Return(dmd);
+    } else {
+      ASSERT_FALSE(dmd);
+    }
+  }
+
+  DocTable_Free(&dt);
+  DocTable_Free(&expected);
+}
+
+// The entries of a chain grow and shrink geometrically, and a single document is kept inline
+TEST_F(IndexTest, testDocTableChainCapacity) {
+  char buf[16];
+  // A single bucket holds all the documents
+  DocTable dt = NewDocTable(1, 1);
+  const size_t empty = dt.memsize;
+  size_t docsSize = 0;
+  for (int i = 0; i < 5; i++) {
+    size_t nkey = snprintf(buf, sizeof(buf), "doc_%d", i);
+    size_t before = dt.memsize;
+    DMD_Return(DocTable_Put(&dt, buf, nkey, 1.0, Document_DefaultFlags, NULL, 0, DocumentType_Hash));
+    if (i == 0) docsSize = dt.memsize - before;
+  }
+  ASSERT_EQ(5, dt.buckets[0].size);
+  ASSERT_EQ(8, dt.buckets[0].cap);
+  ASSERT_EQ(empty + 5 * docsSize + 8 * sizeof(DMDEntry), dt.memsize);
+
+  for (int i = 0; i < 3; i++) {
+    size_t nkey = snprintf(buf, sizeof(buf), "doc_%d", i);
+    ASSERT_EQ(1, DocTable_Delete(&dt, buf, nkey));
+  }
+  ASSERT_EQ(2, dt.buckets[0].size);
+  ASSERT_EQ(4, dt.buckets[0].cap);
+  ASSERT_EQ(empty + 2 * docsSize + 4 * sizeof(DMDEntry), dt.memsize);
+
+  ASSERT_EQ(1, DocTable_Delete(&dt, "doc_3", 5));
+  ASSERT_EQ(1, dt.buckets[0].size);
+  ASSERT_EQ(empty + docsSize, dt.memsize);
+  const RSDocumentMetadata *dmd = DocTable_Borrow(&dt, 5);
+  ASSERT_TRUE(dmd);
+  ASSERT_STREQ("doc_4", dmd->keyPtr);
+  DMD_Return(dmd);
+  ASSERT_FALSE(DocTable_Borrow(&dt, 4));
+
+  DocTable_Free(&dt);
+}
+
 TEST_F(IndexTest, testVarintFieldMask) {
   t_fieldMask x = 127;
   size_t expected[] = {0, 2, 1, 1, 2, 0, 2, 0, 2, 3, 0, 0, 3, 0, 0, 4};
@@ -1639,3 +1818,854 @@ TEST_F(IndexTest, testRawDocId) {
   InvertedIndex_Free(idx);
   RSGlobalConfig.invertedIndexRawDocidEncoding = previousConfig;
 }
+
+class PackedIndexTest : public testing::TestWithParam<int> {
+protected:
+  static uint32_t expectedFreq(IndexFlags flags, size_t i) {
+    return (flags & Index_StoreFreqs) ? i % 10 + 1 : 1;
+  }
+
+  static void writeEntry(InvertedIndex *idx, IndexEncoder enc, t_docId docId, uint32_t freq) {
+    RSIndexResult rec = {};
+    rec.docId = docId;
+    rec.freq = freq;
+    InvertedIndex_WriteEntryGeneric(idx, enc, docId, &rec);
+  }
+};
+
+TEST_P(PackedIndexTest, testReadAndSkip) {
+  const IndexFlags flags = IndexFlags(GetParam());
+  size_t index_memsize = 0;
+  InvertedIndex *idx = NewInvertedIndex(flags, 1, &index_memsize);
+  IndexEncoder enc = InvertedIndex_GetEncoder(flags);
+  ASSERT_TRUE(InvertedIndex_GetDecoder(flags).blockDecoder != nullptr);
+
+  // Varying gaps, so the deltas take all the possible byte lengths, and the offsets from the first
+  // id of a block overflow 32 bits every few hundred entries. An odd number of entries leaves a
+  // partial (raw) group at the end
+  const t_docId gaps[] = {1, 3, 200, 300, 70000, 1, 20000000, 7};
+  const size_t numGaps = sizeof(gaps) / sizeof(*gaps);
+  std::vector<t_docId> ids;
+  t_docId id = 0;
+  for (size_t i = 0; i < 2503; i++) {
+    id += gaps[i % numGaps];
+    ids.push_back(id);
+    writeEntry(idx, enc, id, expectedFreq(flags, i));
+  }
+  ASSERT_EQ(ids.size(), idx->numDocs);
+  ASSERT_GT(idx->size, 2);
+
+  IndexReader *ir = NewTermIndexReader(idx);
+  RSIndexResult *cur;
+  for (size_t i = 0; i < ids.size(); i++) {
+    ASSERT_EQ(INDEXREAD_OK, IR_Read(ir, &cur));
+    ASSERT_EQ(ids[i], cur->docId);
+    ASSERT_EQ(expectedFreq(flags, i), cur->freq);
+  }
+  ASSERT_EQ(INDEXREAD_EOF, IR_Read(ir, &cur));
+
+  // Skip to every id and to the (missing) id right after it
+  for (size_t i = 0; i < ids.size(); i++) {
+    IR_Rewind(ir);
+    ASSERT_EQ(INDEXREAD_OK, IR_SkipTo(ir, ids[i], &cur));
+    ASSERT_EQ(ids[i], cur->docId);
+    ASSERT_EQ(expectedFreq(flags, i), cur->freq);
+
+    IR_Rewind(ir);
+    int rc = IR_SkipTo(ir, ids[i] + 1, &cur);
+    if (i + 1 == ids.size()) {
+      ASSERT_EQ(INDEXREAD_EOF, rc);
+    } else if (ids[i + 1] == ids[i] + 1) {
+      ASSERT_EQ(INDEXREAD_OK, rc);
+      ASSERT_EQ(ids[i + 1], cur->docId);
+    } else {
+      ASSERT_EQ(INDEXREAD_NOTFOUND, rc);
+      ASSERT_EQ(ids[i + 1], cur->docId);
+    }
+  }
+
+  // Skip forward without rewinding
+  IR_Rewind(ir);
+  for (size_t i = 0; i < ids.size(); i += 3) {
+    ASSERT_EQ(INDEXREAD_OK, IR_SkipTo(ir, ids[i], &cur));
+    ASSERT_EQ(ids[i], cur->docId);
+    ASSERT_EQ(expectedFreq(flags, i), cur->freq);
+  }
+
+  IR_Free(ir);
+  InvertedIndex_Free(idx);
+}
+
+TEST_P(PackedIndexTest, testRepair) {
+  const IndexFlags flags = IndexFlags(GetParam());
+  char buf[16];
+  DocTable dt = NewDocTable(10, 1000);
+  size_t index_memsize = 0;
+  InvertedIndex *idx = NewInvertedIndex(flags, 1, &index_memsize);
+  IndexEncoder enc = InvertedIndex_GetEncoder(flags);
+
+  const size_t N = 1030;
+  for (size_t i = 0; i < N; i++) {
+    size_t nkey = snprintf(buf, sizeof(buf), "doc_%zu", i);
+    RSDocumentMetadata *dmd = DocTable_Put(&dt, buf, nkey, 1.0, Document_DefaultFlags, NULL, 0, DocumentType_Hash);
+    writeEntry(idx, enc, dmd->id, expectedFreq(flags, i));
+    DMD_Return(dmd);
+  }
+  // Delete every third document
+  for (size_t i = 0; i < N; i += 3) {
+    size_t nkey = snprintf(buf, sizeof(buf), "doc_%zu", i);
+    ASSERT_EQ(1, DocTable_Delete(&dt, buf, nkey));
+  }
+
+  size_t collected = 0;
+  for (uint32_t i = 0; i < idx->size; i++) {
+    IndexRepairParams params = {0};
+    size_t frags = IndexBlock_Repair(&idx->blocks[i], &dt, idx->flags, &params);
+    ASSERT_EQ(frags, params.entriesCollected);
+    collected += frags;
+  }
+  ASSERT_EQ((N + 2) / 3, collected);
+
+  // Only the valid entries are left, and the blocks can still be appended to
+  writeEntry(idx, enc, N + 1, expectedFreq(flags, N));
+  IndexReader *ir = NewTermIndexReader(idx);
+  RSIndexResult *cur;
+  for (size_t i = 1; i < N; i += (i % 3 == 2) ? 2 : 1) {
+    ASSERT_EQ(INDEXREAD_OK, IR_Read(ir, &cur));
+    ASSERT_EQ(i + 1, cur->docId);
+    ASSERT_EQ(expectedFreq(flags, i), cur->freq);
+  }
+  ASSERT_EQ(INDEXREAD_OK, IR_Read(ir, &cur));
+  ASSERT_EQ(N + 1, cur->docId);
+  ASSERT_EQ(INDEXREAD_EOF, IR_Read(ir, &cur));
+
+  IR_Free(ir);
+  InvertedIndex_Free(idx);
+  DocTable_Free(&dt);
+}
+
+TEST_P(PackedIndexTest, testLazyDecoding) {
+  const IndexFlags flags = IndexFlags(GetParam());
+  size_t index_memsize = 0;
+  InvertedIndex *idx = NewInvertedIndex(flags, 1, &index_memsize);
+  IndexEncoder enc = InvertedIndex_GetEncoder(flags);
+  const size_t entrySize = (flags & Index_StoreFreqs) ? 2 * sizeof(uint32_t) : sizeof(uint32_t);
+
+  // Read while entries are appended, leaving the reader in the middle of the last (partial) group,
+  // which is packed once it fills up
+  IndexReader *ir = NewTermIndexReader(idx);
+  RSIndexResult *cur;
+  t_docId next = 1, expected = 1;
+  for (int round = 0; round < 300; round++) {
+    for (int i = 0; i < round % 7 + 1; i++, next++) {
+      writeEntry(idx, enc, next, expectedFreq(flags, next));
+    }
+    IndexReader_OnReopen(ir);
+    const t_docId last = round % 3 ? (expected + next) / 2 : next;
+    for (; expected < last; expected++) {
+      ASSERT_EQ(INDEXREAD_OK, IR_Read(ir, &cur));
+      ASSERT_EQ(expected, cur->docId);
+      ASSERT_EQ(expectedFreq(flags, expected), cur->freq);
+      // Only the current group is decoded
+      ASSERT_LE(Buffer_Offset(&ir->decodedBlock.records), GROUP_VARINT_SIZE * entrySize);
+    }
+  }
+  ASSERT_GT(idx->size, 1);
+
+  // Skipping past the last checkpoint of a block decodes it from there
+  for (uint32_t i = 0; i < idx->size; i++) {
+    const IndexBlock &blk = idx->blocks[i];
+    const IndexBlockSkips *skips = IndexBlock_Skips(&blk);
+    if (!skips) {
+      continue;
+    }
+    IR_Rewind(ir);
+    ASSERT_EQ(INDEXREAD_OK, IR_SkipTo(ir, blk.lastId, &cur));
+    ASSERT_EQ(blk.lastId, cur->docId);
+    ASSERT_GE(ir->decodedBlock.groupPos, skips->offsets[INDEX_BLOCK_NUM_SKIPS - 1]);
+  }
+
+  IR_Free(ir);
+  InvertedIndex_Free(idx);
+}
+
+INSTANTIATE_TEST_SUITE_P(PackedIndexP, PackedIndexTest, ::testing::Values(
+    int(Index_StorePacked | Index_DocIdsOnly),
+    int(Index_StorePacked | Index_StoreFreqs)
+));
+
+class SkipCheckpointsTest : public testing::TestWithParam<int> {};
+
+TEST_P(SkipCheckpointsTest, testSkipToWithCheckpoints) {
+  const IndexFlags flags = IndexFlags(GetParam());
+  char buf[16];
+  DocTable dt = NewDocTable(10, 1000);
+  size_t index_memsize = 0;
+  InvertedIndex *idx = NewInvertedIndex(flags, 1, &index_memsize);
+  IndexEncoder enc = InvertedIndex_GetEncoder(flags);
+
+  const size_t N = 2100;
+  for (size_t i = 0; i < N; i++) {
+    size_t nkey = snprintf(buf, sizeof(buf), "doc_%zu", i);
+    RSDocumentMetadata *dmd = DocTable_Put(&dt, buf, nkey, 1.0, Document_DefaultFlags, NULL, 0, DocumentType_Hash);
+    RSIndexResult rec = {};
+    rec.docId = dmd->id;
+    rec.freq = i % 7 + 1;
+    rec.fieldMask = 1;
+    InvertedIndex_WriteEntryGeneric(idx, enc, dmd->id, &rec);
+    DMD_Return(dmd);
+  }
+
+  // Full blocks of at least INDEX_BLOCK_SKIPS_MIN_CAPACITY entries have all their checkpoints, each
+  // preceded by the entry before it. Smaller blocks have none
+  size_t numWithSkips = 0;
+  for (uint32_t i = 0; i < idx->size - 1; i++) {
+    const IndexBlock &blk = idx->blocks[i];
+    if (blk.capacity < INDEX_BLOCK_SKIPS_MIN_CAPACITY) {
+      ASSERT_EQ(nullptr, IndexBlock_Skips(&blk));
+      continue;
+    }
+    const IndexBlockSkips *skips = IndexBlock_Skips(&blk);
+    ASSERT_NE(nullptr, skips);
+    const size_t interval = blk.capacity / (INDEX_BLOCK_NUM_SKIPS + 1);
+    for (size_t j = 0; j < INDEX_BLOCK_NUM_SKIPS; j++) {
+      ASSERT_NE(0, skips->offsets[j]);
+      ASSERT_EQ((j + 1) * interval - 1, skips->baseIds[j]);
+    }
+    numWithSkips++;
+  }
+  ASSERT_LT(0, numWithSkips);
+
+  IndexReader *ir = NewTermIndexReader(idx);
+  RSIndexResult *cur;
+  for (t_docId id = 1; id <= N; id++) {
+    IR_Rewind(ir);
+    ASSERT_EQ(INDEXREAD_OK, IR_SkipTo(ir, id, &cur));
+    ASSERT_EQ(id, cur->docId);
+    ASSERT_EQ((id - 1) % 7 + 1, cur->freq);
+  }
+  IR_Free(ir);
+
+  // Delete every third document and repair the blocks. The checkpoints are taken again
+  for (size_t i = 0; i < N; i += 3) {
+    size_t nkey = snprintf(buf, sizeof(buf), "doc_%zu", i);
+    ASSERT_EQ(1, DocTable_Delete(&dt, buf, nkey));
+  }
+  for (uint32_t i = 0; i < idx->size; i++) {
+    IndexRepairParams params = {0};
+    const IndexBlock &blk = idx->blocks[i];
+    IndexBlock_Repair(&idx->blocks[i], &dt, idx->flags, &params);
+    const size_t interval = blk.capacity / (INDEX_BLOCK_NUM_SKIPS + 1);
+    const IndexBlockSkips *skips = IndexBlock_Skips(&blk);
+    for (size_t j = 0; skips && j < INDEX_BLOCK_NUM_SKIPS; j++) {
+      if (skips->offsets[j]) {
+        ASSERT_LT((j + 1) * interval, blk.numEntries);
+      }
+    }
+  }
+
+  ir = NewTermIndexReader(idx);
+  for (t_docId id = 1; id <= N; id++) {
+    IR_Rewind(ir);
+    int rc = IR_SkipTo(ir, id, &cur);
+    if ((id - 1) % 3 == 0) {
+      // A deleted document - we get the next one
+      ASSERT_EQ(INDEXREAD_NOTFOUND, rc);
+      ASSERT_EQ(id + 1, cur->docId);
+    } else {
+      ASSERT_EQ(INDEXREAD_OK, rc);
+      ASSERT_EQ(id, cur->docId);
+    }
+  }
+  // Skip forward without rewinding
+  IR_Rewind(ir);
+  for (t_docId id = 2; id <= N; id += 3) {
+    ASSERT_EQ(INDEXREAD_OK, IR_SkipTo(ir, id, &cur));
+    ASSERT_EQ(id, cur->docId);
+  }
+
+  IR_Free(ir);
+  InvertedIndex_Free(idx);
+  DocTable_Free(&dt);
+}
+
+INSTANTIATE_TEST_SUITE_P(SkipCheckpointsP, SkipCheckpointsTest, ::testing::Values(
+    int(Index_DocIdsOnly),
+    int(Index_StoreFreqs),
+    int(Index_StoreFreqs | Index_StoreFieldFlags)
+));
+
+// Numeric blocks may hold ids more than UINT32_MAX apart. The checkpoints past such a gap can't be
+// taken, and must not be left over from before a repair
+TEST_F(IndexTest, testSkipCheckpointsWideRange) {
+  char buf[16];
+  DocTable dt = NewDocTable(10, 1000);
+  size_t index_memsize = 0;
+  InvertedIndex *idx = NewInvertedIndex(Index_StoreNumeric, 1, &index_memsize);
+  idx->blocks[0].capacity = 4 * INDEX_BLOCK_SIZE;
+  const size_t interval = idx->blocks[0].capacity / (INDEX_BLOCK_NUM_SKIPS + 1);
+
+  // 200 low ids, then 200 ids past 2^32
+  std::vector<t_docId> ids;
+  for (size_t i = 0; i < 400; i++) {
+    if (i == 200) {
+      dt.maxDocId = (1ULL << 32) + 100;
+    }
+    size_t nkey = snprintf(buf, sizeof(buf), "doc_%zu", i);
+    RSDocumentMetadata *dmd = DocTable_Put(&dt, buf, nkey, 1.0, Document_DefaultFlags, NULL, 0, DocumentType_Hash);
+    InvertedIndex_WriteNumericEntry(idx, dmd->id, i);
+    ids.push_back(dmd->id);
+    DMD_Return(dmd);
+  }
+  ASSERT_EQ(1, idx->size);
+  const IndexBlock &blk = idx->blocks[0];
+  const IndexBlockSkips *skips = IndexBlock_Skips(&blk);
+  ASSERT_NE(nullptr, skips);
+  ASSERT_NE(0, skips->offsets[0]);
+  ASSERT_NE(0, skips->offsets[1]);
+  ASSERT_EQ(0, skips->offsets[2]);
+  ASSERT_EQ(0, skips->offsets[3]);
+
+  // Delete the first 100 documents. The checkpoint that was taken at entry 160 now falls past the
+  // gap, so it is cleared rather than kept with its old offset
+  for (size_t i = 0; i < 100; i++) {
+    size_t nkey = snprintf(buf, sizeof(buf), "doc_%zu", i);
+    ASSERT_EQ(1, DocTable_Delete(&dt, buf, nkey));
+  }
+  IndexRepairParams params = {0};
+  ASSERT_EQ(100, IndexBlock_Repair(&idx->blocks[0], &dt, idx->flags, &params));
+  ASSERT_EQ(300, blk.numEntries);
+  ASSERT_EQ(ids[100], blk.firstId);
+  skips = IndexBlock_Skips(&blk);
+  ASSERT_NE(nullptr, skips);
+  ASSERT_NE(0, skips->offsets[0]);
+  ASSERT_EQ(interval - 1, skips->baseIds[0]);
+  ASSERT_EQ(0, skips->offsets[1]);
+  ASSERT_EQ(0, skips->offsets[2]);
+  ASSERT_EQ(0, skips->offsets[3]);
+
+  IndexReader *ir = NewMinimalNumericReader(idx, false);
+  RSIndexResult *cur;
+  for (size_t i = 100; i < ids.size(); i++) {
+    IR_Rewind(ir);
+    ASSERT_EQ(INDEXREAD_OK, IR_SkipTo(ir, ids[i], &cur));
+    ASSERT_EQ(ids[i], cur->docId);
+    ASSERT_EQ(i, cur->data.num.value);
+  }
+  IR_Free(ir);
+
+  InvertedIndex_Free(idx);
+  DocTable_Free(&dt);
+}
+
+// Most terms of a real index hold a handful of documents. Their single block never reaches the
+// skip checkpoints, so the index costs its header, one IndexBlock and the encoded data
+TEST_F(IndexTest, testSmallIndexesMemory) {
+  const size_t numTerms = 1000;
+  for (IndexFlags flags : {Index_DocIdsOnly, IndexFlags(Index_StoreFreqs | Index_StoreFieldFlags)}) {
+    IndexEncoder enc = InvertedIndex_GetEncoder(flags);
+    std::vector<InvertedIndex *> idxs;
+    size_t totalMem = 0, totalData = 0;
+    for (size_t i = 0; i < numTerms; i++) {
+      size_t index_memsize = 0;
+      InvertedIndex *idx = NewInvertedIndex(flags, 1, &index_memsize);
+      for (t_docId n = 1; n <= i % 10 + 1; n++) {
+        RSIndexResult rec = {};
+        rec.docId = n * 97 + i;
+        rec.freq = 1;
+        rec.fieldMask = 1;
+        InvertedIndex_WriteEntryGeneric(idx, enc, rec.docId, &rec);
+      }
+      ASSERT_EQ(1, idx->size);
+      ASSERT_EQ(nullptr, IndexBlock_Skips(&idx->blocks[0]));
+      size_t mem = InvertedIndex_MemUsage(idx);
+      ASSERT_EQ(sizeof_InvertedIndex(flags) + sizeof(IndexBlock) + IndexBlock_DataCap(&idx->blocks[0]), mem);
+      totalMem += mem;
+      totalData += IndexBlock_DataCap(&idx->blocks[0]);
+      idxs.push_back(idx);
+    }
+    ASSERT_EQ(numTerms * (sizeof_InvertedIndex(flags) + sizeof(IndexBlock)), totalMem - totalData);
+    for (InvertedIndex *idx : idxs) {
+      InvertedIndex_Free(idx);
+    }
+  }
+
+  // A large sparse index does get checkpoints, which take room in the buffers of its blocks
+  size_t index_memsize = 0;
+  InvertedIndex *idx = NewInvertedIndex(Index_DocIdsOnly, 1, &index_memsize);
+  IndexEncoder enc = InvertedIndex_GetEncoder(Index_DocIdsOnly);
+  for (t_docId id = 1000; id <= 5000 * 1000; id += 1000) {
+    RSIndexResult rec = {.docId = id};
+    InvertedIndex_WriteEntryGeneric(idx, enc, id, &rec);
+  }
+  size_t expected = sizeof_InvertedIndex(Index_DocIdsOnly);
+  size_t numWithSkips = 0;
+  for (uint32_t i = 0; i < idx->size; i++) {
+    const IndexBlock *blk = idx->blocks + i;
+    numWithSkips += IndexBlock_Skips(blk) != nullptr;
+    expected += sizeof(IndexBlock) + IndexBlock_DataCap(blk);
+  }
+  ASSERT_GT(numWithSkips, 0);
+  ASSERT_EQ(expected, InvertedIndex_MemUsage(idx));
+  InvertedIndex_Free(idx);
+}
+
+TEST_F(IndexTest, testAdaptiveBlockSize) {
+  size_t index_memsize = 0;
+  InvertedIndex *idx = NewInvertedIndex(Index_StoreFreqs, 1, &index_memsize);
+  IndexEncoder enc = InvertedIndex_GetEncoder(Index_StoreFreqs);
+
+  // The block size doubles every time the index holds INDEX_BLOCK_GROWTH_THRESHOLD blocks worth of
+  // documents
+  const size_t N = 4 * INDEX_BLOCK_SIZE * INDEX_BLOCK_GROWTH_THRESHOLD;
+  for (t_docId id = 1; id <= N; id++) {
+    RSIndexResult rec = {};
+    rec.docId = id;
+    rec.freq = 1;
+    InvertedIndex_WriteEntryGeneric(idx, enc, id, &rec);
+  }
+  ASSERT_EQ(INDEX_BLOCK_SIZE, idx->blocks[0].capacity);
+  ASSERT_EQ(4 * INDEX_BLOCK_SIZE, idx->blocks[idx->size - 1].capacity);
+  for (uint32_t i = 0; i < idx->size - 1; i++) {
+    ASSERT_EQ(idx->blocks[i].capacity, idx->blocks[i].numEntries);
+    ASSERT_LE(idx->blocks[i].capacity, idx->blocks[i + 1].capacity);
+  }
+  ASSERT_LT(idx->size, N / INDEX_BLOCK_SIZE);
+
+  IndexReader *ir = NewTermIndexReader(idx);
+  RSIndexResult *cur;
+  for (t_docId id = 1; id <= N; id += 7) {
+    ASSERT_EQ(INDEXREAD_OK, IR_SkipTo(ir, id, &cur));
+    ASSERT_EQ(id, cur->docId);
+  }
+  IR_Free(ir);
+  InvertedIndex_Free(idx);
+
+  // Blocks are also bounded by bytes, e.g. when their entries have many offsets
+  idx = NewInvertedIndex(IndexFlags(INDEX_DEFAULT_FLAGS), 1, &index_memsize);
+  enc = InvertedIndex_GetEncoder(idx->flags);
+  char offsets[200] = {0};
+  for (t_docId id = 1; id <= INDEX_BLOCK_SIZE; id++) {
+    RSIndexResult rec = {};
+    rec.docId = id;
+    rec.freq = 1;
+    rec.fieldMask = 1;
+    rec.offsetsSz = sizeof(offsets);
+    rec.data.term.offsets.data = offsets;
+    rec.data.term.offsets.len = sizeof(offsets);
+    InvertedIndex_WriteEntryGeneric(idx, enc, id, &rec);
+  }
+  ASSERT_GT(idx->size, 1);
+  ASSERT_LT(idx->blocks[0].numEntries, INDEX_BLOCK_SIZE);
+  ASSERT_LT(idx->blocks[0].buf.offset, INDEX_BLOCK_MAX_BYTES + sizeof(offsets) + 16);
+  InvertedIndex_Free(idx);
+}
+
+TEST_F(IndexTest, testMergeBlocks) {
+  char buf[16];
+  DocTable dt = NewDocTable(10, 1000);
+  size_t index_memsize = 0;
+  const IndexFlags flags = IndexFlags(Index_StoreFreqs | Index_StoreFieldFlags);
+  InvertedIndex *idx = NewInvertedIndex(flags, 1, &index_memsize);
+  IndexEncoder enc = InvertedIndex_GetEncoder(flags);
+
+  const size_t N = 3 * INDEX_BLOCK_SIZE;
+  for (size_t i = 0; i < N; i++) {
+    size_t nkey = snprintf(buf, sizeof(buf), "doc_%zu", i);
+    RSDocumentMetadata *dmd = DocTable_Put(&dt, buf, nkey, 1.0, Document_DefaultFlags, NULL, 0, DocumentType_Hash);
+    RSIndexResult rec = {};
+    rec.docId = dmd->id;
+    rec.freq = i % 7 + 1;
+    rec.fieldMask = 1;
+    InvertedIndex_WriteEntryGeneric(idx, enc, dmd->id, &rec);
+    DMD_Return(dmd);
+  }
+  ASSERT_EQ(3, idx->size);
+
+  // Full blocks are not merged
+  ASSERT_FALSE(IndexBlock_Merge(&idx->blocks[0], &idx->blocks[1], flags));
+
+  // Keep one document in 3 in the first two blocks
+  for (size_t i = 0; i < 2 * INDEX_BLOCK_SIZE; i++) {
+    if (i % 3) {
+      size_t nkey = snprintf(buf, sizeof(buf), "doc_%zu", i);
+      ASSERT_EQ(1, DocTable_Delete(&dt, buf, nkey));
+    }
+  }
+  for (uint32_t i = 0; i < 2; i++) {
+    IndexRepairParams params = {0};
+    IndexBlock_Repair(&idx->blocks[i], &dt, idx->flags, &params);
+  }
+  const size_t numEntries = idx->blocks[0].numEntries + idx->blocks[1].numEntries;
+  ASSERT_TRUE(IndexBlock_Merge(&idx->blocks[0], &idx->blocks[1], flags));
+  ASSERT_EQ(numEntries, idx->blocks[0].numEntries);
+  ASSERT_EQ(idx->blocks[1].lastId, idx->blocks[0].lastId);
+  // The merged block is full - it does not take the third block
+  ASSERT_FALSE(IndexBlock_Merge(&idx->blocks[0], &idx->blocks[2], flags));
+  indexBlock_Free(&idx->blocks[1]);
+  idx->blocks[1] = idx->blocks[2];
+  idx->size--;
+  TotalIIBlocks--;
+
+  IndexReader *ir = NewTermIndexReader(idx);
+  RSIndexResult *cur;
+  for (t_docId id = 1; id <= N; id++) {
+    IR_Rewind(ir);
+    int rc = IR_SkipTo(ir, id, &cur);
+    if (id <= 2 * INDEX_BLOCK_SIZE && (id - 1) % 3) {
+      // A deleted document - we get the next one
+      ASSERT_EQ(INDEXREAD_NOTFOUND, rc);
+    } else {
+      ASSERT_EQ(INDEXREAD_OK, rc);
+      ASSERT_EQ(id, cur->docId);
+      ASSERT_EQ((id - 1) % 7 + 1, cur->freq);
+    }
+  }
+  IR_Free(ir);
+  InvertedIndex_Free(idx);
+  DocTable_Free(&dt);
+}
+
+TEST_F(IndexTest, testBitmapBlocks) {
+  char buf[16];
+  DocTable dt = NewDocTable(10, 1000);
+  size_t index_memsize = 0;
+  InvertedIndex *idx = NewInvertedIndex(Index_DocIdsOnly, 1, &index_memsize);
+  IndexEncoder enc = InvertedIndex_GetEncoder(Index_DocIdsOnly);
+
+  // Every other document - dense enough for a bitmap, which then takes all the entries
+  const size_t N = 6000;
+  for (size_t i = 0; i < N; i++) {
+    size_t nkey = snprintf(buf, sizeof(buf), "doc_%zu", i);
+    RSDocumentMetadata *dmd = DocTable_Put(&dt, buf, nkey, 1.0, Document_DefaultFlags, NULL, 0, DocumentType_Hash);
+    if (dmd->id % 2 == 0) {
+      RSIndexResult rec = {};
+      rec.docId = dmd->id;
+      index_memsize += InvertedIndex_WriteEntryGeneric(idx, enc, dmd->id, &rec);
+    }
+    DMD_Return(dmd);
+  }
+  ASSERT_EQ(1, idx->size);
+  ASSERT_TRUE(IndexBlock_IsBitmap(&idx->blocks[0]));
+  // The conversion keeps the block's allocations, so the reported memory is exact
+  ASSERT_EQ(InvertedIndex_MemUsage(idx), index_memsize);
+  ASSERT_EQ(N / 2, idx->blocks[0].numEntries);
+  ASSERT_LT(idx->blocks[0].buf.offset, N / 8 + 8);
+
+  IndexReader *ir = NewTermIndexReader(idx);
+  RSIndexResult *cur;
+  for (t_docId id = 2; id <= N; id += 2) {
+    ASSERT_EQ(INDEXREAD_OK, IR_Read(ir, &cur));
+    ASSERT_EQ(id, cur->docId);
+  }
+  ASSERT_EQ(INDEXREAD_EOF, IR_Read(ir, &cur));
+  IR_Rewind(ir);
+  ASSERT_EQ(INDEXREAD_NOTFOUND, IR_SkipTo(ir, 1001, &cur));
+  ASSERT_EQ(1002, cur->docId);
+  ASSERT_EQ(INDEXREAD_OK, IR_SkipTo(ir, 4000, &cur));
+  ASSERT_EQ(4000, cur->docId);
+  IR_Free(ir);
+
+  // Keep one document in 20. The block is too sparse for a bitmap and is written as deltas again
+  for (size_t i = 0; i < N; i++) {
+    if ((i + 1) % 20) {
+      size_t nkey = snprintf(buf, sizeof(buf), "doc_%zu", i);
+      ASSERT_EQ(1, DocTable_Delete(&dt, buf, nkey));
+    }
+  }
+  IndexRepairParams params = {0};
+  IndexBlock_Repair(&idx->blocks[0], &dt, idx->flags, &params);
+  ASSERT_FALSE(IndexBlock_IsBitmap(&idx->blocks[0]));
+  ASSERT_EQ(N / 20, idx->blocks[0].numEntries);
+  ASSERT_EQ(20, idx->blocks[0].firstId);
+  ASSERT_EQ(N, idx->blocks[0].lastId);
+
+  ir = NewTermIndexReader(idx);
+  for (t_docId id = 20; id <= N; id += 20) {
+    ASSERT_EQ(INDEXREAD_OK, IR_Read(ir, &cur));
+    ASSERT_EQ(id, cur->docId);
+  }
+  ASSERT_EQ(INDEXREAD_EOF, IR_Read(ir, &cur));
+  IR_Free(ir);
+
+  InvertedIndex_Free(idx);
+  DocTable_Free(&dt);
+}
+
+TEST_F(IndexTest, testBitmapIntersect) {
+  // Doc-id only indexes of every 2nd and every 3rd id, dense enough to be stored as bitmap blocks
+  size_t memsize = 0;
+  InvertedIndex *idx2 = NewInvertedIndex(Index_DocIdsOnly, 1, &memsize);
+  InvertedIndex *idx3 = NewInvertedIndex(Index_DocIdsOnly, 1, &memsize);
+  IndexEncoder enc = InvertedIndex_GetEncoder(Index_DocIdsOnly);
+  const t_docId N = 30000;
+  for (t_docId id = 1; id <= N; id++) {
+    RSIndexResult rec = {};
+    rec.docId = id;
+    if (id % 2 == 0) InvertedIndex_WriteEntryGeneric(idx2, enc, id, &rec);
+    if (id % 3 == 0) InvertedIndex_WriteEntryGeneric(idx3, enc, id, &rec);
+  }
+  ASSERT_TRUE(IndexBlock_IsBitmap(&idx2->blocks[0]));
+  ASSERT_TRUE(IndexBlock_IsBitmap(&idx3->blocks[0]));
+
+  IndexIterator **irs = (IndexIterator **)calloc(2, sizeof(IndexIterator *));
+  irs[0] = NewReadIterator(NewTermIndexReader(idx2));
+  irs[1] = NewReadIterator(NewTermIndexReader(idx3));
+  IndexIterator *ii = NewIntersectIterator(irs, 2, NULL, RS_FIELDMASK_ALL, -1, 0, 1);
+
+  // The candidates come from the AND of the bitmaps, and are the multiples of 6
+  RSIndexResult *h = NULL;
+  t_docId expected = 6;
+  while (ii->Read(ii->ctx, &h) != INDEXREAD_EOF) {
+    ASSERT_EQ(expected, h->docId);
+    expected += 6;
+  }
+  ASSERT_EQ(N + 6, expected);
+
+  ii->Rewind(ii->ctx);
+  ASSERT_EQ(INDEXREAD_NOTFOUND, ii->SkipTo(ii->ctx, 1000, &h));
+  ASSERT_EQ(1002, h->docId);
+  ASSERT_EQ(INDEXREAD_OK, ii->Read(ii->ctx, &h));
+  ASSERT_EQ(1008, h->docId);
+  ASSERT_EQ(INDEXREAD_OK, ii->SkipTo(ii->ctx, 6000, &h));
+  ASSERT_EQ(6000, h->docId);
+
+  ii->Free(ii);
+  InvertedIndex_Free(idx2);
+  InvertedIndex_Free(idx3);
+}
+
+// Mirrors the term score of the BM25STD scorer
+static double bm25StdTermScore(const BlockMaxScoreCtx *ctx, double f, uint32_t docLen) {
+  const float b = 0.75f, k1 = 1.2f;
+  return ctx->weight * ctx->idf * f * (k1 + 1) /
+         (f + k1 * (1.0f - b + b * (float)docLen / ctx->avgDocLen));
+}
+
+static IndexReader *newBoundedTermReader(InvertedIndex *idx, double idf) {
+  RSToken tok = {.str = (char *)"term", .len = 4};
+  RSQueryTerm *term = NewQueryTerm(&tok, 1);
+  term->bm25_idf = idf;
+  FieldMaskOrIndex fieldMaskOrIndex = {.isFieldMask = false, .value = {.index = RS_INVALID_FIELD_INDEX}};
+  return NewTermIndexReaderEx(idx, NULL, fieldMaskOrIndex, term, 1);
+}
+
+TEST_F(IndexTest, testBlockMaxScores) {
+  // Entries of frequency 1 in long documents, but for a block of frequent entries in short ones
+  size_t memsize = 0;
+  InvertedIndex *idx = NewInvertedIndex(Index_StoreFreqs, 1, &memsize);
+  InvertedIndex *all = NewInvertedIndex(Index_StoreFreqs, 1, &memsize);
+  IndexEncoder enc = InvertedIndex_GetEncoder(Index_StoreFreqs);
+  const t_docId N = 1000;
+  auto frequent = [](t_docId id) { return id > 500 && id <= 600; };
+  auto docLen = [&](t_docId id) { return frequent(id) ? 10 : 100 + id % 7; };
+  for (t_docId id = 1; id <= N; id++) {
+    RSIndexResult rec = {};
+    rec.type = RSResultType_Term;
+    rec.docId = id;
+    rec.freq = frequent(id) ? 10 : 1;
+    InvertedIndex_WriteEntryWithDocLen(idx, enc, id, &rec, docLen(id));
+    rec.freq = 1;
+    InvertedIndex_WriteEntryWithDocLen(all, enc, id, &rec, 100);
+  }
+  ASSERT_EQ(N / INDEX_BLOCK_SIZE, idx->size);
+  ASSERT_EQ(1, idx->blocks[0].maxFreq);
+  ASSERT_EQ(100, idx->blocks[0].minDocLen);
+  ASSERT_EQ(10, idx->blocks[5].maxFreq);
+  ASSERT_EQ(10, idx->blocks[5].minDocLen);
+
+  // The bound of a block is not below the score of any of its entries
+  BlockMaxScoreCtx ctx = {.idf = 2, .weight = 1, .avgDocLen = 50};
+  for (t_docId id = 1; id <= N; id++) {
+    const IndexBlock *blk = &idx->blocks[(id - 1) / INDEX_BLOCK_SIZE];
+    ASSERT_LE(bm25StdTermScore(&ctx, frequent(id) ? 10 : 1, docLen(id)), IndexBlock_MaxScore(blk, &ctx));
+  }
+  // An unknown frequency is bound by the limit of the score
+  IndexBlock unknown = idx->blocks[0];
+  unknown.maxFreq = 0;
+  ASSERT_DOUBLE_EQ(2 * (1.2f + 1), IndexBlock_MaxScore(&unknown, &ctx));
+
+  IndexReader *ir = newBoundedTermReader(idx, 2);
+  ASSERT_TRUE(IR_SetScoreBounds(ir, 50, 1));
+  const double low = IndexBlock_MaxScore(&idx->blocks[0], &ir->scoreCtx);
+  const double high = IndexBlock_MaxScore(&idx->blocks[5], &ir->scoreCtx);
+  ASSERT_LT(low, high);
+  t_docId first, last;
+  double bound;
+  ASSERT_TRUE(IR_BlockMaxScore(ir, 150, &first, &last, &bound));
+  ASSERT_EQ(150, first);
+  ASSERT_EQ(200, last);
+  ASSERT_DOUBLE_EQ(low, bound);
+  ASSERT_FALSE(IR_BlockMaxScore(ir, N + 1, &first, &last, &bound));
+
+  // A reader passes over the blocks below the threshold, past the one it starts in
+  double threshold = (low + high) / 2;
+  ir->scoreThreshold = &threshold;
+  IndexIterator *it = NewReadIterator(ir);
+  RSIndexResult *h = NULL;
+  std::vector<t_docId> ids;
+  while (it->Read(it->ctx, &h) != INDEXREAD_EOF) {
+    ids.push_back(h->docId);
+  }
+  ASSERT_EQ(200, ids.size());
+  ASSERT_EQ(100, ids[99]);
+  ASSERT_EQ(501, ids[100]);
+  ASSERT_EQ(600, ids.back());
+  it->Free(it);
+
+  // Unions and intersections pass over the ranges whose summed bounds are below the threshold
+  IteratorsConfig config{};
+  iteratorsConfig_init(&config);
+  const double allBound = IndexBlock_MaxScore(&all->blocks[0], &ir->scoreCtx);
+  threshold += allBound;
+  for (int intersect = 0; intersect < 2; intersect++) {
+    IndexIterator **irs = (IndexIterator **)calloc(2, sizeof(IndexIterator *));
+    irs[0] = NewReadIterator(newBoundedTermReader(idx, 2));
+    irs[1] = NewReadIterator(newBoundedTermReader(all, 2));
+    IndexIterator *root = intersect ? NewIntersectIterator(irs, 2, NULL, RS_FIELDMASK_ALL, -1, 0, 1)
+                                    : NewUnionIterator(irs, 2, 0, 1, QN_UNION, NULL, &config);
+    ASSERT_TRUE(EnableBlockMaxPruning(root, &threshold, 50, 1));
+    t_docId expected = 501;
+    while (root->Read(root->ctx, &h) != INDEXREAD_EOF) {
+      ASSERT_EQ(expected, h->docId);
+      expected++;
+    }
+    ASSERT_EQ(601, expected);
+    root->Free(root);
+  }
+
+  InvertedIndex_Free(idx);
+  InvertedIndex_Free(all);
+}
+
+// Read all the ids of an iterator in batches of the given size
+static std::vector<t_docId> readAllBatches(IndexIterator *it, size_t cap) {
+  std::vector<t_docId> ids, batch(cap);
+  size_t n;
+  int rc;
+  do {
+    rc = IndexIterator_ReadBatch(it, batch.data(), cap, &n);
+    EXPECT_LE(n, cap);
+    ids.insert(ids.end(), batch.begin(), batch.begin() + n);
+  } while (rc == INDEXREAD_OK);
+  EXPECT_EQ(INDEXREAD_EOF, rc);
+  return ids;
+}
+
+TEST_F(IndexTest, testReadBatch) {
+  // A doc-id only index of every 3rd id, with bitmap blocks, and a regular one
+  size_t memsize = 0;
+  InvertedIndex *bitmap = NewInvertedIndex(Index_DocIdsOnly, 1, &memsize);
+  IndexEncoder enc = InvertedIndex_GetEncoder(Index_DocIdsOnly);
+  const t_docId N = 10000;
+  std::vector<t_docId> expected;
+  for (t_docId id = 3; id <= N; id += 3) {
+    RSIndexResult rec = {};
+    rec.docId = id;
+    InvertedIndex_WriteEntryGeneric(bitmap, enc, id, &rec);
+    expected.push_back(id);
+  }
+  ASSERT_TRUE(IndexBlock_IsBitmap(&bitmap->blocks[0]));
+  InvertedIndex *regular = createPopulateTermsInvIndex(1000, 3);
+
+  for (size_t cap : {1, 7, 64, 256, 5000}) {
+    IndexIterator *it = NewReadIterator(NewTermIndexReader(bitmap));
+    ASSERT_EQ(expected, readAllBatches(it, cap));
+    ASSERT_EQ(expected.size(), it->Len(it->ctx));
+    ASSERT_EQ(expected.back(), it->LastDocId(it->ctx));
+    it->Free(it);
+
+    it = NewReadIterator(NewTermIndexReader(regular));
+    std::vector<t_docId> ids = readAllBatches(it, cap);
+    ASSERT_EQ(1000, ids.size());
+    ASSERT_EQ(3, ids[0]);
+    ASSERT_EQ(3000, ids.back());
+    it->Free(it);
+
+    // Id lists copy their ids, and intersections fall back to reading one by one
+    t_docId *list = (t_docId *)rm_malloc(expected.size() * sizeof(t_docId));
+    std::copy(expected.begin(), expected.end(), list);
+    it = NewIdListIterator(list, expected.size(), 1);
+    ASSERT_EQ(expected, readAllBatches(it, cap));
+    it->Free(it);
+
+    IndexIterator **irs = (IndexIterator **)calloc(2, sizeof(IndexIterator *));
+    irs[0] = NewReadIterator(NewTermIndexReader(bitmap));
+    irs[1] = NewReadIterator(NewTermIndexReader(regular));
+    it = NewIntersectIterator(irs, 2, NULL, RS_FIELDMASK_ALL, -1, 0, 1);
+    ids = readAllBatches(it, cap);
+    ASSERT_EQ(1000, ids.size());
+    ASSERT_EQ(3000, ids.back());
+    it->Free(it);
+  }
+
+  // Reading one by one picks up where a batch stopped
+  IndexIterator *it = NewReadIterator(NewTermIndexReader(bitmap));
+  t_docId batch[10];
+  size_t n;
+  ASSERT_EQ(INDEXREAD_OK, IndexIterator_ReadBatch(it, batch, 10, &n));
+  ASSERT_EQ(10, n);
+  ASSERT_EQ(30, batch[9]);
+  RSIndexResult *h = NULL;
+  ASSERT_EQ(INDEXREAD_OK, it->Read(it->ctx, &h));
+  ASSERT_EQ(33, h->docId);
+  it->Free(it);
+
+  InvertedIndex_Free(bitmap);
+  InvertedIndex_Free(regular);
+}
+
+TEST_F(IndexTest, testUnionBitmapReadBatch) {
+  // A union wide and large enough to accumulate its children in a bitmap when read in batches
+  const int steps[] = {2, 3, 5};
+  IndexIterator **irs = (IndexIterator **)calloc(3, sizeof(IndexIterator *));
+  InvertedIndex *idxs[3];
+  std::set<t_docId> expectedSet;
+  for (int i = 0; i < 3; i++) {
+    idxs[i] = createPopulateTermsInvIndex(1000, steps[i]);
+    irs[i] = NewReadIterator(NewTermIndexReader(idxs[i]));
+    for (t_docId id = steps[i]; id <= 1000 * steps[i]; id += steps[i]) expectedSet.insert(id);
+  }
+  std::vector<t_docId> expected(expectedSet.begin(), expectedSet.end());
+  IteratorsConfig config{};
+  iteratorsConfig_init(&config);
+  config.minUnionIterHeap = 2;
+  IndexIterator *ui = NewUnionIterator(irs, 3, 0, 1, QN_UNION, NULL, &config);
+  ASSERT_TRUE(ui->ReadBatch);
+
+  // Start with regular reads, which leave some children ahead of the union
+  RSIndexResult *h = NULL;
+  for (size_t i = 0; i < 5; i++) {
+    ASSERT_EQ(INDEXREAD_OK, ui->Read(ui->ctx, &h));
+    ASSERT_EQ(expected[i], h->docId);
+  }
+  t_docId batch[10];
+  size_t n;
+  ASSERT_EQ(INDEXREAD_OK, IndexIterator_ReadBatch(ui, batch, 10, &n));
+  ASSERT_EQ(10, n);
+  ASSERT_TRUE(std::equal(batch, batch + 10, expected.begin() + 5));
+
+  // Reads and skips are served from the bitmap
+  ASSERT_EQ(INDEXREAD_OK, ui->Read(ui->ctx, &h));
+  ASSERT_EQ(expected[15], h->docId);
+  ASSERT_EQ(INDEXREAD_NOTFOUND, ui->SkipTo(ui->ctx, 1001, &h));
+  ASSERT_EQ(1002, h->docId);
+  ASSERT_EQ(INDEXREAD_OK, ui->SkipTo(ui->ctx, 1005, &h));
+  ASSERT_EQ(1005, h->docId);
+  auto rest = readAllBatches(ui, 256);
+  ASSERT_EQ(std::vector<t_docId>(expectedSet.upper_bound(1005), expectedSet.end()), rest);
+  ASSERT_EQ(INDEXREAD_EOF, ui->Read(ui->ctx, &h));
+
+  // Rewinding goes back to merging the children
+  ui->Rewind(ui->ctx);
+  std::vector<t_docId> ids;
+  while (ui->Read(ui->ctx, &h) == INDEXREAD_OK) {
+    ids.push_back(h->docId);
+  }
+  ASSERT_EQ(expected, ids);
+  ui->Rewind(ui->ctx);
+  ASSERT_EQ(expected, readAllBatches(ui, 64));
+
+  ui->Free(ui);
+  for (int i = 0; i < 3; i++) InvertedIndex_Free(idxs[i]);
+}
@@ -360,3 +360,49 @@ TEST_F(IntersectionIteratorTest, SlopAndOrder) {
     ASSERT_EQ(ii_base->lastDocId, 1); // Last docId should remain unchanged
     ASSERT_TRUE(ii_base->atEOF); // atEOF should remain true
 }
+
+TEST(IntersectionIteratorBitmapTest, BitmapBlocks) {
+    // Doc-id only indexes, dense enough to be stored as bitmap blocks, with a sparse tail
+    const t_docId N = 100000;
+    size_t dummy;
+    InvertedIndex *idx2 = NewInvertedIndex(Index_DocIdsOnly, 1, &dummy);
+    InvertedIndex *idx3 = NewInvertedIndex(Index_DocIdsOnly, 1, &dummy);
+    IndexEncoder enc = InvertedIndex_GetEncoder(Index_DocIdsOnly);
+    std::vector<t_docId> expected;
+    for (t_docId id = 1; id <= N; id++) {
+        RSIndexResult rec = {};
+        rec.docId = id;
+        bool in2 = id % 2 == 0 && (id < N / 2 || id % 1000 == 0);
+        bool in3 = id % 3 == 0 && (id < N / 2 || id % 1000 == 0);
+        if (in2) InvertedIndex_WriteEntryGeneric(idx2, enc, id, &rec);
+        if (in3) InvertedIndex_WriteEntryGeneric(idx3, enc, id, &rec);
+        if (in2 && in3) expected.push_back(id);
+    }
+    ASSERT_TRUE(IndexBlock_IsBitmap(&idx2->blocks[0]));
+    ASSERT_TRUE(IndexBlock_IsBitmap(&idx3->blocks[0]));
+    ASSERT_FALSE(IndexBlock_IsBitmap(&idx3->blocks[idx3->size - 1]));
+
+    QueryIterator **children = (QueryIterator **)rm_malloc(sizeof(QueryIterator *) * 2);
+    children[0] = NewInvIndIterator_TermFull(idx2);
+    children[1] = NewInvIndIterator_TermFull(idx3);
+    QueryIterator *ii_base = NewIntersectionIterator(children, 2, -1, false, 1.0);
+
+    for (t_docId id : expected) {
+        ASSERT_EQ(ii_base->Read(ii_base), ITERATOR_OK);
+        ASSERT_EQ(ii_base->lastDocId, id);
+    }
+    ASSERT_EQ(ii_base->Read(ii_base), ITERATOR_EOF);
+
+    ii_base->Rewind(ii_base);
+    ASSERT_EQ(ii_base->SkipTo(ii_base, 1001), ITERATOR_NOTFOUND);
+    ASSERT_EQ(ii_base->lastDocId, 1002);
+    ASSERT_EQ(ii_base->SkipTo(ii_base, 1008), ITERATOR_OK);
+    ASSERT_EQ(ii_base->lastDocId, 1008);
+    ASSERT_EQ(ii_base->SkipTo(ii_base, N / 2), ITERATOR_NOTFOUND);
+    ASSERT_EQ(ii_base->lastDocId, 51000);
+    ASSERT_EQ(ii_base->SkipTo(ii_base, N + 1), ITERATOR_EOF);
+
+    ii_base->Free(ii_base);
+    InvertedIndex_Free(idx2);
+    InvertedIndex_Free(idx3);
+}
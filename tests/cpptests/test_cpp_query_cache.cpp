@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+
+#include "gtest/gtest.h"
+#include "src/query_cache.h"
+#include "src/rmalloc.h"
+
+#include <string>
+#include <cstring>
+
+class QueryCacheTest : public ::testing::Test {};
+
+static arrayof(char) makeReply(const std::string &s) {
+  arrayof(char) reply = array_new(char, s.size());
+  reply = array_grow(reply, s.size());
+  memcpy(reply, s.data(), s.size());
+  return reply;
+}
+
+static std::string get(QueryCache *qc, const std::string &key, uint64_t revision) {
+  size_t len;
+  char *reply = QueryCache_Get(qc, key.data(), key.size(), revision, &len);
+  if (!reply) {
+    return "<miss>";
+  }
+  std::string ret(reply, len);
+  rm_free(reply);
+  return ret;
+}
+
+TEST_F(QueryCacheTest, testRevision) {
+  QueryCache *qc = QueryCache_New();
+  // Keys are binary safe
+  std::string key("a\0b", 3), other("a\0c", 3);
+
+  QueryCache_Put(qc, key.data(), key.size(), 1, makeReply("reply1"), 1 << 20);
+  ASSERT_EQ(get(qc, key, 1), "reply1");
+  ASSERT_EQ(get(qc, other, 1), "<miss>");
+
+  // The entry is dropped once the index changed
+  ASSERT_EQ(get(qc, key, 2), "<miss>");
+  ASSERT_EQ(get(qc, key, 1), "<miss>");
+
+  QueryCache_Put(qc, key.data(), key.size(), 2, makeReply("reply2"), 1 << 20);
+  QueryCache_Put(qc, key.data(), key.size(), 2, makeReply("reply3"), 1 << 20);
+  ASSERT_EQ(get(qc, key, 2), "reply3");
+
+  QueryCache_Clear(qc);
+  ASSERT_EQ(get(qc, key, 2), "<miss>");
+  QueryCache_Free(qc);
+}
+
+TEST_F(QueryCacheTest, testEviction) {
+  QueryCache *qc = QueryCache_New();
+  std::string big(1000, 'x');
+  const size_t maxMemory = 3000;
+
+  // A reply larger than the cache is not stored
+  QueryCache_Put(qc, "k", 1, 1, makeReply(std::string(maxMemory, 'x')), maxMemory);
+  ASSERT_EQ(get(qc, "k", 1), "<miss>");
+
+  QueryCache_Put(qc, "a", 1, 1, makeReply(big), maxMemory);
+  QueryCache_Put(qc, "b", 1, 1, makeReply(big), maxMemory);
+  // Use `a`, so `b` is the least recently used
+  ASSERT_EQ(get(qc, "a", 1), big);
+  QueryCache_Put(qc, "c", 1, 1, makeReply(big), maxMemory);
+
+  ASSERT_EQ(get(qc, "a", 1), big);
+  ASSERT_EQ(get(qc, "b", 1), "<miss>");
+  ASSERT_EQ(get(qc, "c", 1), big);
+  QueryCache_Free(qc);
+}
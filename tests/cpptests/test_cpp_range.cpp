@@ -231,6 +231,125 @@ TEST_F(RangeTest, testRangeIteratorMulti) {
   testRangeIteratorHelper(true);
 }
 
+TEST_F(RangeTest, testValueSortedLeaf) {
+  NumericRangeTree *t = NewNumericRangeTree();
+  const size_t N = 5000;
+  // Few distinct values, so everything stays in the root leaf
+  auto valueOf = [](t_docId docId) { return (double)(1 + (docId * 7) % 10); };
+  for (t_docId docId = 1; docId <= N; docId++) {
+    NumericRangeTree_Add(t, docId, valueOf(docId), false);
+  }
+  // A multi value document, matching the filter with both values
+  NumericRangeTree_Add(t, N + 1, 4, true);
+  NumericRangeTree_Add(t, N + 1, 4.5, true);
+  ASSERT_EQ(t->numRanges, 1);
+  NumericRange *range = t->root->range;
+  ASSERT_EQ(range->byValue, nullptr);
+
+  IteratorsConfig config{};
+  iteratorsConfig_init(&config);
+  FieldFilterContext filterCtx = {.field = {.isFieldMask = false, .value = {.index = RS_INVALID_FIELD_INDEX}}, .predicate = FIELD_EXPIRATION_DEFAULT};
+
+  // A wide overlap is cheaper to decode in doc id order, and does not build the value ordered entries
+  NumericFilter *flt = NewNumericFilter(2, 9, 1, 1, true, NULL);
+  for (int i = 0; i < NR_BY_VALUE_MIN_QUERIES; i++) {
+    IndexIterator *it = createNumericIterator(NULL, t, flt, &config, &filterCtx);
+    ASSERT_EQ(it->type, READ_ITERATOR);
+    ASSERT_EQ(((IndexReader *)it->ctx)->idx, range->entries);
+    it->Free(it);
+  }
+  ASSERT_EQ(range->byValue, nullptr);
+  NumericFilter_Free(flt);
+
+  // The value ordered entries are not built for a range that is written to between queries
+  flt = NewNumericFilter(3, 4.5, 0, 1, true, NULL);
+  for (int i = 0; i < 2 * NR_BY_VALUE_MIN_QUERIES; i++) {
+    IndexIterator *it = createNumericIterator(NULL, t, flt, &config, &filterCtx);
+    ASSERT_EQ(it->type, READ_ITERATOR);
+    ASSERT_EQ(((IndexReader *)it->ctx)->idx, range->entries);
+    it->Free(it);
+    // Outside of the filter
+    NumericRangeTree_Add(t, N + 2 + i, 5, false);
+  }
+  ASSERT_EQ(range->byValue, nullptr);
+
+  // Once the range settles, a selective partial overlap is answered from the value ordered entries
+  for (int i = 1; i < NR_BY_VALUE_MIN_QUERIES; i++) {
+    IndexIterator *it = createNumericIterator(NULL, t, flt, &config, &filterCtx);
+    ASSERT_EQ(it->type, READ_ITERATOR);
+    ASSERT_EQ(((IndexReader *)it->ctx)->idx, range->entries);
+    it->Free(it);
+  }
+  ASSERT_EQ(range->byValue, nullptr);
+
+  // Unless the copies' memory limit leaves no room for the range's copy
+  size_t byValueSize = NumericRangeByValue_Size(range->entries->numEntries);
+  size_t byValueMemory = NumericRangeByValue_Memory();
+  size_t maxMemory = NumericRangeByValue_MaxMemory;
+  NumericRangeByValue_MaxMemory = byValueMemory + byValueSize - 1;
+  IndexIterator *it = createNumericIterator(NULL, t, flt, &config, &filterCtx);
+  ASSERT_EQ(((IndexReader *)it->ctx)->idx, range->entries);
+  it->Free(it);
+  ASSERT_EQ(range->byValue, nullptr);
+  ASSERT_EQ(NumericRangeByValue_Memory(), byValueMemory);
+  NumericRangeByValue_MaxMemory = maxMemory;
+
+  size_t rangeSize = range->invertedIndexSize, treeSize = t->invertedIndexesSize;
+  it = createNumericIterator(NULL, t, flt, &config, &filterCtx);
+  // A plain numeric reader, over a private index of the matching entries
+  ASSERT_EQ(it->type, READ_ITERATOR);
+  ASSERT_NE(((IndexReader *)it->ctx)->idx, range->entries);
+  ASSERT_NE(range->byValue, nullptr);
+
+  // Its memory is accounted for
+  ASSERT_EQ(range->byValue->len, range->entries->numEntries);
+  ASSERT_EQ(range->invertedIndexSize, rangeSize + byValueSize);
+  ASSERT_EQ(t->invertedIndexesSize, treeSize + byValueSize);
+  ASSERT_EQ(NumericRangeByValue_Memory(), byValueMemory + byValueSize);
+  NumericRangeNode *failed_range = NULL;
+  ASSERT_EQ(CalculateNumericInvertedIndexMemory(t, &failed_range), t->invertedIndexesSize);
+  ASSERT_EQ(failed_range, nullptr);
+
+  std::vector<t_docId> expected;
+  for (t_docId docId = 1; docId <= N; docId++) {
+    if (NumericFilter_Match(flt, valueOf(docId))) expected.push_back(docId);
+  }
+  expected.push_back(N + 1);
+  ASSERT_EQ(it->NumEstimated(it->ctx), expected.size());
+
+  RSIndexResult *res = NULL;
+  std::vector<t_docId> got;
+  while (it->Read(it->ctx, &res) == INDEXREAD_OK) {
+    ASSERT_EQ(res->type, RSResultType_Numeric);
+    ASSERT_TRUE(NumericFilter_Match(flt, res->data.num.value));
+    got.push_back(res->docId);
+  }
+  ASSERT_EQ(got, expected);
+
+  it->Rewind(it->ctx);
+  ASSERT_EQ(it->SkipTo(it->ctx, expected[10], &res), INDEXREAD_OK);
+  ASSERT_EQ(res->docId, expected[10]);
+  ASSERT_EQ(it->SkipTo(it->ctx, expected[20] - 1, &res), INDEXREAD_NOTFOUND);
+  ASSERT_EQ(res->docId, expected[20]);
+  ASSERT_EQ(it->SkipTo(it->ctx, N + 2, &res), INDEXREAD_EOF);
+  it->Free(it);
+  NumericFilter_Free(flt);
+
+  // Changing the range drops the value ordered entries, and gives their memory back
+  rangeSize = range->invertedIndexSize;
+  treeSize = t->invertedIndexesSize;
+  NRN_AddRv rv = NumericRangeTree_Add(t, N + 3 * NR_BY_VALUE_MIN_QUERIES, 4, false);
+  ASSERT_EQ(range->byValue, nullptr);
+  ASSERT_EQ(NumericRangeByValue_Memory(), byValueMemory);
+  ASSERT_LT(range->invertedIndexSize, rangeSize);
+  ASSERT_EQ(rv.sz, (int)range->invertedIndexSize - (int)rangeSize);
+  ASSERT_EQ(t->invertedIndexesSize, treeSize + rv.sz);
+  ASSERT_EQ(CalculateNumericInvertedIndexMemory(t, &failed_range), t->invertedIndexesSize);
+  ASSERT_EQ(failed_range, nullptr);
+
+  NumericRangeTree_Free(t);
+}
+
 /** Currently, a new tree always initialized with a single range node (root).
  * A range node contains an inverted index struct and at least one block with initial block capacity.
  */
@@ -12,6 +12,9 @@
 #include "query.h"
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <vector>
+
 struct processor1Ctx : public ResultProcessor {
   processor1Ctx() {
     memset(static_cast<ResultProcessor *>(this), 0, sizeof(ResultProcessor));
@@ -88,3 +91,116 @@ TEST_F(ResultProcessorTest, testProcessorChain) {
   ASSERT_EQ(2, numFreed);
   RLookup_Cleanup(&lk);
 }
+
+#define NUM_SORTED_RESULTS 100
+
+static RLookupKey *sortNumKey, *sortStrKey;
+
+// Writes `n` = (docId * 37) % 10 and `s` = docId as a string, leaving `n` out on every 7th result
+static int sortInput_Next(ResultProcessor *rp, SearchResult *res) {
+  processor1Ctx *p = static_cast<processor1Ctx *>(rp);
+  if (p->counter >= NUM_SORTED_RESULTS) return RS_RESULT_EOF;
+
+  res->docId = ++p->counter;
+  if (res->docId % 7) {
+    RLookup_WriteOwnKey(sortNumKey, &res->rowdata, RS_NumVal((res->docId * 37) % 10));
+  }
+  char buf[16];
+  snprintf(buf, sizeof(buf), "%03lu", (unsigned long)res->docId);
+  RLookup_WriteOwnKey(sortStrKey, &res->rowdata, RS_NewCopiedString(buf, strlen(buf)));
+  return RS_RESULT_OK;
+}
+
+TEST_F(ResultProcessorTest, testSorterByFields) {
+  QueryIterator qitr = {0};
+  RLookup lk = {0};
+  processor1Ctx *p = new processor1Ctx();
+  p->Next = sortInput_Next;
+  p->Free = resultProcessor_GenericFree;
+  RLookupKey *nkey = sortNumKey = RLookup_GetKey_Write(&lk, "n", RLOOKUP_F_NOFLAGS);
+  sortStrKey = RLookup_GetKey_Write(&lk, "s", RLOOKUP_F_NOFLAGS);
+  QITR_PushRP(&qitr, p);
+
+  // Sort by `n` descending, then by `s` ascending
+  const RLookupKey *keys[] = {nkey, sortStrKey};
+  const size_t limit = 20;
+  ResultProcessor *sorter = RPSorter_NewByFields(limit, keys, 2, SORTASCMAP_INIT & ~1LLU);
+  QITR_PushRP(&qitr, sorter);
+
+  std::vector<std::pair<double, t_docId>> expected;
+  for (t_docId id = 1; id <= NUM_SORTED_RESULTS; id++) {
+    if (id % 7) {
+      expected.push_back({(double)((id * 37) % 10), id});
+    }
+  }
+  std::sort(expected.begin(), expected.end(), [](auto &a, auto &b) {
+    return a.first != b.first ? a.first > b.first : a.second < b.second;
+  });
+
+  size_t count = 0;
+  SearchResult r = {0};
+  while (sorter->Next(sorter, &r) == RS_RESULT_OK) {
+    ASSERT_LT(count, limit);
+    ASSERT_EQ(expected[count].second, r.docId);
+    RSValue *v = RLookup_GetItem(nkey, &r.rowdata);
+    ASSERT_EQ(expected[count].first, v->numval);
+    count++;
+    SearchResult_Clear(&r);
+  }
+  ASSERT_EQ(limit, count);
+  // The keys do not come from the sorting vector, so there is nothing to publish
+  ASSERT_FALSE(qitr.sortThreshold.active);
+  SearchResult_Destroy(&r);
+
+  QITR_FreeChain(&qitr);
+  RLookup_Cleanup(&lk);
+}
+
+// Writes `n` = (docId * 37) % 100, which is a permutation of 0..99
+static int thresholdInput_Next(ResultProcessor *rp, SearchResult *res) {
+  processor1Ctx *p = static_cast<processor1Ctx *>(rp);
+  if (p->counter >= NUM_SORTED_RESULTS) return RS_RESULT_EOF;
+
+  res->docId = ++p->counter;
+  RLookup_WriteOwnKey(sortNumKey, &res->rowdata, RS_NumVal((res->docId * 37) % 100));
+  return RS_RESULT_OK;
+}
+
+TEST_F(ResultProcessorTest, testSorterThreshold) {
+  QueryIterator qitr = {0};
+  RLookup lk = {0};
+  processor1Ctx *p = new processor1Ctx();
+  p->Next = thresholdInput_Next;
+  p->Free = resultProcessor_GenericFree;
+  p->type = RP_INDEX;
+  RLookupKey *nkey = sortNumKey = RLookup_GetKey_Write(&lk, "n", RLOOKUP_F_NOFLAGS);
+  // Pretend the key is a sortable field
+  nkey->flags |= RLOOKUP_F_SVSRC;
+  nkey->svidx = 3;
+  QITR_PushRP(&qitr, p);
+
+  const RLookupKey *keys[] = {nkey};
+  const size_t limit = 10;
+  ResultProcessor *sorter = RPSorter_NewByFields(limit, keys, 1, SORTASCMAP_INIT);
+  QITR_PushRP(&qitr, sorter);
+
+  size_t count = 0;
+  SearchResult r = {0};
+  while (sorter->Next(sorter, &r) == RS_RESULT_OK) {
+    RSValue *v = RLookup_GetItem(nkey, &r.rowdata);
+    ASSERT_EQ(count, v->numval);
+    count++;
+    SearchResult_Clear(&r);
+  }
+  ASSERT_EQ(limit, count);
+  SearchResult_Destroy(&r);
+
+  // The worst value the sorter kept is the bound for the root processor
+  ASSERT_TRUE(qitr.sortThreshold.active);
+  ASSERT_TRUE(qitr.sortThreshold.ascending);
+  ASSERT_EQ(3, qitr.sortThreshold.svidx);
+  ASSERT_EQ(limit - 1, qitr.sortThreshold.value);
+
+  QITR_FreeChain(&qitr);
+  RLookup_Cleanup(&lk);
+}
@@ -16,6 +16,18 @@
 
 class TagIndexTest : public ::testing::Test {};
 
+// The memory held by the inverted index of a tag value: the index structure and its blocks
+static size_t tagIndexMemory(TagIndex *idx, const char *value) {
+  size_t sz;
+  InvertedIndex *iv = TagIndex_OpenIndex(idx, value, strlen(value), 0, &sz);
+  size_t mem = sizeof_InvertedIndex(Index_DocIdsOnly);
+  for (uint32_t i = 0; i < iv->size; i++) {
+    const IndexBlock *blk = iv->blocks + i;
+    mem += sizeof(IndexBlock) + IndexBlock_DataCap(blk);
+  }
+  return mem;
+}
+
 TEST_F(TagIndexTest, testCreate) {
   TagIndex *idx = NewTagIndex();
   ASSERT_FALSE(idx == NULL);
@@ -38,16 +50,12 @@ TEST_F(TagIndexTest, testCreate) {
   ASSERT_EQ(v.size(), TrieMap_NUniqueKeys(idx->values));
 
   // expectedTotalSZ should include the memory occupied by the inverted index
-  // structure and its blocks.
-
-  // Buffer grows up to 1077 bytes trying to store 1000 bytes. See Buffer_Grow()
-  size_t buffer_cap = 1077;
-  size_t num_blocks = N / INDEX_BLOCK_SIZE_DOCID_ONLY;
-
-  // The size of the inverted index structure is 32 bytes
-  size_t iv_index_size = sizeof_InvertedIndex(Index_DocIdsOnly);
-
-  size_t expectedTotalSZ = v.size() * (iv_index_size + ((buffer_cap + sizeof(IndexBlock)) * num_blocks));
+  // structure and its blocks. The blocks of dense ids are bitmaps, sized by the ids they took,
+  // so their sizes are summed up (see testSparseIdsMemory for the fixed layout of delta blocks)
+  size_t expectedTotalSZ = 0;
+  for (auto s : v) {
+    expectedTotalSZ += tagIndexMemory(idx, s);
+  }
   ASSERT_EQ(expectedTotalSZ, totalSZ);
 
   // Add a new entry to and check the last block size
@@ -78,6 +86,97 @@ TEST_F(TagIndexTest, testCreate) {
   TagIndex_Free(idx);
 }
 
+TEST_F(TagIndexTest, testSparseIdsMemory) {
+  TagIndex *idx = NewTagIndex();
+  // Stay below the number of documents at which the block size grows
+  const size_t N = INDEX_BLOCK_SIZE_DOCID_ONLY * INDEX_BLOCK_GROWTH_THRESHOLD / 2;
+  std::vector<const char *> v{"hello", "world", "foo"};
+  size_t totalSZ = 0;
+  // Sparse ids, so the blocks are not turned into bitmaps
+  const t_docId step = 10;
+  for (t_docId d = step; d <= N * step; d += step) {
+    totalSZ += TagIndex_Index(idx, &v[0], v.size(), d);
+  }
+
+  // Buffer grows up to 1077 bytes trying to store 1000 bytes. See Buffer_Grow()
+  size_t buffer_cap = 1077;
+  size_t num_blocks = N / INDEX_BLOCK_SIZE_DOCID_ONLY;
+  size_t iv_index_size = sizeof_InvertedIndex(Index_DocIdsOnly);
+  size_t expectedTotalSZ = v.size() * (iv_index_size + ((buffer_cap + sizeof(IndexBlock)) * num_blocks));
+  ASSERT_EQ(expectedTotalSZ, totalSZ);
+
+  IndexIterator *it = TagIndex_OpenReader(idx, NULL, "hello", 5, 1, RS_INVALID_FIELD_INDEX);
+  RSIndexResult *r;
+  t_docId n = step;
+  while (INDEXREAD_EOF != it->Read(it->ctx, &r)) {
+    ASSERT_EQ(n, r->docId);
+    n += step;
+  }
+  ASSERT_EQ((N + 1) * step, n);
+  it->Free(it);
+  TagIndex_Free(idx);
+}
+
+TEST_F(TagIndexTest, testBlockGrowth) {
+  TagIndex *idx = NewTagIndex();
+  const size_t N = INDEX_BLOCK_SIZE_DOCID_ONLY * INDEX_BLOCK_GROWTH_THRESHOLD * 4;
+  std::vector<const char *> v{"hello"};
+  size_t totalSZ = 0;
+  const t_docId step = 10;
+  for (t_docId d = step; d <= N * step; d += step) {
+    totalSZ += TagIndex_Index(idx, &v[0], v.size(), d);
+  }
+  ASSERT_EQ(tagIndexMemory(idx, "hello"), totalSZ);
+
+  // The blocks grow with the index, so it takes fewer of them than with a fixed block size
+  size_t sz;
+  InvertedIndex *iv = TagIndex_OpenIndex(idx, "hello", 5, 0, &sz);
+  ASSERT_LT(iv->size, N / INDEX_BLOCK_SIZE_DOCID_ONLY);
+  ASSERT_EQ(INDEX_BLOCK_SIZE_DOCID_ONLY, iv->blocks[0].numEntries);
+  for (uint32_t i = 1; i < iv->size; i++) {
+    ASSERT_FALSE(IndexBlock_IsBitmap(&iv->blocks[i]));
+    ASSERT_GE(iv->blocks[i].capacity, iv->blocks[i - 1].capacity);
+  }
+  ASSERT_GT(iv->blocks[iv->size - 1].capacity, INDEX_BLOCK_SIZE_DOCID_ONLY);
+
+  IndexIterator *it = TagIndex_OpenReader(idx, NULL, "hello", 5, 1, RS_INVALID_FIELD_INDEX);
+  RSIndexResult *r;
+  t_docId n = step;
+  while (INDEXREAD_EOF != it->Read(it->ctx, &r)) {
+    ASSERT_EQ(n, r->docId);
+    n += step;
+  }
+  ASSERT_EQ((N + 1) * step, n);
+  it->Free(it);
+  TagIndex_Free(idx);
+}
+
+TEST_F(TagIndexTest, testDenseIdsBitmap) {
+  TagIndex *idx = NewTagIndex();
+  const size_t N = 100000;
+  std::vector<const char *> v{"hello"};
+  for (t_docId d = 1; d <= N; d++) {
+    TagIndex_Index(idx, &v[0], v.size(), d);
+  }
+
+  // A full block of dense ids turns into a bitmap, which keeps taking ids well past the block size
+  size_t sz;
+  InvertedIndex *iv = TagIndex_OpenIndex(idx, "hello", 5, 0, &sz);
+  ASSERT_TRUE(IndexBlock_IsBitmap(&iv->blocks[0]));
+  ASSERT_GT(iv->blocks[0].numEntries, INDEX_BLOCK_SIZE_DOCID_ONLY);
+  ASSERT_LE(IndexBlock_DataLen(&iv->blocks[0]), iv->blocks[0].numEntries / 8 + 8);
+  ASSERT_LT(iv->size, N / INDEX_BLOCK_SIZE_DOCID_ONLY);
+
+  IndexIterator *it = TagIndex_OpenReader(idx, NULL, "hello", 5, 1, RS_INVALID_FIELD_INDEX);
+  RSIndexResult *r;
+  ASSERT_EQ(INDEXREAD_OK, it->SkipTo(it->ctx, N / 2, &r));
+  ASSERT_EQ(N / 2, r->docId);
+  ASSERT_EQ(INDEXREAD_OK, it->Read(it->ctx, &r));
+  ASSERT_EQ(N / 2 + 1, r->docId);
+  it->Free(it);
+  TagIndex_Free(idx);
+}
+
 TEST_F(TagIndexTest, testSkipToLastId) {
   TagIndex *idx = NewTagIndex();
   ASSERT_FALSE(idx == NULL);
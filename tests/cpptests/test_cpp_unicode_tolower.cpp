@@ -63,6 +63,23 @@ TEST_F(UnicodeToLowerTest, testUnicodeCharacters) {
   ASSERT_STREQ(russian, "привет мир");
 }
 
+TEST_F(UnicodeToLowerTest, testAsciiPrefix) {
+  // The ASCII prefix is converted by the fast path, the rest by the unicode conversion
+  char str[] = "HELLO ÄÖÜ World";
+  size_t newLen = strlen(str);
+  char *dst = unicode_tolower(str, &newLen);
+  ASSERT_EQ(dst, nullptr);
+  ASSERT_EQ(newLen, strlen("hello äöü world"));
+  ASSERT_STREQ(str, "hello äöü world");
+
+  char upper[] = "MIXED Case 123";
+  newLen = strlen(upper);
+  dst = unicode_tolower(upper, &newLen);
+  ASSERT_EQ(dst, nullptr);
+  ASSERT_EQ(newLen, strlen(upper));
+  ASSERT_STREQ(upper, "mixed case 123");
+}
+
 TEST_F(UnicodeToLowerTest, testEmptyAndSpecialCases) {
   // Test with empty string
   char empty[] = "";
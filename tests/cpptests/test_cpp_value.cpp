@@ -11,6 +11,8 @@
 
 #include "value.h"
 
+#include <vector>
+
 class ValueTest : public ::testing::Test {};
 
 TEST_F(ValueTest, testBasic) {
@@ -96,4 +98,25 @@ TEST_F(ValueTest, testNumericFormat) {
   RSValue_SetNumber(v, 1581011976800);
   ASSERT_STREQ("1581011976800", toString(v).c_str());
   RSValue_Decref(v);
-}
\ No newline at end of file
+}
+TEST_F(ValueTest, testPoolKeepsChunk) {
+  // A chunk of 1000 rows with a few fields each releases all of its values at once. The thread's
+  // pool keeps them all, so the next chunk gets the same values back, most recently released
+  // first, instead of going back to the allocator
+  const size_t numRows = 1000, numFields = 8, n = numRows * numFields;
+  std::vector<RSValue *> released(n);
+  for (size_t i = 0; i < n; i++) {
+    released[i] = RS_NumVal(i);
+  }
+  for (size_t i = 0; i < n; i++) {
+    RSValue_Decref(released[i]);
+  }
+  std::vector<RSValue *> reused(n);
+  for (size_t i = 0; i < n; i++) {
+    reused[i] = RS_NumVal(i);
+    ASSERT_EQ(released[n - 1 - i], reused[i]) << "value " << i;
+  }
+  for (size_t i = 0; i < n; i++) {
+    RSValue_Decref(reused[i]);
+  }
+}
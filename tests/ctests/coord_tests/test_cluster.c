@@ -163,6 +163,86 @@ void testClusterSharding() {
   MRClust_Free(cl);
 }
 
+static MRConn *getNodeConn(MRConnManager *mgr, const char *id, size_t i) {
+  MRConnPool *pool = dictGetVal(dictFind(mgr->map, id));
+  return pool->conns[i];
+}
+
+static void setConn(MRConn *conn, MRConnState state, size_t pending, double latency) {
+  conn->state = state;
+  conn->pending = pending;
+  conn->latency = latency;
+}
+
+void testNodeCost() {
+  const char *hosts[] = {"localhost:6379", "localhost:6389"};
+  MRClusterTopology *topo = getTopology(4096, 2, hosts);
+  MRCluster *cl = MR_NewCluster(topo, 2);
+  MRConnManager *mgr = &cl->mgr;
+  MRConn *c0 = getNodeConn(mgr, hosts[0], 0), *c1 = getNodeConn(mgr, hosts[0], 1);
+
+  // Unknown nodes and nodes with no connected connection have no cost
+  mu_check(MRConnManager_NodeCost(mgr, "localhost:1") < 0);
+  mu_check(MRConnManager_NodeCost(mgr, hosts[0]) < 0);
+
+  // A node with no latency samples is ranked by its queue depth alone
+  setConn(c0, MRConn_Connected, 0, 0);
+  mu_assert_double_eq(1, MRConnManager_NodeCost(mgr, hosts[0]));
+  setConn(c0, MRConn_Connected, 3, 0);
+  mu_assert_double_eq(4, MRConnManager_NodeCost(mgr, hosts[0]));
+
+  // The in-flight commands of all the connected connections, times their average latency
+  setConn(c0, MRConn_Connected, 3, 500);
+  mu_assert_double_eq(2000, MRConnManager_NodeCost(mgr, hosts[0]));
+  setConn(c1, MRConn_Connected, 1, 100);
+  mu_assert_double_eq(1500, MRConnManager_NodeCost(mgr, hosts[0]));
+
+  // Connections that are not connected are ignored
+  setConn(c1, MRConn_Connecting, 10, 1000);
+  mu_assert_double_eq(2000, MRConnManager_NodeCost(mgr, hosts[0]));
+
+  MRClust_Free(cl);
+}
+
+MRClusterNode *_MRClusterShard_SelectNode(MRClusterShard *sh, MRConnManager *mgr, bool mastersOnly);
+
+void testSelectNode() {
+  const char *hosts[] = {"localhost:6379", "localhost:6389"};
+  MRClusterTopology *topo = getTopology(4096, 2, hosts);
+  MRCluster *cl = MR_NewCluster(topo, 1);
+  MRConnManager *mgr = &cl->mgr;
+
+  // A shard with the two nodes, the second of which is a replica
+  MRClusterNode nodes[] = {topo->shards[0].nodes[0], topo->shards[1].nodes[0]};
+  nodes[1].flags = 0;
+  MRClusterShard sh = {.numNodes = 2, .capNodes = 2, .nodes = nodes};
+  MRConn *c0 = getNodeConn(mgr, hosts[0], 0), *c1 = getNodeConn(mgr, hosts[1], 0);
+
+  // Only the master, whatever its cost
+  setConn(c0, MRConn_Connected, 100, 1000);
+  setConn(c1, MRConn_Connected, 0, 1);
+  for (int i = 0; i < 10; i++) {
+    mu_check(_MRClusterShard_SelectNode(&sh, mgr, true) == &nodes[0]);
+  }
+
+  // Both nodes are sampled, and the cheaper one is selected
+  for (int i = 0; i < 10; i++) {
+    mu_check(_MRClusterShard_SelectNode(&sh, mgr, false) == &nodes[1]);
+  }
+  setConn(c1, MRConn_Connected, 200, 1000);
+  for (int i = 0; i < 10; i++) {
+    mu_check(_MRClusterShard_SelectNode(&sh, mgr, false) == &nodes[0]);
+  }
+
+  // A node with no connected connection is avoided
+  setConn(c0, MRConn_Disconnected, 0, 0);
+  for (int i = 0; i < 10; i++) {
+    mu_check(_MRClusterShard_SelectNode(&sh, mgr, false) == &nodes[1]);
+  }
+
+  MRClust_Free(cl);
+}
+
 static void dummyLog(RedisModuleCtx *ctx, const char *level, const char *fmt, ...) {}
 
 int main(int argc, char **argv) {
@@ -172,6 +252,8 @@ int main(int argc, char **argv) {
   MU_RUN_TEST(testShardingFunc);
   MU_RUN_TEST(testCluster);
   MU_RUN_TEST(testClusterSharding);
+  MU_RUN_TEST(testNodeCost);
+  MU_RUN_TEST(testSelectNode);
   MU_REPORT();
 
   return minunit_status;
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+#include "minunit.h"
+#include "rq.h"
+#include "rmalloc.h"
+#include "rmutil/alloc.h"
+#include "redismodule.h"
+
+#include <stdint.h>
+
+#define NUM_REQUESTS 10
+
+static int ran[NUM_REQUESTS];
+static int numRan;
+
+// The queues are created before the first push starts the event loop thread, which never runs their
+// requests, as no topology is applied
+static MRWorkQueue *orderQ, *limitQ;
+
+static void recordCb(void *privdata) {
+  ran[numRan++] = (int)(intptr_t)privdata;
+}
+
+static void pushRequests(MRWorkQueue *q) {
+  numRan = 0;
+  for (int i = 0; i < NUM_REQUESTS; i++) {
+    RQ_Push(q, recordCb, (void *)(intptr_t)i);
+  }
+}
+
+void testBatchOrder() {
+  MRWorkQueue *q = orderQ;
+  pushRequests(q);
+
+  // All the requests fit in a single batch, in the order they were pushed
+  mu_assert_int_eq(NUM_REQUESTS, RQ_Debug_RunBatch(q));
+  mu_assert_int_eq(NUM_REQUESTS, numRan);
+  for (int i = 0; i < NUM_REQUESTS; i++) {
+    mu_assert_int_eq(i, ran[i]);
+  }
+  mu_assert_int_eq(0, RQ_Debug_RunBatch(q));
+
+  for (int i = 0; i < NUM_REQUESTS; i++) {
+    RQ_Done(q);
+  }
+}
+
+void testBatchLimit() {
+  MRWorkQueue *q = limitQ;
+  pushRequests(q);
+
+  // A batch takes no more requests than the pending limit allows
+  mu_assert_int_eq(3, RQ_Debug_RunBatch(q));
+  mu_assert_int_eq(0, RQ_Debug_RunBatch(q));
+
+  // Each completed request makes room for another one
+  RQ_Done(q);
+  mu_assert_int_eq(1, RQ_Debug_RunBatch(q));
+  mu_assert_int_eq(0, RQ_Debug_RunBatch(q));
+  RQ_Done(q);
+  RQ_Done(q);
+  mu_assert_int_eq(2, RQ_Debug_RunBatch(q));
+
+  // Raising the limit lets the rest through, up to what is queued
+  RQ_UpdateMaxPending(q, 100);
+  mu_assert_int_eq(4, RQ_Debug_RunBatch(q));
+  mu_assert_int_eq(0, RQ_Debug_RunBatch(q));
+
+  mu_assert_int_eq(NUM_REQUESTS, numRan);
+  for (int i = 0; i < NUM_REQUESTS; i++) {
+    mu_assert_int_eq(i, ran[i]);
+  }
+}
+
+static void dummyLog(RedisModuleCtx *ctx, const char *level, const char *fmt, ...) {}
+
+int main(int argc, char **argv) {
+  RMUTil_InitAlloc();
+  RedisModule_Log = dummyLog;
+  orderQ = RQ_New(100);
+  limitQ = RQ_New(3);
+  MU_RUN_TEST(testBatchOrder);
+  MU_RUN_TEST(testBatchLimit);
+  MU_REPORT();
+
+  return minunit_status;
+}
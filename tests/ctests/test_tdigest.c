@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2006-Present, Redis Ltd.
+ * All rights reserved.
+ *
+ * Licensed under your choice of the Redis Source Available License 2.0
+ * (RSALv2); or (b) the Server Side Public License v1 (SSPLv1); or (c) the
+ * GNU Affero General Public License v3 (AGPLv3).
+*/
+
+#include "src/util/tdigest.h"
+#include "rmutil/alloc.h"
+#include "rmalloc.h"
+#include "test_util.h"
+
+#include <math.h>
+
+#define NUM_VALUES 100000
+
+static int testExact() {
+  // Until the capacity is reached, the digest returns the value at the nearest rank
+  TDigest *td = NewTDigest(500);
+  ASSERT(isnan(TD_Query(td, 0.5)));
+  for (int i = 100; i >= 0; i--) {
+    TD_Add(td, i, 1);
+  }
+  ASSERT_EQUAL(101, TD_GetCount(td));
+  ASSERT_EQUAL(0, TD_Query(td, 0));
+  ASSERT_EQUAL(50, TD_Query(td, 0.5));
+  ASSERT_EQUAL(95, TD_Query(td, 0.95));
+  ASSERT_EQUAL(100, TD_Query(td, 1));
+  TD_Free(td);
+  return 0;
+}
+
+static int testAccuracy() {
+  TDigest *td = NewTDigest(500);
+  // Insert 0..NUM_VALUES-1 in a scattered order
+  for (size_t i = 0; i < NUM_VALUES; i++) {
+    TD_Add(td, (i * 7919) % NUM_VALUES, 1);
+  }
+  ASSERT_EQUAL(NUM_VALUES, TD_GetCount(td));
+  double qs[] = {0.001, 0.01, 0.25, 0.5, 0.75, 0.99, 0.999};
+  for (size_t i = 0; i < sizeof(qs) / sizeof(qs[0]); i++) {
+    double expected = qs[i] * NUM_VALUES;
+    // The error is relative to q * (1 - q), and is smaller at the tails
+    ASSERT(fabs(TD_Query(td, qs[i]) - expected) <= NUM_VALUES * 0.01);
+  }
+  ASSERT_EQUAL(0, TD_Query(td, 0));
+  ASSERT_EQUAL(NUM_VALUES - 1, TD_Query(td, 1));
+  TD_Free(td);
+  return 0;
+}
+
+static int testMerge() {
+  // Three shards, each with every third value
+  TDigest *merged = NewTDigest(500);
+  TDigest *exact = NewTDigest(500);
+  for (int shard = 0; shard < 3; shard++) {
+    TDigest *td = NewTDigest(500);
+    for (int i = shard; i < NUM_VALUES; i += 3) {
+      TD_Add(td, i, 1);
+    }
+    size_t len;
+    char *buf = TD_Serialize(td, &len);
+    ASSERT(TD_MergeSerialized(merged, buf, len));
+    rm_free(buf);
+    TD_Free(td);
+  }
+  ASSERT_EQUAL(NUM_VALUES, TD_GetCount(merged));
+  ASSERT_EQUAL(0, TD_Query(merged, 0));
+  ASSERT_EQUAL(NUM_VALUES - 1, TD_Query(merged, 1));
+  ASSERT(fabs(TD_Query(merged, 0.5) - NUM_VALUES / 2) <= NUM_VALUES * 0.01);
+
+  // Small shards are merged without loss
+  for (int shard = 0; shard < 3; shard++) {
+    TDigest *td = NewTDigest(500);
+    for (int i = shard; i < 101; i += 3) {
+      TD_Add(td, i, 1);
+    }
+    size_t len;
+    char *buf = TD_Serialize(td, &len);
+    ASSERT(TD_MergeSerialized(exact, buf, len));
+    rm_free(buf);
+    TD_Free(td);
+  }
+  ASSERT_EQUAL(95, TD_Query(exact, 0.95));
+  ASSERT_EQUAL(50, TD_Query(exact, 0.5));
+
+  // A buffer which is not a digest is rejected
+  ASSERT(!TD_MergeSerialized(exact, "foo", 3));
+  ASSERT_EQUAL(101, TD_GetCount(exact));
+
+  TD_Free(merged);
+  TD_Free(exact);
+  return 0;
+}
+
+TEST_MAIN({
+  RMUTil_InitAlloc();
+  TESTFUNC(testExact);
+  TESTFUNC(testAccuracy);
+  TESTFUNC(testMerge);
+})
@@ -750,6 +750,100 @@ def testDefaultValues(env: Env):
     env.expect(*query('TOLIST', 1, '@missing')).equal([1, ['res', []]])
 
 
+def testDistributedReducersExact(env: Env):
+    env.expect('FT.CREATE', 'idx', 'SCHEMA', 'g', 'TAG', 'n', 'NUMERIC', 'SORTABLE', 't', 'TAG').ok()
+    values = [1.5, 2, 7, 7, 11.25, 30, 42, 42, 100, 3.75]
+    with env.getClusterConnectionIfNeeded() as con:
+        for i, v in enumerate(values):
+            con.execute_command('HSET', f'doc{i}', 'g', 'a', 'n', v, 't', f'tag{i % 4}')
+
+    mean = sum(values) / len(values)
+    stddev = math.sqrt(sum((v - mean) ** 2 for v in values) / (len(values) - 1))
+
+    res = env.cmd('FT.AGGREGATE', 'idx', '*', 'GROUPBY', '1', '@g',
+                  'REDUCE', 'STDDEV', '1', '@n', 'AS', 'stddev',
+                  'REDUCE', 'COUNT_DISTINCT', '1', '@n', 'AS', 'distinct',
+                  'REDUCE', 'COUNT_DISTINCT', '1', '@t', 'AS', 'distinct_tags',
+                  'REDUCE', 'FIRST_VALUE', '4', '@t', 'BY', '@n', 'DESC', 'AS', 'top',
+                  'REDUCE', 'FIRST_VALUE', '3', '@n', 'BY', '@n', 'AS', 'bottom')
+    row = to_dict(res[1])
+    env.assertAlmostEqual(stddev, float(row['stddev']), delta=1e-9)
+    env.assertEqual(row['distinct'], str(len(set(values))))
+    env.assertEqual(row['distinct_tags'], '4')
+    env.assertEqual(row['top'], 'tag0')
+    env.assertEqual(row['bottom'], '1.5')
+
+
+@skip(no_json=True)
+def testCountDistinctArrayValues(env: Env):
+    env.expect('FT.CREATE', 'idx', 'ON', 'JSON', 'SCHEMA',
+               '$.g', 'AS', 'g', 'TAG', '$.tags[*]', 'AS', 'tags', 'TAG').ok()
+    docs = [['a', 'b'], ['b', 'a'], ['a'], ['c', 'd', 'e'], ['a', 'b'], ['e'], [], ['d', 'c']]
+    with env.getClusterConnectionIfNeeded() as con:
+        for i, tags in enumerate(docs):
+            con.execute_command('JSON.SET', f'doc{i}', '$', json.dumps({'g': 'x', 'tags': tags}))
+
+    def count_distinct(*extra):
+        res = env.cmd('FT.AGGREGATE', 'idx', '*', 'GROUPBY', '1', '@g',
+                      'REDUCE', 'COUNT_DISTINCT', '1', '@tags', 'AS', 'distinct', *extra)
+        return to_dict(res[1])['distinct']
+
+    # RANDOM_SAMPLE is not distributed, so it keeps the whole group on the coordinator
+    local = count_distinct('REDUCE', 'RANDOM_SAMPLE', '2', '@tags', '1', 'AS', 'sample')
+    env.assertEqual(count_distinct(), local)
+
+
+def testCountDistinctFallback(env: Env):
+    env.expect('FT.CREATE', 'idx', 'SCHEMA', 'g', 'TAG', 'n', 'NUMERIC').ok()
+    # Enough distinct values for every shard to fall back to an HLL
+    n = 10500 * env.shardsCount
+    conn = getConnectionByEnv(env)
+    pl = conn.pipeline()
+    for i in range(n):
+        pl.execute_command('HSET', f'doc{i}', 'g', 'x', 'n', i)
+        if i % 10000 == 0:
+            pl.execute()
+    pl.execute()
+
+    res = env.cmd('FT.AGGREGATE', 'idx', '*', 'GROUPBY', '1', '@g',
+                  'REDUCE', 'COUNT_DISTINCT', '1', '@n', 'AS', 'distinct')
+    distinct = int(to_dict(res[1])['distinct'])
+    if env.isCluster():
+        env.assertAlmostEqual(distinct, n, delta=n * 0.2)
+    else:
+        env.assertEqual(distinct, n)
+
+
+def testQuantileDigest(env: Env):
+    env.expect('FT.CREATE', 'idx', 'SCHEMA', 'g', 'TAG', 'n', 'NUMERIC').ok()
+    # More values than a shard sends without compressing them
+    n = 10000
+    conn = getConnectionByEnv(env)
+    pl = conn.pipeline()
+    for i in range(n):
+        pl.execute_command('HSET', f'doc{i}', 'g', 'x', 'n', i)
+    pl.execute()
+
+    res = env.cmd('FT.AGGREGATE', 'idx', '*', 'GROUPBY', '1', '@g',
+                  'REDUCE', 'QUANTILE', '2', '@n', '0.5', 'AS', 'q50',
+                  'REDUCE', 'QUANTILE', '2', '@n', '0.99', 'AS', 'q99',
+                  'REDUCE', 'QUANTILE', '2', '@n', '1', 'AS', 'q100')
+    row = to_dict(res[1])
+    env.assertAlmostEqual(float(row['q50']), n * 0.5, delta=n * 0.02)
+    env.assertAlmostEqual(float(row['q99']), n * 0.99, delta=n * 0.02)
+    env.assertEqual(float(row['q100']), n - 1)
+
+
+def testInternalReducers(env: Env):
+    env.expect('FT.CREATE', 'idx', 'SCHEMA', 'n', 'NUMERIC').ok()
+    with env.getClusterConnectionIfNeeded() as con:
+        con.execute_command('HSET', 'doc1', 'n', 1)
+    for reducer in ('STDDEV_PARTIAL', 'STDDEV_MERGE', 'COUNT_DISTINCT_PARTIAL', 'COUNT_DISTINCT_MERGE',
+                    'QUANTILE_PARTIAL', 'QUANTILE_MERGE'):
+        env.expect('FT.AGGREGATE', 'idx', '*', 'GROUPBY', '0', 'REDUCE', reducer, '1', '@n', 'AS', 'r') \
+            .error().contains('No such reducer')
+
+
 def grouper(iterable, n, fillvalue=None):
     "Collect data into fixed-length chunks or blocks"
     # grouper('ABCDEFG', 3, 'x') --> ABC DEF Gxx
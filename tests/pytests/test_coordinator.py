@@ -234,3 +234,118 @@ def test_single_shard_optimization():
 
     # SpellCheck
     env.expect('FT.SPELLCHECK', 'idx', 'hell').equal([['TERM', 'hell', [['1', 'hello']]]])
+
+def _sort_threshold_setup(env, n_docs):
+    # Few distinct values, so the coordinator's sort threshold falls inside a run of ties, and a
+    # field that some documents (`n`) or all of them (`absent`) don't have
+    env.expect('FT.CREATE', 'idx', 'SCHEMA', 't', 'TEXT', 'n', 'NUMERIC', 'SORTABLE',
+               'absent', 'NUMERIC', 'SORTABLE').ok()
+    with env.getClusterConnectionIfNeeded() as conn:
+        for i in range(n_docs):
+            if i % 7 == 0:
+                conn.execute_command('HSET', f'doc:{i}', 't', 'hello')
+            else:
+                conn.execute_command('HSET', f'doc:{i}', 't', 'hello', 'n', i % 10)
+
+def _assert_sorted_prefix(env, limited, full, k, message):
+    # `limited` and `full` are lists of (key, sort value) pairs. Rows tied with the last kept row may
+    # come in any order, and any of them may be the one kept
+    env.assertEqual([v for _, v in limited], [v for _, v in full[:k]], message=message)
+    last = limited[-1][1] if limited else None
+    env.assertEqual({key for key, v in limited if v != last},
+                    {key for key, v in full[:k] if v != last}, message=message)
+
+def _sorted_search(env, field, order, k):
+    res = env.cmd('FT.SEARCH', 'idx', 'hello', 'SORTBY', field, order, 'WITHSORTKEYS', 'NOCONTENT',
+                  'LIMIT', 0, k)
+    if isinstance(res, dict):
+        return res['total_results'], [(r['id'], r.get('sortkey')) for r in res['results']]
+    return res[0], list(zip(res[1::2], res[2::2]))
+
+def _sorted_aggregate(env, query, steps, field, order, k):
+    res = env.cmd('FT.AGGREGATE', 'idx', query, 'LOAD', 1, '@__key', *steps,
+                  'SORTBY', 2, f'@{field}', order, 'LIMIT', 0, k)
+    if isinstance(res, dict):
+        rows = [r['extra_attributes'] for r in res['results']]
+    else:
+        rows = [to_dict(r) for r in res[1:]]
+    return [(row['__key'], row.get(field)) for row in rows]
+
+def _test_sort_threshold(protocol):
+    # The coordinator stops reading a shard's sorted reply once it falls below its top-k. Results
+    # must match those of the same query with a limit large enough for the threshold never to apply
+    env = Env(protocol=protocol)
+    n_docs = 300
+    _sort_threshold_setup(env, n_docs)
+    for order in ('ASC', 'DESC'):
+        for field in ('n', 'absent'):
+            full_total, full = _sorted_search(env, field, order, 2 * n_docs)
+            env.assertEqual(full_total, n_docs)
+            for k in (1, 5, 25, 100):
+                message = f'FT.SEARCH SORTBY {field} {order} LIMIT 0 {k}, RESP{protocol}'
+                total, limited = _sorted_search(env, field, order, k)
+                env.assertEqual(total, n_docs, message=message)
+                env.assertEqual(len(limited), k, message=message)
+                _assert_sorted_prefix(env, limited, full, k, message)
+
+        # Numbers on some rows and strings on others, in every shard
+        mixed = ['APPLY', 'if(@n % 3 == 0, format("s%s", @n), @n)', 'AS', 'm']
+        for query, steps, field in (('*', [], 'n'), ('@n:[-inf +inf]', mixed, 'm')):
+            full = _sorted_aggregate(env, query, steps, field, order, 2 * n_docs)
+            for k in (1, 5, 25, 100):
+                message = f'FT.AGGREGATE {query} SORTBY @{field} {order} LIMIT 0 {k}, RESP{protocol}'
+                limited = _sorted_aggregate(env, query, steps, field, order, k)
+                env.assertEqual(len(limited), k, message=message)
+                _assert_sorted_prefix(env, limited, full, k, message)
+
+@skip(cluster=False)
+def test_sort_threshold_resp2():
+    _test_sort_threshold(2)
+
+@skip(cluster=False)
+def test_sort_threshold_resp3():
+    _test_sort_threshold(3)
+
+def _format_number(d):
+    # As a single shard formats numbers: integers in full, other numbers with 12 significant digits
+    if math.isfinite(d) and d == int(d) and abs(d) < 2**63:
+        return str(int(d))
+    return '%.12g' % d
+
+def _test_number_values(protocol):
+    # Shards send integral numbers to the coordinator as integers, and other numbers as doubles (or
+    # strings, in RESP2). The coordinator must reply with the numbers a single shard replies with,
+    # and compute on the same values
+    env = Env(protocol=protocol)
+    values = {'a': '3.0', 'b': '-0', 'c': '0', 'd': '9007199254740992', 'e': '-123456789012345678',
+              'f': '1e20', 'g': '2.5', 'h': '-0.1'}
+    env.expect('FT.CREATE', 'idx', 'SCHEMA', 'k', 'TAG', 'n', 'NUMERIC').ok()
+    with env.getClusterConnectionIfNeeded() as conn:
+        for k, n in values.items():
+            conn.execute_command('HSET', f'doc:{k}', 'k', k, 'n', n)
+
+    def rows(*steps):
+        res = env.cmd('FT.AGGREGATE', 'idx', '*', 'LOAD', 2, '@k', '@n', 'APPLY', '@n * 1', 'AS', 'x',
+                      *steps, 'SORTBY', 2, '@k', 'ASC')
+        if isinstance(res, dict):
+            return [r['extra_attributes'] for r in res['results']]
+        return [to_dict(r) for r in res[1:]]
+
+    # Numbers computed by the shards
+    expected = [{'k': k, 'n': n, 'x': _format_number(float(n))} for k, n in sorted(values.items())]
+    env.assertEqual(rows(), expected, message=f'RESP{protocol}')
+
+    # Numbers reduced by the shards, and computed on by the coordinator. 1 / -0 is -inf
+    expected = []
+    for k, n in sorted(values.items()):
+        m = float(n)
+        inv = 1 / m if m else math.copysign(math.inf, m)
+        expected.append({'k': k, 'm': _format_number(m), 'inv': _format_number(inv)})
+    env.assertEqual(rows('GROUPBY', 1, '@k', 'REDUCE', 'MIN', 1, '@x', 'AS', 'm',
+                         'APPLY', '1 / @m', 'AS', 'inv'), expected, message=f'RESP{protocol}')
+
+def test_number_values_resp2():
+    _test_number_values(2)
+
+def test_number_values_resp3():
+    _test_number_values(3)
@@ -761,3 +761,46 @@ def testFilterWithNot(env):
     conn.execute_command('JSON.SET', 'thing:bar', '$', r'{"name":"foo", "indexName":"idx1"}')
 
     env.expect('ft.search', 'things', 'foo').equal([0])
+
+@skip(cluster=True)
+def testLoadSkipsKeysOutsidePrefixes(env):
+    conn = getConnectionByEnv(env)
+    env.expect('FT.CREATE', 'things', 'ON', 'HASH', 'PREFIX', '1', 'thing:', 'SCHEMA', 'name', 'TEXT').ok()
+    env.expect('FT.CREATE', 'all', 'ON', 'HASH', 'PREFIX', '2', 'thing:', 'other:', 'SCHEMA', 'name', 'TEXT').ok()
+    for i in range(10):
+        conn.execute_command('HSET', f'thing:{i}', 'name', 'foo')
+        conn.execute_command('HSET', f'other:{i}', 'name', 'foo')
+        conn.execute_command('HSET', f'unindexed:{i}', 'name', 'foo')
+        conn.execute_command('SET', f'string:{i}', 'foo')
+
+    env.expect('DEBUG', 'RELOAD').ok()
+    waitForIndex(env, 'things')
+    waitForIndex(env, 'all')
+    env.assertEqual(int(index_info(env, 'things')['num_docs']), 10)
+    env.assertEqual(int(index_info(env, 'all')['num_docs']), 20)
+    env.assertEqual(conn.execute_command('DBSIZE'), 40)
+
+@skip(cluster=True)
+def testLoadSkipsUncoveredKeys(env):
+    conn = getConnectionByEnv(env)
+    env.expect('FT.CREATE', 'things', 'ON', 'HASH', 'PREFIX', '1', 'thing:', 'SCHEMA', 'n', 'NUMERIC').ok()
+    conn.execute_command('HSET', 'thing:1', 'n', '1')
+    for i in range(100):
+        # would fail indexing if any index covered them
+        conn.execute_command('HSET', f'uncovered:{i}', 'n', 'not a number')
+
+    env.expect('DEBUG', 'RELOAD').ok()
+    waitForIndex(env, 'things')
+    info = index_info(env, 'things')
+    env.assertEqual(int(info['num_docs']), 1)
+    env.assertEqual(int(info['hash_indexing_failures']), 0)
+    env.assertEqual(conn.execute_command('DBSIZE'), 101)
+
+    # An index without prefixes covers every key, so none of them is skipped
+    env.expect('FT.CREATE', 'everything', 'ON', 'HASH', 'SCHEMA', 'n', 'NUMERIC').ok()
+    waitForIndex(env, 'everything')
+    env.expect('DEBUG', 'RELOAD').ok()
+    waitForIndex(env, 'everything')
+    info = index_info(env, 'everything')
+    env.assertEqual(int(info['num_docs']), 1)
+    env.assertEqual(int(info['hash_indexing_failures']), 100)
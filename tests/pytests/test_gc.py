@@ -445,3 +445,55 @@ def test_gc_oom(env:Env):
     gc_dict = to_dict(info["gc_stats"])
     bytes_collected = int(gc_dict['bytes_collected'])
     env.assertGreater(bytes_collected, 0)
+
+@skip(cluster=True)
+def testThreadGC():
+    env = Env(moduleArgs='GC_POLICY THREAD FORK_GC_CLEAN_THRESHOLD 0')
+    env.expect(config_cmd(), 'GET', 'GC_POLICY').equal([['GC_POLICY', 'thread']])
+    env.expect('FT.CREATE', 'idx', 'ON', 'HASH',
+               'SCHEMA', 'title', 'TEXT', 'id', 'NUMERIC', 't', 'TAG').ok()
+    num_docs = 1000
+    for i in range(num_docs):
+        env.expect('HSET', f'doc{i}', 'title', f'hello world{i % 2}', 'id', 5, 't', f'tag{i % 2}').equal(3)
+
+    # Delete the documents with odd ids (even names), emptying the 'world0' term and the 'tag0' value
+    for i in range(0, num_docs, 2):
+        env.expect('DEL', f'doc{i}').equal(1)
+
+    forceInvokeGC(env)
+
+    expected = list(range(2, num_docs + 1, 2))
+    env.assertEqual(env.cmd(debug_cmd(), 'DUMP_INVIDX', 'idx', 'hello'), expected)
+    env.assertEqual(env.cmd(debug_cmd(), 'DUMP_NUMIDX', 'idx', 'id'), [expected])
+    env.assertEqual(env.cmd(debug_cmd(), 'DUMP_TAGIDX', 'idx', 't'), [['tag1', expected]])
+    env.expect(debug_cmd(), 'DUMP_INVIDX', 'idx', 'world0').error().contains('Can not find the inverted index')
+
+    gc_dict = to_dict(index_info(env)['gc_stats'])
+    env.assertGreater(int(gc_dict['bytes_collected']), 0)
+    env.assertGreater(float(gc_dict['total_cycles']), 0)
+    env.assertEqual(env.cmd('FT.SEARCH', 'idx', '@t:{tag1} hello', 'LIMIT', 0, 0), [num_docs // 2])
+
+@skip(cluster=True)
+def testThreadGCResumesFieldsAcrossSteps():
+    # A step visits a single inverted index, so the tag values and missing-field indexes take many steps
+    env = Env(moduleArgs='GC_POLICY THREAD FORK_GC_CLEAN_THRESHOLD 0 GCSCANSIZE 1')
+    env.expect('FT.CREATE', 'idx', 'ON', 'HASH', 'SCHEMA',
+               't', 'TAG', 'INDEXMISSING', 'a', 'TEXT', 'INDEXMISSING', 'b', 'NUMERIC', 'INDEXMISSING').ok()
+    num_docs = 200
+    for i in range(num_docs):
+        env.expect('HSET', f'doc{i}', 't', f'tag{i}', 'x', 'y').equal(2)
+
+    # Empty every other tag value, and the missing-field indexes of the even documents
+    for i in range(0, num_docs, 2):
+        env.expect('DEL', f'doc{i}').equal(1)
+
+    forceInvokeGC(env)
+
+    expected = [[f'tag{i}', [i + 1]] for i in range(1, num_docs, 2)]
+    env.assertEqual(sorted(env.cmd(debug_cmd(), 'DUMP_TAGIDX', 'idx', 't')), sorted(expected))
+    for field in ['a', 'b']:
+        env.assertEqual(env.cmd('FT.SEARCH', 'idx', f'ismissing(@{field})', 'LIMIT', 0, 0), [num_docs // 2])
+    env.assertEqual(env.cmd('FT.SEARCH', 'idx', '@t:{tag0|tag1|tag2|tag3}', 'NOCONTENT'), [2, 'doc1', 'doc3'])
+
+    gc_dict = to_dict(index_info(env)['gc_stats'])
+    env.assertGreater(int(gc_dict['bytes_collected']), 0)
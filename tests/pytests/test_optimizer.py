@@ -664,6 +664,28 @@ def testVector():
             # (same iterators and pipeline should be used)
             env.assertEqual(conn.execute_command(*profile, *query), conn.execute_command(*profile, *query, 'WITHOUTCOUNT'), message=str(idx))
 
+@skip(cluster=True)
+def testBlockMaxPruning(env):
+    ''' Test that queries sorted by BM25STD score return the same top results when skipping the
+        blocks that cannot score into them '''
+    conn = getConnectionByEnv(env)
+    env.cmd('FT.CREATE', 'idx', 'SCHEMA', 't', 'TEXT')
+    # the documents vary in length and in frequency of their terms, and span many index blocks
+    for i in range(3000):
+        words = ['hello'] * (1 + i % 7) + ['world'] * (1 + (i // 10) % 5) + ['filler'] * (i % 13)
+        if i % 3 == 0:
+            words.append('foo')
+        conn.execute_command('HSET', i, 't', ' '.join(words), '__score', 1 if i % 11 else 0.5)
+
+    queries = ['hello', 'hello world', 'hello | world', 'foo (hello | world)', 'hel*', 'missing | hello']
+    for _ in env.reloadingIterator():
+        for query in queries:
+            for limit in [[0, 1], [0, 10], [5, 20], [0, 200]]:
+                cmd = ['FT.SEARCH', 'idx', query, 'WITHSCORES', 'NOCONTENT', 'LIMIT', *limit]
+                res = conn.execute_command(*cmd, 'WITHCOUNT')
+                opt_res = conn.execute_command(*cmd, 'WITHOUTCOUNT')
+                env.assertEqual(res[1:], opt_res[1:], message=f'{query} {limit}')
+
 def testOptimizeArgs(env):
     ''' Test enabling/disabling optimization according to args and dialect '''
 
@@ -0,0 +1,90 @@
+from common import *
+
+
+def getQueryCacheStats(env, idx='idx'):
+    return to_dict(index_info(env, idx)['query_cache_stats'])
+
+@skip(cluster=True)
+def testQueryCache(env):
+    env.expect(config_cmd(), 'SET', 'QUERY_CACHE_MAX_MEMORY', 1 << 20).ok()
+    env.expect('FT.CREATE', 'idx', 'SCHEMA', 't', 'TEXT', 'n', 'NUMERIC', 'SORTABLE').ok()
+    for i in range(10):
+        env.cmd('HSET', f'doc{i}', 't', 'hello', 'n', i, 'other', i)
+
+    query = ['FT.SEARCH', 'idx', 'hello', 'SORTBY', 'n', 'RETURN', 1, 'n', 'LIMIT', 0, 3]
+    res = env.cmd(*query)
+    env.assertEqual(res, [10, 'doc0', ['n', '0'], 'doc1', ['n', '1'], 'doc2', ['n', '2']])
+    env.assertEqual(env.cmd(*query), res)
+    stats = getQueryCacheStats(env)
+    env.assertEqual((stats['hits'], stats['misses'], stats['entries']), (1, 1, 1))
+
+    # Queries replied from the cache are counted like any other, and as cache hits
+    info = env.cmd('INFO', 'MODULES')
+    env.assertEqual(info['search_total_queries_processed'], 2)
+    env.assertEqual(info['search_total_query_commands'], 2)
+    env.assertEqual(info['search_total_query_cache_hits'], 1)
+
+    # Writing to the index invalidates the cached reply
+    env.cmd('HSET', 'doc10', 't', 'hello', 'n', -1)
+    env.assertEqual(env.cmd(*query), [11, 'doc10', ['n', '-1'], 'doc0', ['n', '0'], 'doc1', ['n', '1']])
+    env.cmd('DEL', 'doc10')
+    env.assertEqual(env.cmd(*query), res)
+    stats = getQueryCacheStats(env)
+    env.assertEqual((stats['hits'], stats['misses']), (1, 3))
+
+    # Replies loading fields outside of the schema are not cached, as writing to them may not
+    # change the index
+    query = ['FT.AGGREGATE', 'idx', 'hello', 'LOAD', 1, '@other', 'SORTBY', 2, '@n', 'ASC', 'LIMIT', 0, 1]
+    env.assertEqual(to_dict(env.cmd(*query)[1])['other'], '0')
+    env.cmd('HSET', 'doc0', 'other', 'changed')
+    env.assertEqual(to_dict(env.cmd(*query)[1])['other'], 'changed')
+    env.assertEqual(getQueryCacheStats(env)['entries'], 1)
+
+    # Altering the index drops its cached replies
+    env.expect('FT.ALTER', 'idx', 'SCHEMA', 'ADD', 't2', 'TEXT').ok()
+    env.assertEqual(getQueryCacheStats(env)['entries'], 0)
+    env.expect(config_cmd(), 'SET', 'QUERY_CACHE_MAX_MEMORY', 0).ok()
+
+@skip(cluster=True)
+def testQueryCacheConfigChange(env):
+    env.expect(config_cmd(), 'SET', 'QUERY_CACHE_MAX_MEMORY', 1 << 20).ok()
+    env.expect('FT.CREATE', 'idx', 'SCHEMA', 't', 'TEXT').ok()
+    for i in range(5):
+        env.cmd('HSET', f'doc{i}', 't', f'hello{i}')
+
+    query = ['FT.SEARCH', 'idx', 'hello*', 'NOCONTENT']
+    env.assertEqual(env.cmd(*query)[0], 5)
+    env.assertEqual(env.cmd(*query)[0], 5)
+    env.assertEqual(getQueryCacheStats(env)['hits'], 1)
+
+    # The reply depends on the configuration, so a reply cached before a change is not served
+    env.expect(config_cmd(), 'SET', 'MAXEXPANSIONS', 2).ok()
+    env.assertEqual(env.cmd(*query)[0], 2)
+    env.expect('CONFIG', 'SET', 'search-max-prefix-expansions', 3).ok()
+    env.assertEqual(env.cmd(*query)[0], 3)
+    env.assertEqual(env.cmd(*query)[0], 3)
+    env.assertEqual(getQueryCacheStats(env)['hits'], 2)
+
+    env.expect('CONFIG', 'SET', 'search-max-prefix-expansions', 200).ok()
+    env.expect(config_cmd(), 'SET', 'QUERY_CACHE_MAX_MEMORY', 0).ok()
+
+@skip(cluster=True)
+def testQueryCacheKeptByGC(env):
+    env.expect(config_cmd(), 'SET', 'QUERY_CACHE_MAX_MEMORY', 1 << 20).ok()
+    env.expect(config_cmd(), 'SET', 'FORK_GC_CLEAN_THRESHOLD', 0).ok()
+    env.expect('FT.CREATE', 'idx', 'SCHEMA', 't', 'TEXT', 'n', 'NUMERIC').ok()
+    for i in range(20):
+        env.cmd('HSET', f'doc{i}', 't', 'hello', 'n', i)
+    for i in range(10):
+        env.cmd('DEL', f'doc{i}')
+
+    query = ['FT.SEARCH', 'idx', '@n:[0 100]', 'NOCONTENT', 'LIMIT', 0, 0]
+    env.assertEqual(env.cmd(*query), [10])
+
+    # The GC only removes the entries of deleted documents, which queries skip anyway, so it leaves
+    # the cached replies in place
+    forceInvokeGC(env)
+    env.assertEqual(env.cmd(*query), [10])
+    stats = getQueryCacheStats(env)
+    env.assertEqual((stats['hits'], stats['entries']), (1, 1))
+    env.expect(config_cmd(), 'SET', 'QUERY_CACHE_MAX_MEMORY', 0).ok()